@@ -0,0 +1,111 @@
+/***********************************************************************
+ * Header:
+ *    BENCH CONCURRENT
+ * Summary:
+ *    Benchmarks for the concurrent hash set
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "concurrent.h"
+#include "lockfree.h"
+#include "hash.h"
+#include "benchmark.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <random>
+#include <string>
+
+class BenchConcurrent : public Benchmark
+{
+public:
+   BenchConcurrent(size_t num = 1000000, size_t numOpsPerThread = 1000000) :
+      num(num), numOpsPerThread(numOpsPerThread) {}
+
+   void run()
+   {
+      // thread counts 1, 2, 4, ... up to every core there is
+      size_t numCores = std::thread::hardware_concurrency();
+      if (numCores == 0)
+         numCores = 1;
+      std::vector<size_t> threadCounts;
+      for (size_t n = 1; n < numCores; n *= 2)
+         threadCounts.push_back(n);
+      threadCounts.push_back(numCores);
+
+      header("Concurrent: 90% contains, 10% insert, by thread count");
+      for (size_t numThreads : threadCounts)
+      {
+         bench_mixed<GlobalLock>("global mutex", numThreads);
+         bench_mixed<custom::concurrent_unordered_set<size_t, 64>>("concurrent_unordered_set<64>", numThreads);
+         bench_mixed<custom::lock_free_unordered_set<size_t>>     ("lock_free_unordered_set", numThreads);
+      }
+   }
+
+private:
+   // what everyone does today: one mutex around one set
+   class GlobalLock
+   {
+   public:
+      bool insert(size_t key)
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         return set.insert(key).second;
+      }
+      bool contains(size_t key)
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         return set.contains(key);
+      }
+   private:
+      std::mutex lock;
+      custom::unordered_set<size_t> set;
+   };
+
+   /*************************************************************
+    * MIXED
+    * Fill a set, then have numThreads threads each run a mix of
+    * lookups and inserts against it at the same time
+    *************************************************************/
+   template <class Set>
+   void bench_mixed(const std::string & name, size_t numThreads)
+   {
+      Set s;
+      std::mt19937_64 random(235);
+      for (size_t i = 0; i < num; i++)
+         s.insert(random());
+
+      std::vector<size_t> found(numThreads);
+      double seconds = time([&]()
+      {
+         std::vector<std::thread> threads;
+         for (size_t t = 0; t < numThreads; t++)
+            threads.push_back(std::thread([&s, &found, t, this]()
+            {
+               std::mt19937_64 random(t + 1);
+               size_t numFound = 0;
+               for (size_t i = 0; i < numOpsPerThread; i++)
+               {
+                  size_t key = random();
+                  if (key % 10 == 0)
+                     s.insert(key);
+                  else
+                     numFound += s.contains(key) ? 1 : 0;
+               }
+               found[t] = numFound;
+            }));
+         for (size_t t = 0; t < threads.size(); t++)
+            threads[t].join();
+      });
+      report(name + " x" + std::to_string(numThreads), numThreads * numOpsPerThread, seconds);
+      for (size_t t = 0; t < numThreads; t++)
+         keep(found[t]);
+   }
+
+   size_t num;
+   size_t numOpsPerThread;
+};
@@ -0,0 +1,395 @@
+/***********************************************************************
+ * Header:
+ *    BENCH HASH
+ * Summary:
+ *    Benchmarks for the hash sets
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "hash.h"
+#include "swiss.h"
+#include "vector.h"
+#include "hashers.h"
+#include "frozen.h"
+#include "small.h"
+#include "benchmark.h"
+
+#include <unordered_set>
+#include <vector>
+#include <random>
+#include <string>
+#include <functional>
+
+class BenchHash : public Benchmark
+{
+public:
+   BenchHash(size_t num = 1000000, size_t numBuild = 10000000) :
+      num(num), numBuild(numBuild) {}
+
+   void run()
+   {
+      // keys to insert, and the same number of keys that are not there
+      std::mt19937_64 random(235);
+      std::vector<size_t> keysHit;
+      std::vector<size_t> keysMiss;
+      for (size_t i = 0; i < num; i++)
+      {
+         keysHit.push_back(random() << 1);        // even
+         keysMiss.push_back((random() << 1) | 1); // odd
+      }
+
+      header("Hash: find");
+      bench_find<custom::unordered_set<size_t>>           ("custom::unordered_set",            keysHit, keysMiss);
+      bench_find<custom::flat_unordered_set<size_t>>      ("custom::flat_unordered_set",       keysHit, keysMiss);
+      bench_find<custom::robin_hood_unordered_set<size_t>>("custom::robin_hood_unordered_set", keysHit, keysMiss);
+      bench_find<custom::swiss_unordered_set<size_t>>     ("custom::swiss_unordered_set",      keysHit, keysMiss);
+      bench_find<std::unordered_set<size_t>>              ("std::unordered_set",               keysHit, keysMiss);
+      bench_find<custom::unordered_set<size_t, custom::fast_hash>>("custom::unordered_set, fast_hash", keysHit, keysMiss);
+      bench_find<custom::unordered_set<size_t, custom::seeded_hash>>("custom::unordered_set, seeded_hash", keysHit, keysMiss);
+
+      header("Hash: find in a frozen set");
+      bench_findFrozen(keysHit, keysMiss);
+
+      header("Hash: a million sets of four");
+      bench_tinySets<custom::unordered_set<size_t>>("custom::unordered_set");
+      bench_tinySets<custom::small_unordered_set<size_t>>("custom::small_unordered_set");
+
+      header("Hash: hashing throughput by key length");
+      for (size_t length : { 8, 32, 256, 4096, 65536 })
+         bench_hashBytes(length);
+
+      header("Hash: string keys by hasher");
+      bench_findStrings<std::hash<std::string>>("std::hash<std::string>");
+      bench_findStrings<custom::fast_hash>     ("custom::fast_hash");
+      bench_findStrings<custom::seeded_hash>   ("custom::seeded_hash");
+
+      header("Hash: find one at a time vs. find_batch");
+      bench_findBatch(keysHit, keysMiss);
+
+      header("Hash: build from a custom::vector");
+      bench_build();
+
+      header("Hash: insert latency, rehash at once vs. incrementally");
+      bench_insertLatency("rehash at once", 0);
+      bench_insertLatency("rehash 1 bucket per operation", 1);
+      bench_insertLatency("rehash 8 buckets per operation", 8);
+   }
+
+private:
+   /*************************************************************
+    * FIND
+    * Fill a set, then look up every key that is there and every
+    * key that is not
+    *************************************************************/
+   template <class Set>
+   void bench_find(const std::string & name,
+                   const std::vector<size_t> & keysHit,
+                   const std::vector<size_t> & keysMiss)
+   {
+      Set s;
+      for (size_t key : keysHit)
+         s.insert(key);
+
+      size_t found = 0;
+      double seconds = time([&]()
+      {
+         for (size_t key : keysHit)
+            found += (s.find(key) != s.end()) ? 1 : 0;
+      });
+      report(name + " hit", keysHit.size(), seconds);
+
+      seconds = time([&]()
+      {
+         for (size_t key : keysMiss)
+            found += (s.find(key) != s.end()) ? 1 : 0;
+      });
+      report(name + " miss", keysMiss.size(), seconds);
+      keep(found);
+   }
+
+   /*************************************************************
+    * FIND BATCH
+    * Look up the same keys with find() and with find_batch(),
+    * a block at a time as a caller probing with a run of keys would
+    *************************************************************/
+   void bench_findBatch(const std::vector<size_t> & keysHit,
+                        const std::vector<size_t> & keysMiss)
+   {
+      const size_t BLOCK = 256;
+      custom::unordered_set<size_t> s;
+      s.reserve(keysHit.size());
+      for (size_t key : keysHit)
+         s.insert(key);
+
+      // mix hits and misses so neither branch is predictable
+      std::vector<size_t> keys;
+      for (size_t i = 0; i < keysHit.size(); i++)
+         keys.push_back((i & 1) ? keysMiss[i] : keysHit[i]);
+
+      size_t found = 0;
+      double seconds = time([&]()
+      {
+         for (size_t key : keys)
+            found += s.contains(key) ? 1 : 0;
+      });
+      report("contains", keys.size(), seconds);
+
+      bool out[BLOCK];
+      seconds = time([&]()
+      {
+         for (size_t i = 0; i < keys.size(); i += BLOCK)
+         {
+            size_t n = (keys.size() - i < BLOCK) ? keys.size() - i : BLOCK;
+            s.contains_batch(keys.data() + i, n, out);
+            for (size_t j = 0; j < n; j++)
+               found += out[j] ? 1 : 0;
+         }
+      });
+      report("contains_batch", keys.size(), seconds);
+
+      std::vector<custom::unordered_set<size_t>::iterator> its(BLOCK);
+      seconds = time([&]()
+      {
+         for (size_t i = 0; i < keys.size(); i += BLOCK)
+         {
+            size_t n = (keys.size() - i < BLOCK) ? keys.size() - i : BLOCK;
+            s.find_batch(keys.data() + i, n, its.data());
+            for (size_t j = 0; j < n; j++)
+               found += (its[j] != s.end()) ? 1 : 0;
+         }
+      });
+      report("find_batch", keys.size(), seconds);
+      keep(found);
+   }
+
+   /*************************************************************
+    * FIND FROZEN
+    * Build a frozen set from the keys, then look up every key
+    * that is there and every key that is not
+    *************************************************************/
+   void bench_findFrozen(const std::vector<size_t> & keysHit,
+                         const std::vector<size_t> & keysMiss)
+   {
+      custom::frozen_unordered_set<size_t> s;
+      double seconds = time([&]()
+      {
+         s = custom::frozen_unordered_set<size_t>(keysHit.begin(), keysHit.end());
+      });
+      report("custom::frozen_unordered_set build", keysHit.size(), seconds);
+
+      size_t found = 0;
+      seconds = time([&]()
+      {
+         for (size_t key : keysHit)
+            found += (s.find(key) != s.end()) ? 1 : 0;
+      });
+      report("custom::frozen_unordered_set hit", keysHit.size(), seconds);
+
+      seconds = time([&]()
+      {
+         for (size_t key : keysMiss)
+            found += (s.find(key) != s.end()) ? 1 : 0;
+      });
+      report("custom::frozen_unordered_set miss", keysMiss.size(), seconds);
+      keep(found);
+   }
+
+   /*************************************************************
+    * TINY SETS
+    * Build a million sets of four keys each, as a program keeping
+    * a set per object would, then look one key up in each. The
+    * name carries the bytes each set takes before its first insert
+    *************************************************************/
+   template <class Set>
+   void bench_tinySets(const std::string & name)
+   {
+      const size_t NUM_SETS = 1000000;
+      const size_t NUM_KEYS = 4;
+      std::vector<Set> sets;
+      sets.reserve(NUM_SETS);
+
+      double seconds = time([&]()
+      {
+         for (size_t i = 0; i < NUM_SETS; i++)
+         {
+            sets.emplace_back();
+            for (size_t j = 0; j < NUM_KEYS; j++)
+               sets.back().insert(i * NUM_KEYS + j);
+         }
+      });
+      std::string label = name + " (" + std::to_string(sizeof(Set)) + "B)";
+      report(label + " build", NUM_SETS, seconds);
+
+      size_t found = 0;
+      seconds = time([&]()
+      {
+         for (size_t i = 0; i < NUM_SETS; i++)
+            found += sets[i].count(i * NUM_KEYS + 2) + sets[i].count(i);
+      });
+      report(label + " find", NUM_SETS * 2, seconds);
+
+      seconds = time([&]()
+      {
+         sets.clear();
+      });
+      report(label + " destroy", NUM_SETS, seconds);
+      keep(found);
+   }
+
+   /*************************************************************
+    * HASH BYTES
+    * Hash the same key of the given length over and over, about
+    * 256MB in all, with std::hash and with hash_bytes
+    *************************************************************/
+   void bench_hashBytes(size_t length)
+   {
+      std::mt19937_64 random(235);
+      std::string key;
+      for (size_t i = 0; i < length; i++)
+         key.push_back((char)random());
+      size_t numRepeat = ((size_t)1 << 28) / length;
+
+      size_t sum = 0;
+      double seconds = time([&]()
+      {
+         std::hash<std::string> hash;
+         for (size_t i = 0; i < numRepeat; i++)
+         {
+            key[0] = (char)i;  // so the hash cannot be hoisted out of the loop
+            sum += hash(key);
+         }
+      });
+      reportRate("std::hash<std::string> " + std::to_string(length) + "B",
+                 numRepeat * length, seconds);
+
+      seconds = time([&]()
+      {
+         for (size_t i = 0; i < numRepeat; i++)
+         {
+            key[0] = (char)i;
+            sum += custom::hash_bytes(key.data(), key.size());
+         }
+      });
+      reportRate("custom::hash_bytes " + std::to_string(length) + "B",
+                 numRepeat * length, seconds);
+      keep(sum);
+   }
+
+   /*************************************************************
+    * FIND STRINGS
+    * Fill a set of short string keys built from numbers, the
+    * sort that shows up as IDs, then find each of them again
+    *************************************************************/
+   template <class Hash>
+   void bench_findStrings(const std::string & name)
+   {
+      std::vector<std::string> keys;
+      for (size_t i = 0; i < num; i++)
+         keys.push_back("user:" + std::to_string(i * 10));
+
+      custom::unordered_set<std::string, Hash> s;
+      double seconds = time([&]()
+      {
+         for (size_t i = 0; i < keys.size(); i++)
+            s.insert(keys[i]);
+      });
+      report(name + " insert", keys.size(), seconds);
+
+      size_t found = 0;
+      seconds = time([&]()
+      {
+         for (size_t i = 0; i < keys.size(); i++)
+            found += s.contains(keys[i]) ? 1 : 0;
+      });
+      report(name + " find", keys.size(), seconds);
+      keep(found);
+   }
+
+   /*************************************************************
+    * BUILD
+    * Build a set from a large custom::vector one element at a time,
+    * one element at a time after a reserve, and in bulk
+    *************************************************************/
+   void bench_build()
+   {
+      std::mt19937_64 random(235);
+      custom::vector<size_t> v;
+      v.reserve(numBuild);
+      for (size_t i = 0; i < numBuild; i++)
+         v.push_back(random());
+
+      size_t count = 0;
+      double seconds = time([&]()
+      {
+         custom::unordered_set<size_t> s;
+         for (auto it = v.begin(); it != v.end(); ++it)
+            s.insert(*it);
+         count += s.size();
+      });
+      report("insert one at a time", numBuild, seconds);
+
+      seconds = time([&]()
+      {
+         custom::unordered_set<size_t> s;
+         s.reserve(numBuild);
+         for (auto it = v.begin(); it != v.end(); ++it)
+            s.insert(*it);
+         count += s.size();
+      });
+      report("reserve, insert one at a time", numBuild, seconds);
+
+      seconds = time([&]()
+      {
+         custom::unordered_set<size_t> s(v.begin(), v.end());
+         count += s.size();
+      });
+      report("construct from range", numBuild, seconds);
+
+      seconds = time([&]()
+      {
+         std::unordered_set<size_t> s(v.begin(), v.end());
+         count += s.size();
+      });
+      report("std::unordered_set from range", numBuild, seconds);
+      keep(count);
+   }
+
+   /*************************************************************
+    * INSERT LATENCY
+    * Insert numBuild elements one at a time, timing each insert.
+    * Rehashing at once makes a few inserts very slow; an
+    * incremental rehash spreads that work over the ones after
+    *************************************************************/
+   void bench_insertLatency(const std::string & name, size_t budget)
+   {
+      std::mt19937_64 random(235);
+      custom::unordered_set<size_t> s;
+      s.rehash_budget(budget);
+
+      // the nodes the last run freed are tidied up by the allocator on
+      // the first large request; do that now so no insert is billed for it
+      char * volatile pTidy = new char[1 << 16];
+      delete [] pTidy;
+
+      double worst = 0.0;
+      double seconds = time([&]()
+      {
+         for (size_t i = 0; i < numBuild; i++)
+         {
+            size_t key = random();
+            double one = time([&]() { s.insert(key); });
+            if (one > worst)
+               worst = one;
+         }
+      });
+      report(name, numBuild, seconds);
+      reportWorst(name, worst);
+      keep(s.size());
+   }
+
+   size_t num;
+   size_t numBuild;
+};
@@ -0,0 +1,280 @@
+/***********************************************************************
+ * Header:
+ *    BENCH LIST
+ * Summary:
+ *    Benchmarks for the linked lists
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "list.h"
+#include "pool.h"
+#include "unrolled.h"
+#include "intrusive.h"
+#include "vector.h"
+#include "benchmark.h"
+
+#include <list>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+
+class BenchList : public Benchmark
+{
+public:
+   BenchList(size_t num = 10000000) : num(num) {}
+
+   void run()
+   {
+      header("List: push and pop churn, 1000 elements held");
+      bench_churn<std::list<size_t>>        ("std::list");
+      bench_churn<custom::list<size_t>>     ("custom::list");
+      bench_churn<custom::pool_list<size_t>>("custom::pool_list");
+      bench_churnIntrusive();
+
+      header("List: fill with a million, then clear");
+      bench_fillClear<std::list<size_t>>        ("std::list");
+      bench_fillClear<custom::list<size_t>>     ("custom::list");
+      bench_fillClear<custom::pool_list<size_t>>("custom::pool_list");
+
+      header("List: sum a million elements, walking with an iterator");
+      bench_scan<std::vector<size_t>>          ("std::vector");
+      bench_scan<custom::list<size_t>>         ("custom::list");
+      bench_scan<custom::unrolled_list<size_t>>("custom::unrolled_list");
+
+      header("List: insert 50,000 in the middle of 50,000");
+      bench_insertMiddle<std::vector<size_t>>          ("std::vector");
+      bench_insertMiddle<custom::list<size_t>>         ("custom::list");
+      bench_insertMiddle<custom::unrolled_list<size_t>>("custom::unrolled_list");
+
+      header("List: erase every other one of 100,000");
+      bench_eraseEveryOther<std::vector<size_t>>          ("std::vector");
+      bench_eraseEveryOther<custom::list<size_t>>         ("custom::list");
+      bench_eraseEveryOther<custom::unrolled_list<size_t>>("custom::unrolled_list");
+
+      header("List: sort a million");
+      bench_sort();
+   }
+
+private:
+   /*************************************************************
+    * CHURN
+    * A queue that holds a steady number of elements: every
+    * push_back is matched by a pop_front, so every operation
+    * allocates or frees one node
+    *************************************************************/
+   template <class List>
+   void bench_churn(const std::string & name)
+   {
+      List l;
+      for (size_t i = 0; i < 1000; i++)
+         l.push_back(i);
+
+      size_t sum = 0;
+      double seconds = time([&]()
+      {
+         for (size_t i = 0; i < num; i++)
+         {
+            l.push_back(i);
+            sum += l.front();
+            l.pop_front();
+         }
+      });
+      report(name, num * 2, seconds);
+      keep(sum);
+   }
+
+   /*************************************************************
+    * CHURN INTRUSIVE
+    * The same queue, but the elements are objects that already
+    * exist and carry their own links, so nothing is allocated
+    *************************************************************/
+   void bench_churnIntrusive()
+   {
+      struct Item
+      {
+         size_t value;
+         custom::list_hook hook;
+      };
+      std::vector<Item> items(1001);
+      custom::intrusive_list<Item, &Item::hook> l;
+      for (size_t i = 0; i < 1000; i++)
+      {
+         items[i].value = i;
+         l.push_back(items[i]);
+      }
+
+      size_t sum = 0;
+      size_t iFree = 1000;
+      double seconds = time([&]()
+      {
+         for (size_t i = 0; i < num; i++)
+         {
+            Item& item = items[iFree];
+            item.value = i;
+            l.push_back(item);
+            Item& front = l.front();
+            sum += front.value;
+            l.pop_front();
+            iFree = &front - &items[0];
+         }
+      });
+      report("custom::intrusive_list", num * 2, seconds);
+      keep(sum);
+      l.clear();
+   }
+
+   /*************************************************************
+    * FILL CLEAR
+    * Fill the same list and empty it again, ten times over. A
+    * pool keeps its chunks between rounds
+    *************************************************************/
+   template <class List>
+   void bench_fillClear(const std::string & name)
+   {
+      const size_t NUM_ROUNDS = 10;
+      const size_t NUM_FILL = 1000000;
+      List l;
+
+      size_t count = 0;
+      double seconds = time([&]()
+      {
+         for (size_t round = 0; round < NUM_ROUNDS; round++)
+         {
+            for (size_t i = 0; i < NUM_FILL; i++)
+               l.push_back(i);
+            count += l.size();
+            l.clear();
+         }
+      });
+      report(name, NUM_ROUNDS * NUM_FILL * 2, seconds);
+      keep(count);
+   }
+
+   /*************************************************************
+    * SCAN
+    * Walk the whole container ten times over, adding up the
+    * elements. Every element is touched, in order
+    *************************************************************/
+   template <class List>
+   void bench_scan(const std::string & name)
+   {
+      const size_t NUM_ROUNDS = 10;
+      const size_t NUM_FILL = 1000000;
+      List l;
+      for (size_t i = 0; i < NUM_FILL; i++)
+         l.push_back(i);
+
+      size_t sum = 0;
+      double seconds = time([&]()
+      {
+         for (size_t round = 0; round < NUM_ROUNDS; round++)
+            for (auto it = l.begin(); it != l.end(); ++it)
+               sum += *it;
+      });
+      report(name, NUM_ROUNDS * NUM_FILL, seconds);
+      keep(sum);
+   }
+
+   /*************************************************************
+    * INSERT MIDDLE
+    * Insert again and again at the same spot in the middle. A
+    * vector moves half of everything each time; a list moves
+    * nothing; an unrolled list moves part of one node
+    *************************************************************/
+   template <class List>
+   void bench_insertMiddle(const std::string & name)
+   {
+      const size_t NUM_FILL = 50000;
+      List l;
+      for (size_t i = 0; i < NUM_FILL; i++)
+         l.push_back(i);
+      auto it = l.begin();
+      for (size_t i = 0; i < NUM_FILL / 2; i++)
+         ++it;
+
+      double seconds = time([&]()
+      {
+         for (size_t i = 0; i < NUM_FILL; i++)
+            it = l.insert(it, i);
+      });
+      report(name, NUM_FILL, seconds);
+      keep(l.size());
+   }
+
+   /*************************************************************
+    * ERASE EVERY OTHER
+    * Walk from the front, erasing every other element
+    *************************************************************/
+   template <class List>
+   void bench_eraseEveryOther(const std::string & name)
+   {
+      const size_t NUM_FILL = 100000;
+      List l;
+      for (size_t i = 0; i < NUM_FILL; i++)
+         l.push_back(i);
+
+      double seconds = time([&]()
+      {
+         auto it = l.begin();
+         while (it != l.end())
+         {
+            it = l.erase(it);
+            if (it != l.end())
+               ++it;
+         }
+      });
+      report(name, NUM_FILL / 2, seconds);
+      keep(l.size());
+   }
+
+   /*************************************************************
+    * SORT
+    * Sort a list in place by relinking, against copying it
+    * into a vector, sorting that, and copying back
+    *************************************************************/
+   void bench_sort()
+   {
+      const size_t NUM_FILL = 1000000;
+      std::mt19937_64 random(235);
+      custom::list<size_t> lRelink;
+      std::list<size_t> lStd;
+      for (size_t i = 0; i < NUM_FILL; i++)
+      {
+         lRelink.push_back(random());
+         lStd.push_back(lRelink.back());
+      }
+      custom::list<size_t> lCopy(lRelink);
+
+      double seconds = time([&]()
+      {
+         lRelink.sort();
+      });
+      report("custom::list::sort", NUM_FILL, seconds);
+
+      seconds = time([&]()
+      {
+         lStd.sort();
+      });
+      report("std::list::sort", NUM_FILL, seconds);
+
+      seconds = time([&]()
+      {
+         custom::vector<size_t> v;
+         v.reserve(lCopy.size());
+         for (auto it = lCopy.begin(); it != lCopy.end(); ++it)
+            v.push_back(*it);
+         std::sort(&v[0], &v[0] + v.size());
+         size_t i = 0;
+         for (auto it = lCopy.begin(); it != lCopy.end(); ++it)
+            *it = v[i++];
+      });
+      report("copy to custom::vector, std::sort, back", NUM_FILL, seconds);
+      keep(lRelink.front() + lCopy.front() + lStd.front());
+   }
+
+   size_t num;
+};
@@ -0,0 +1,122 @@
+/***********************************************************************
+ * Header:
+ *    BENCH QUEUE
+ * Summary:
+ *    Benchmarks for handing work from many threads to one
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "queue.h"
+#include "list.h"
+#include "benchmark.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <string>
+
+class BenchQueue : public Benchmark
+{
+public:
+   BenchQueue(size_t num = 4000000) : num(num) {}
+
+   void run()
+   {
+      header("Queue: producers x N pushing to one consumer, per element");
+      for (size_t numProducers = 1; numProducers <= 64; numProducers *= 2)
+      {
+         bench_transfer<LockedList, false>("mutex list, try_pop", numProducers);
+         bench_transfer<LockedList, true> ("mutex list, pop_all", numProducers);
+         bench_transfer<custom::mpsc_queue<size_t>, false>("mpsc_queue, try_pop", numProducers);
+         bench_transfer<custom::mpsc_queue<size_t>, true> ("mpsc_queue, pop_all", numProducers);
+      }
+   }
+
+private:
+   // what everyone does today: one mutex around one list
+   class LockedList
+   {
+   public:
+      bool try_push(size_t value)
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         list.push_back(value);
+         return true;
+      }
+      bool try_pop(size_t & value)
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         if (list.empty())
+            return false;
+         value = list.front();
+         list.pop_front();
+         return true;
+      }
+      // take the whole list under the lock, then walk it outside
+      template <class Visit>
+      size_t pop_all(Visit visit)
+      {
+         custom::list<size_t> taken;
+         {
+            std::lock_guard<std::mutex> guard(lock);
+            taken.swap(list);
+         }
+         for (auto it = taken.begin(); it != taken.end(); ++it)
+            visit(*it);
+         return taken.size();
+      }
+   private:
+      std::mutex lock;
+      custom::list<size_t> list;
+   };
+
+   /*************************************************************
+    * TRANSFER
+    * numProducers threads push num elements between them while
+    * this thread pops until it has every one, one at a time or
+    * everything there is at once
+    *************************************************************/
+   template <class Queue, bool batch>
+   void bench_transfer(const std::string & name, size_t numProducers)
+   {
+      Queue q;
+      size_t numEach = num / numProducers;
+      size_t numTotal = numEach * numProducers;
+      std::atomic<bool> go(false);
+      std::vector<std::thread> threads;
+      for (size_t t = 0; t < numProducers; t++)
+         threads.push_back(std::thread([&q, &go, numEach]()
+         {
+            while (!go)
+               std::this_thread::yield();
+            for (size_t i = 0; i < numEach; i++)
+               q.try_push(i);
+         }));
+
+      size_t sum = 0;
+      double seconds = time([&]()
+      {
+         go = true;
+         size_t numPopped = 0;
+         size_t value;
+         while (numPopped < numTotal)
+            if (batch)
+               numPopped += q.pop_all([&sum](size_t value) { sum += value; });
+            else if (q.try_pop(value))
+            {
+               sum += value;
+               numPopped++;
+            }
+         for (size_t t = 0; t < threads.size(); t++)
+            threads[t].join();
+      });
+      report(name + " x" + std::to_string(numProducers), numTotal, seconds);
+      keep(sum);
+   }
+
+   size_t num;
+};
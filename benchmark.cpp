@@ -0,0 +1,30 @@
+/***********************************************************************
+ * Program:
+ *    Benchmark
+ * Summary:
+ *    Driver to time the containers. This has its own main() so it is
+ *    not part of the LabHash project. Build it with optimizations:
+ *        g++ -O2 -std=c++17 -pthread benchmark.cpp -o benchmark
+ *    Add -mavx2 to time the AVX2 group probe of the swiss table.
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#include "benchHash.h"      // for the hash benchmarks
+#include "benchConcurrent.h" // for the concurrent hash benchmarks
+#include "benchList.h"       // for the list benchmarks
+#include "benchQueue.h"      // for the queue benchmarks
+
+/**********************************************************************
+ * MAIN
+ * Run every benchmark
+ ***********************************************************************/
+int main()
+{
+   BenchHash().run();
+   BenchConcurrent().run();
+   BenchList().run();
+   BenchQueue().run();
+
+   return 0;
+}
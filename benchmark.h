@@ -0,0 +1,93 @@
+/***********************************************************************
+ * Header:
+ *    BENCHMARK
+ * Summary:
+ *    The base class to all the benchmark classes
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include <iostream>  // for std::cout
+#include <iomanip>   // for std::setw
+#include <string>    // for std::string
+#include <chrono>    // for std::chrono::steady_clock
+#include <cstddef>   // for size_t
+
+class Benchmark
+{
+public:
+   Benchmark() : sink(0) {}
+
+protected:
+   /*************************************************************
+    * HEADER
+    * Name the group of measurements that follow
+    *************************************************************/
+   void header(const char * name)
+   {
+      std::cout << "\n" << name << "\n";
+   }
+
+   /*************************************************************
+    * TIME
+    * Run the body once and return the wall-clock seconds it took
+    *************************************************************/
+   template <class Body>
+   double time(Body body)
+   {
+      auto begin = std::chrono::steady_clock::now();
+      body();
+      auto end = std::chrono::steady_clock::now();
+      return std::chrono::duration<double>(end - begin).count();
+   }
+
+   /*************************************************************
+    * REPORT
+    * Display one measurement as nanoseconds and millions of
+    * operations per second
+    *************************************************************/
+   void report(const std::string & name, size_t numOps, double seconds)
+   {
+      std::cout << "\t" << std::left << std::setw(40) << name << std::right
+                << std::fixed << std::setprecision(2)
+                << std::setw(10) << (seconds * 1.0e9 / (double)numOps) << " ns/op"
+                << std::setw(10) << ((double)numOps / seconds / 1.0e6) << " Mops/s\n";
+   }
+
+   /*************************************************************
+    * REPORT RATE
+    * Display one measurement as gigabytes per second
+    *************************************************************/
+   void reportRate(const std::string & name, size_t numBytes, double seconds)
+   {
+      std::cout << "\t" << std::left << std::setw(40) << name << std::right
+                << std::fixed << std::setprecision(2)
+                << std::setw(10) << ((double)numBytes / seconds / 1.0e9) << " GB/s\n";
+   }
+
+   /*************************************************************
+    * REPORT WORST
+    * Display the single slowest operation of a run, in microseconds
+    *************************************************************/
+   void reportWorst(const std::string & name, double seconds)
+   {
+      std::cout << "\t" << std::left << std::setw(40) << name << std::right
+                << std::fixed << std::setprecision(2)
+                << std::setw(10) << (seconds * 1.0e6) << " us worst\n";
+   }
+
+   /*************************************************************
+    * KEEP
+    * Fold a result into a volatile so the optimizer cannot
+    * throw away the work that produced it
+    *************************************************************/
+   void keep(size_t value)
+   {
+      sink = sink + value;
+   }
+
+private:
+   volatile size_t sink;
+};
@@ -0,0 +1,248 @@
+/***********************************************************************
+ * Header:
+ *    CONCURRENT
+ * Summary:
+ *    A hash set that many threads can use at once. The elements are
+ *    split across a fixed number of shards by the high bits of their
+ *    hash, and every shard is an ordinary custom::unordered_set with
+ *    its own reader-writer lock. Threads working on different shards
+ *    never wait on each other, and any number of threads may read the
+ *    same shard at the same time.
+ *
+ *    This will contain the class definition of:
+ *        concurrent_unordered_set : A hash set split into locked shards
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "hash.h"     // for custom::unordered_set, one per shard
+#include <cstdint>    // for uint64_t
+#include <functional> // for std::hash
+#include <mutex>      // for std::unique_lock
+#include <shared_mutex> // for std::shared_timed_mutex and std::shared_lock
+#include <thread>     // for std::thread
+#include <vector>     // for std::vector
+
+class TestConcurrent;       // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * BITS OF
+ * How many bits it takes to number n things when
+ * n is a power of two: log2(n)
+ ************************************************/
+constexpr size_t bitsOf(size_t n)
+{
+   return n <= 1 ? 0 : 1 + bitsOf(n >> 1);
+}
+
+/************************************************
+ * CONCURRENT UNORDERED SET
+ * A set implemented as Shards independently locked hashes.
+ * Shards must be a power of two.
+ ************************************************/
+template <typename T,
+          size_t Shards = 16,
+          typename Hash = std::hash<T>,
+          typename KeyEqual = std::equal_to<T>>
+class concurrent_unordered_set
+{
+   friend class ::TestConcurrent;   // give unit tests access to the privates
+
+   static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0,
+                 "Shards must be a power of two");
+
+public:
+   typedef custom::unordered_set<T, Hash, KeyEqual> shard_type;
+
+   //
+   // Construct
+   //
+   concurrent_unordered_set(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual()) :
+      hashFunction(hash)
+   {
+      for (size_t i = 0; i < Shards; i++)
+         shards[i].set = shard_type(hash, equal);
+   }
+   concurrent_unordered_set(const concurrent_unordered_set&) = delete;
+   concurrent_unordered_set& operator = (const concurrent_unordered_set&) = delete;
+
+   //
+   // Insert
+   //
+   bool insert(const T& t)
+   {
+      Shard& shard = shardOf(t);
+      std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+      return shard.set.insert(t).second;
+   }
+   bool insert(T&& t)
+   {
+      Shard& shard = shardOf(t);
+      std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+      return shard.set.insert(std::move(t)).second;
+   }
+   void reserve(size_t num)
+   {
+      for (size_t i = 0; i < Shards; i++)
+      {
+         std::unique_lock<std::shared_timed_mutex> lock(shards[i].lock);
+         shards[i].set.reserve((num + Shards - 1) / Shards);
+      }
+   }
+
+   //
+   // Access
+   //
+   bool contains(const T& t) const
+   {
+      const Shard& shard = shardOf(t);
+      std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
+      return shard.set.contains(t);
+   }
+   size_t count(const T& t) const
+   {
+      return contains(t) ? 1 : 0;
+   }
+
+   //
+   // Remove
+   //
+   size_t erase(const T& t)
+   {
+      Shard& shard = shardOf(t);
+      std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+      size_t numBefore = shard.set.size();
+      shard.set.erase(t);
+      return numBefore - shard.set.size();
+   }
+   void clear()
+   {
+      for (size_t i = 0; i < Shards; i++)
+      {
+         std::unique_lock<std::shared_timed_mutex> lock(shards[i].lock);
+         shards[i].set.clear();
+      }
+   }
+
+   //
+   // Iterate
+   //
+   template <class Visit>
+   void for_each_shard(Visit visit, size_t numThreads = 1) const;
+
+   //
+   // Status
+   //
+   size_t size() const;
+   bool empty() const
+   {
+      return size() == 0;
+   }
+   static size_t shard_count()
+   {
+      return Shards;
+   }
+   size_t shard(const T& t) const
+   {
+      return shardIndex(hashFunction(t));
+   }
+
+private:
+   // one lock and its set. The padding keeps the lock of the next
+   // shard off the cache line this shard's writers are hammering.
+   // A lookup in unordered_set is not const, but it does not write,
+   // so readers holding the shared lock may call it. That only holds
+   // while the shard rehashes all at once: with a rehash_budget() a
+   // lookup moves buckets, so the shards keep the default of 0
+   struct Shard
+   {
+      mutable std::shared_timed_mutex lock;
+      mutable shard_type set;
+      char padding[64];
+   };
+
+   // Fibonacci hashing: the multiply spreads every bit of the hash
+   // into the high bits, which then pick the shard. The set in the
+   // shard picks a bucket with the low bits of the unmixed hash
+   static size_t shardIndex(size_t hash)
+   {
+      if (Shards == 1)
+         return 0;
+      return (size_t)(((uint64_t)hash * 0x9E3779B97F4A7C15ull) >> (64 - SHARD_BITS));
+   }
+   Shard& shardOf(const T& t)
+   {
+      return shards[shardIndex(hashFunction(t))];
+   }
+   const Shard& shardOf(const T& t) const
+   {
+      return shards[shardIndex(hashFunction(t))];
+   }
+
+   static const size_t SHARD_BITS = bitsOf(Shards);
+
+   Hash  hashFunction;
+   Shard shards[Shards];
+};
+
+/*****************************************
+ * CONCURRENT UNORDERED SET :: SIZE
+ * The total of every shard. Each shard is counted under
+ * its own lock, so with writers running the total is only
+ * a snapshot
+ ****************************************/
+template <typename T, size_t Shards, typename Hash, typename KeyEqual>
+size_t concurrent_unordered_set<T, Shards, Hash, KeyEqual>::size() const
+{
+   size_t num = 0;
+   for (size_t i = 0; i < Shards; i++)
+   {
+      std::shared_lock<std::shared_timed_mutex> lock(shards[i].lock);
+      num += shards[i].set.size();
+   }
+   return num;
+}
+
+/*****************************************
+ * CONCURRENT UNORDERED SET :: FOR EACH SHARD
+ * Call visit(iShard, set) once for every shard while holding
+ * that shard's read lock. With more than one thread, thread t
+ * visits shards t, t + numThreads, ... so the shards are walked
+ * in parallel, and visit is called from all of them at once.
+ * visit must only read the set it is given
+ ****************************************/
+template <typename T, size_t Shards, typename Hash, typename KeyEqual>
+template <class Visit>
+void concurrent_unordered_set<T, Shards, Hash, KeyEqual>::for_each_shard(Visit visit, size_t numThreads) const
+{
+   if (numThreads < 1)
+      numThreads = 1;
+   auto visitFrom = [this, &visit, numThreads](size_t iFirst)
+   {
+      for (size_t i = iFirst; i < Shards; i += numThreads)
+      {
+         std::shared_lock<std::shared_timed_mutex> lock(shards[i].lock);
+         visit(i, shards[i].set);
+      }
+   };
+
+   if (numThreads == 1)
+   {
+      visitFrom(0);
+      return;
+   }
+
+   std::vector<std::thread> threads;
+   for (size_t t = 1; t < numThreads && t < Shards; t++)
+      threads.push_back(std::thread(visitFrom, t));
+   visitFrom(0);
+   for (size_t t = 0; t < threads.size(); t++)
+      threads[t].join();
+}
+
+} // namespace custom
@@ -0,0 +1,455 @@
+/***********************************************************************
+ * Header:
+ *    FROZEN
+ * Summary:
+ *    Sets that are built once and then only searched. Knowing every
+ *    key up front, we can find a minimal perfect hash for them: a
+ *    function that sends each of the n keys to its own slot in an
+ *    array of exactly n. A find is then one slot and one compare,
+ *    with no chains to walk and no empty slots to skip.
+ *
+ *    The hash is built with CHD (compress, hash and displace):
+ *    the keys are split into small groups by their hash, and each
+ *    group gets a displacement, found by trial, that moves all of
+ *    its keys into slots nobody else has taken. The largest groups
+ *    go first, while most slots are still free. Storing the hash
+ *    takes one 32-bit displacement per four keys.
+ *
+ *    This will contain the class definitions of:
+ *        frozen_unordered_set : A read-only set built at run time
+ *        static_frozen_set    : A read-only set of integers built by
+ *                               the compiler
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "hash.h"     // for custom::unordered_set and is_transparent
+#include "hashers.h"  // for mix64
+#include "vector.h"   // for custom::vector
+#include <vector>     // for std::vector, the scratch space of a build
+#include <algorithm>  // for std::sort
+#include <utility>    // for std::pair
+#include <cstdint>    // for uint32_t and uint64_t
+#include <functional> // for std::hash
+#include <memory>     // for std::unique_ptr
+
+class TestFrozen;           // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * FROZEN BUCKETS
+ * How many groups, and so displacements, numKeys
+ * keys are split into: about four keys each
+ ************************************************/
+constexpr size_t frozenBuckets(size_t numKeys)
+{
+   return numKeys / 4 + 1;
+}
+
+/************************************************
+ * FROZEN REDUCE
+ * Map x onto [0, range) with a multiply and a shift,
+ * which is much cheaper than x % range
+ ************************************************/
+constexpr size_t frozenReduce(uint32_t x, size_t range)
+{
+   return (size_t)(((uint64_t)x * (uint64_t)range) >> 32);
+}
+
+/************************************************
+ * FROZEN BUCKET / FROZEN SLOT
+ * The high half of a mixed hash picks the group, and
+ * the low half, moved by d steps of a second stride
+ * drawn from the same hash, picks the slot. The stride
+ * is odd so no key is stuck in one slot for every d
+ ************************************************/
+constexpr size_t frozenBucket(uint64_t hash, size_t numBuckets)
+{
+   return frozenReduce((uint32_t)(hash >> 32), numBuckets);
+}
+constexpr size_t frozenSlot(uint64_t hash, uint32_t d, size_t numSlots)
+{
+   return frozenReduce((uint32_t)((uint32_t)hash +
+                       d * ((uint32_t)((hash * 0x9E3779B97F4A7C15ull) >> 32) | 1u)),
+                       numSlots);
+}
+
+/************************************************
+ * CHD BUILD
+ * Find a displacement for every group so the keys with
+ * these mixed hashes land in distinct slots of numKeys.
+ * On success slots[i] is where key i goes. Everything
+ * else is scratch the caller provides, so that the same
+ * code runs at compile time:
+ *    start         numBuckets + 1 entries
+ *    members       numKeys
+ *    order         numBuckets
+ *    taken         numKeys
+ * Gives up, returning false, when a group has tried
+ * maxTries displacements; the caller then reseeds
+ ************************************************/
+constexpr bool chdBuild(const uint64_t* hashes, size_t numKeys, size_t numBuckets,
+                        uint32_t* displacements, size_t* slots,
+                        size_t* start, size_t* members, size_t* order, bool* taken,
+                        uint32_t maxTries)
+{
+   // 1. group the keys by bucket with a counting sort
+   for (size_t b = 0; b <= numBuckets; b++)
+      start[b] = 0;
+   for (size_t i = 0; i < numKeys; i++)
+      start[frozenBucket(hashes[i], numBuckets) + 1]++;
+   for (size_t b = 0; b < numBuckets; b++)
+      start[b + 1] += start[b];
+   for (size_t b = 0; b < numBuckets; b++)
+      order[b] = start[b];
+   for (size_t i = 0; i < numKeys; i++)
+      members[order[frozenBucket(hashes[i], numBuckets)]++] = i;
+
+   // 2. largest groups first; empty ones need no displacement
+   size_t maxSize = 0;
+   for (size_t b = 0; b < numBuckets; b++)
+   {
+      displacements[b] = 0;
+      if (start[b + 1] - start[b] > maxSize)
+         maxSize = start[b + 1] - start[b];
+   }
+   size_t numOrdered = 0;
+   for (size_t size = maxSize; size > 0; size--)
+      for (size_t b = 0; b < numBuckets; b++)
+         if (start[b + 1] - start[b] == size)
+            order[numOrdered++] = b;
+
+   // 3. try displacements until every key of the group finds a free
+   //    slot, taking slots as we go so two keys of one group cannot
+   //    share, and giving them back if a later key is blocked
+   for (size_t i = 0; i < numKeys; i++)
+      taken[i] = false;
+   for (size_t k = 0; k < numOrdered; k++)
+   {
+      size_t b = order[k];
+      bool placed = false;
+      for (uint32_t d = 0; !placed; d++)
+      {
+         if (d == maxTries)
+            return false;
+         size_t j = start[b];
+         for (; j < start[b + 1]; j++)
+         {
+            size_t slot = frozenSlot(hashes[members[j]], d, numKeys);
+            if (taken[slot])
+               break;
+            taken[slot] = true;
+            slots[members[j]] = slot;
+         }
+         if (j == start[b + 1])
+         {
+            displacements[b] = d;
+            placed = true;
+         }
+         else
+            for (size_t u = start[b]; u < j; u++)
+               taken[slots[members[u]]] = false;
+      }
+   }
+   return true;
+}
+
+/************************************************
+ * FROZEN UNORDERED SET
+ * A set that cannot change once built, where every find
+ * is one slot and one compare
+ ************************************************/
+template <typename T,
+          typename Hash = std::hash<T>,
+          typename KeyEqual = std::equal_to<T>>
+class frozen_unordered_set
+{
+   friend class ::TestFrozen;   // give unit tests access to the privates
+
+public:
+   typedef const T* iterator;
+   typedef const T* const_iterator;
+
+   //
+   // Construct
+   //
+   frozen_unordered_set(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual()) :
+      seed(0), hashFunction(hash), keyEqual(equal)
+   {
+   }
+   template <class Iterator>
+   frozen_unordered_set(Iterator first, Iterator last,
+                        const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual()) :
+      seed(0), hashFunction(hash), keyEqual(equal)
+   {
+      build(first, last);
+   }
+   frozen_unordered_set(const std::initializer_list<T>& il,
+                        const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual()) :
+      seed(0), hashFunction(hash), keyEqual(equal)
+   {
+      build(il.begin(), il.end());
+   }
+   template <class Alloc, class Stats>
+   explicit frozen_unordered_set(unordered_set<T, Hash, KeyEqual, Alloc, Stats>& us) :
+      seed(0), hashFunction(us.hash_function()), keyEqual(us.key_eq())
+   {
+      build(us.begin(), us.end());
+   }
+
+   //
+   // Iterator: the keys in slot order
+   //
+   iterator begin() const
+   {
+      return keys.empty() ? nullptr : &keys[0];
+   }
+   iterator end() const
+   {
+      return begin() + keys.size();
+   }
+
+   //
+   // Access
+   //
+   iterator find(const T& t) const
+   {
+      return findKey(t);
+   }
+   template <class K, class H = Hash, class E = KeyEqual,
+             typename std::enable_if<is_transparent<H>::value && is_transparent<E>::value, int>::type = 0>
+   iterator find(const K& k) const
+   {
+      return findKey(k);
+   }
+   bool contains(const T& t) const
+   {
+      return findKey(t) != end();
+   }
+   size_t count(const T& t) const
+   {
+      return contains(t) ? 1 : 0;
+   }
+
+   //
+   // Status
+   //
+   size_t size() const
+   {
+      return keys.size();
+   }
+   bool empty() const
+   {
+      return keys.empty();
+   }
+   size_t bucket_count() const
+   {
+      return displacements.size();
+   }
+
+private:
+   // give up on a seed after this many displacements of one group,
+   // and on the whole build after this many seeds
+   static const uint32_t MAX_SEEDS = 64;
+   static uint32_t maxTries(size_t numKeys)
+   {
+      return numKeys < 0x10000000 ? (uint32_t)(16 * numKeys + 256) : 0xFFFFFFFFu;
+   }
+
+   template <class Iterator>
+   void build(Iterator first, Iterator last);
+
+   template <class K>
+   iterator findKey(const K& k) const
+   {
+      if (keys.empty())
+         return end();
+      uint64_t hash = mix64((uint64_t)hashFunction(k) ^ seed);
+      size_t slot = frozenSlot(hash, displacements[frozenBucket(hash, displacements.size())],
+                               keys.size());
+      return keyEqual(keys[slot], k) ? begin() + slot : end();
+   }
+
+   custom::vector<T> keys;                // every key, in its slot
+   custom::vector<uint32_t> displacements; // one per group of keys
+   uint64_t seed;                         // mixed into every hash
+   Hash hashFunction;                     // turns a key into a size_t
+   KeyEqual keyEqual;                     // are two keys the same?
+};
+
+/*****************************************
+ * FROZEN UNORDERED SET :: BUILD
+ * Hash every key once, drop repeats, then look for a seed
+ * under which CHD can place them all. Two different keys
+ * with the same full hash can never be split up by any seed;
+ * that is reported as an error rather than looping forever
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+template <class Iterator>
+void frozen_unordered_set<T, Hash, KeyEqual>::build(Iterator first, Iterator last)
+{
+   std::vector<T> items;
+   for (Iterator it = first; it != last; ++it)
+      items.push_back(*it);
+
+   // sort by hash so repeats, and hashes that collide outright, are adjacent
+   std::vector<std::pair<uint64_t, size_t>> byHash(items.size());
+   for (size_t i = 0; i < items.size(); i++)
+      byHash[i] = std::pair<uint64_t, size_t>((uint64_t)hashFunction(items[i]), i);
+   std::sort(byHash.begin(), byHash.end());
+
+   std::vector<uint64_t> raw;
+   std::vector<size_t> unique;
+   for (size_t i = 0; i < byHash.size(); i++)
+   {
+      if (!raw.empty() && raw.back() == byHash[i].first)
+      {
+         if (keyEqual(items[unique.back()], items[byHash[i].second]))
+            continue;
+         throw "ERROR: Two keys have the same hash, so no perfect hash can tell them apart";
+      }
+      raw.push_back(byHash[i].first);
+      unique.push_back(byHash[i].second);
+   }
+
+   // look for a seed that CHD can place every key under
+   size_t numKeys = raw.size();
+   size_t numBuckets = frozenBuckets(numKeys);
+   std::vector<uint64_t> hashes(numKeys);
+   std::vector<uint32_t> displaced(numBuckets);
+   std::vector<size_t> slots(numKeys);
+   std::vector<size_t> start(numBuckets + 1);
+   std::vector<size_t> members(numKeys);
+   std::vector<size_t> order(numBuckets);
+   std::unique_ptr<bool[]> taken(new bool[numKeys + 1]);
+   for (uint32_t iSeed = 0; ; iSeed++)
+   {
+      if (iSeed == MAX_SEEDS)
+         throw "ERROR: Unable to find a perfect hash for these keys";
+      seed = mix64(iSeed);
+      for (size_t i = 0; i < numKeys; i++)
+         hashes[i] = mix64(raw[i] ^ seed);
+      if (chdBuild(hashes.data(), numKeys, numBuckets, displaced.data(), slots.data(),
+                   start.data(), members.data(), order.data(), taken.get(),
+                   maxTries(numKeys)))
+         break;
+   }
+
+   // lay the keys out in slot order
+   std::vector<size_t> bySlot(numKeys);
+   for (size_t i = 0; i < numKeys; i++)
+      bySlot[slots[i]] = unique[i];
+   keys.clear();
+   keys.reserve(numKeys);
+   for (size_t s = 0; s < numKeys; s++)
+      keys.push_back(std::move(items[bySlot[s]]));
+   displacements.clear();
+   displacements.reserve(numBuckets);
+   for (size_t b = 0; b < numBuckets; b++)
+      displacements.push_back(displaced[b]);
+}
+
+/************************************************
+ * STATIC FROZEN SET
+ * A frozen set of N integer keys whose table is worked
+ * out by the compiler. Build one with make_frozen_set:
+ *    static constexpr int primes[] = { 2, 3, 5, 7, 11 };
+ *    constexpr auto setPrimes = custom::make_frozen_set(primes);
+ *    static_assert(setPrimes.contains(7), "");
+ * Repeated keys, or a key list no seed can place, fail to
+ * compile. Large lists may need a higher
+ * -fconstexpr-ops-limit (or /constexpr:steps on MSVC)
+ ************************************************/
+template <typename T, size_t N>
+class static_frozen_set
+{
+   friend class ::TestFrozen;   // give unit tests access to the privates
+
+   static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                 "static_frozen_set hashes its keys at compile time, so they must be integers");
+   static_assert(N > 0, "a static_frozen_set needs at least one key");
+
+   static const size_t NUM_BUCKETS = frozenBuckets(N);
+   static const uint32_t MAX_SEEDS = 64;
+
+public:
+   typedef const T* iterator;
+   typedef const T* const_iterator;
+
+   constexpr explicit static_frozen_set(const T (&list)[N]) :
+      keys{}, displacements{}, seed(0)
+   {
+      for (size_t i = 0; i < N; i++)
+         for (size_t j = i + 1; j < N; j++)
+            if (list[i] == list[j])
+               throw "ERROR: A key is listed twice";
+
+      uint64_t hashes[N] = {};
+      size_t slots[N] = {};
+      size_t start[NUM_BUCKETS + 1] = {};
+      size_t members[N] = {};
+      size_t order[NUM_BUCKETS] = {};
+      bool taken[N] = {};
+      for (uint32_t iSeed = 0; ; iSeed++)
+      {
+         if (iSeed == MAX_SEEDS)
+            throw "ERROR: Unable to find a perfect hash for these keys";
+         seed = mix64(iSeed);
+         for (size_t i = 0; i < N; i++)
+            hashes[i] = mix64((uint64_t)list[i] ^ seed);
+         if (chdBuild(hashes, N, NUM_BUCKETS, displacements, slots,
+                      start, members, order, taken, (uint32_t)(16 * N + 256)))
+            break;
+      }
+      for (size_t i = 0; i < N; i++)
+         keys[slots[i]] = list[i];
+   }
+
+   constexpr iterator begin() const { return keys;     }
+   constexpr iterator end()   const { return keys + N; }
+
+   constexpr iterator find(const T& t) const
+   {
+      return keys[slotOf(t)] == t ? keys + slotOf(t) : end();
+   }
+   constexpr bool contains(const T& t) const
+   {
+      return keys[slotOf(t)] == t;
+   }
+   constexpr size_t count(const T& t) const
+   {
+      return contains(t) ? 1 : 0;
+   }
+   constexpr size_t size() const
+   {
+      return N;
+   }
+
+private:
+   constexpr size_t slotOf(const T& t) const
+   {
+      uint64_t hash = mix64((uint64_t)t ^ seed);
+      return frozenSlot(hash, displacements[frozenBucket(hash, NUM_BUCKETS)], N);
+   }
+
+   T keys[N];                   // every key, in its slot
+   uint32_t displacements[NUM_BUCKETS]; // one per group of keys
+   uint64_t seed;                       // mixed into every hash
+};
+
+/*****************************************
+ * MAKE FROZEN SET
+ * Build a static_frozen_set from an array, at compile time
+ * when the result is constexpr
+ ****************************************/
+template <typename T, size_t N>
+constexpr static_frozen_set<T, N> make_frozen_set(const T (&list)[N])
+{
+   return static_frozen_set<T, N>(list);
+}
+
+} // namespace custom
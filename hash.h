@@ -13,6 +13,8 @@
  *    This will contain the class definition of:
  *        unordered_set           : A class that represents a hash
  *        unordered_set::iterator : An interator through hash
+ *        flat_unordered_set      : An open-addressed hash in one array
+ *        robin_hood_unordered_set: A flat hash with Robin Hood probing
  * Author
  *    <your names here>
  ************************************************************************/
@@ -20,80 +22,232 @@
 #pragma once
 
 #include "list.h"     // because this->buckets[0] is a list
+#include "pair.h"     // for custom::pair
+#include "hashers.h"  // for custom::mix64
 #include <memory>     // for std::allocator
 #include <functional> // for std::hash
 #include <cmath>      // for std::ceil
-   
+#include <type_traits>// for std::integral_constant
+#include <iterator>   // for std::distance and std::iterator_traits
+#include <iosfwd>     // for std::ostream
+#include <new>        // for placement new
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <memory_resource> // for std::pmr::polymorphic_allocator
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h> // for _mm_prefetch
+#endif
+
 
 class TestHash;             // forward declaration for Hash unit tests
 
 namespace custom
 {
+/************************************************
+ * STORE HASH
+ * Whether unordered_set keeps the full hash of each
+ * element next to it in the bucket. That costs one
+ * size_t per element but means rehash never calls
+ * the hasher again, and a compare against a different
+ * element is nearly always rejected on the hash before
+ * KeyEqual runs. It is on by default for anything that
+ * is not a scalar; specialize it to change that.
+ ************************************************/
+template <class T, class Hash>
+struct store_hash : std::integral_constant<bool, !std::is_scalar<T>::value>
+{
+};
+
+/************************************************
+ * IS TRANSPARENT
+ * Does a hasher or equality functor declare
+ * is_transparent? If both of a set's do, lookups
+ * accept any key type the functors accept, so a
+ * set of std::string can be searched with a
+ * const char* without building a std::string.
+ ************************************************/
+template <class...>
+struct make_void
+{
+   typedef void type;
+};
+template <class F, class = void>
+struct is_transparent : std::false_type
+{
+};
+template <class F>
+struct is_transparent<F, typename make_void<typename F::is_transparent>::type> : std::true_type
+{
+};
+
+/************************************************
+ * PREFETCH
+ * Ask the processor to start loading the cache line
+ * holding p. This is only a hint; it does nothing on
+ * compilers we do not know how to ask.
+ ************************************************/
+inline void prefetch(const void* p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+   _mm_prefetch((const char*)p, _MM_HINT_T0);
+#endif
+}
+
+/************************************************
+ * NO STATS
+ * The statistics policy of unordered_set, and the one
+ * it uses by default. The set calls these hooks as it
+ * works; here they are all empty, so they compile to
+ * nothing and the set is no bigger for having them.
+ * A policy that counts (see stats.h) provides the same
+ * members and does something in them.
+ ************************************************/
+struct no_stats
+{
+   void inserted()                  {}  // an element was added
+   void found(bool /* hit */)       {}  // a find, count or contains finished
+   void erased()                    {}  // an element was erased
+   void rehashed()                  {}  // the buckets were replaced
+   void allocated(size_t /* num */) {}  // num nodes were allocated
+   void compared()                  {}  // KeyEqual was called
+   void probed(size_t /* length */) {}  // a walk down one chain visited length nodes
+   template <class Set>
+   void dump(std::ostream&, const Set&) const {}
+};
+
+/************************************************
+ * HASH ENTRY
+ * What a bucket holds when the hash is stored
+ ************************************************/
+template <class T>
+struct hash_entry
+{
+   hash_entry() : data(), hash(0) {}
+   hash_entry(const T& data, size_t hash) : data(data), hash(hash) {}
+   hash_entry(T&& data, size_t hash) : data(std::move(data)), hash(hash) {}
+   template <class... Args>
+   hash_entry(size_t hash, Args&&... args) :
+      data(std::forward<Args>(args)...), hash(hash) {}
+
+   T data;
+   size_t hash;
+};
+
 /************************************************
  * UNORDERED SET
  * A set implemented as a hash
  ************************************************/
-template <typename T>
-class unordered_set
+template <typename T,
+          typename Hash = std::hash<T>,
+          typename KeyEqual = std::equal_to<T>,
+          typename Alloc = std::allocator<T>,
+          typename Stats = no_stats>
+class unordered_set : private Stats
 {
    friend class ::TestHash;   // give unit tests access to the privates
+
+   // each bucket holds either T or a hash_entry<T>
+   static const bool STORE_HASH = store_hash<T, Hash>::value;
+   typedef typename std::conditional<STORE_HASH, hash_entry<T>, T>::type Entry;
+
+   // every bucket and every node comes from Alloc, rebound as needed
+   typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Entry> EntryAlloc;
+   typedef custom::list<Entry, EntryAlloc> Bucket;
+   typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Bucket> BucketAlloc;
+   typedef std::allocator_traits<BucketAlloc> BucketTraits;
+   typedef typename std::allocator_traits<Alloc>::template rebind_alloc<size_t> BitsAlloc;
+   typedef std::allocator_traits<BitsAlloc> BitsTraits;
+   typedef std::allocator_traits<Alloc> AllocTraits;
+
 public:
+   typedef Hash     hasher;
+   typedef KeyEqual key_equal;
+   typedef Alloc    allocator_type;
+
    //
    // Construct
    //
-   unordered_set()
+   unordered_set(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                 const Alloc& alloc = Alloc()) :
+      buckets(nullptr), numBuckets(0), numElements(0), maxLoadFactor(1.0f),
+      hashFunction(hash), keyEqual(equal), alloc(alloc),
+      bucketsOld(nullptr), numBucketsOld(0), iMigrate(0), migrated(nullptr),
+      rehashBudget(0)
+   {
+      allocate(DEFAULT_BUCKETS);
+   }
+   explicit unordered_set(const Alloc& alloc) : unordered_set(Hash(), KeyEqual(), alloc)
+   {
+   }
+   unordered_set(unordered_set&  rhs) :
+      unordered_set(rhs, AllocTraits::select_on_container_copy_construction(rhs.alloc))
    {
    }
-   unordered_set(unordered_set&  rhs) 
+   unordered_set(unordered_set&  rhs, const Alloc& alloc) :
+      buckets(nullptr), numBuckets(0), numElements(0), maxLoadFactor(1.0f),
+      hashFunction(rhs.hashFunction), keyEqual(rhs.keyEqual), alloc(alloc),
+      bucketsOld(nullptr), numBucketsOld(0), iMigrate(0), migrated(nullptr),
+      rehashBudget(0)
    {
+      *this = rhs;
    }
-   unordered_set(unordered_set&& rhs) 
+   unordered_set(unordered_set&& rhs) :
+      unordered_set(rhs.hashFunction, rhs.keyEqual, rhs.alloc)
    {
+      swapContents(rhs);
    }
    template <class Iterator>
-   unordered_set(Iterator first, Iterator last)
+   unordered_set(Iterator first, Iterator last) : unordered_set()
    {
+      insert(first, last);
+   }
+  ~unordered_set()
+   {
+      finishRehash();
+      deleteBuckets(buckets, numBuckets);
    }
 
    //
    // Assign
    //
-   unordered_set& operator=(unordered_set& rhs)
-   {
-      return *this;
-   }
-   unordered_set& operator=(unordered_set&& rhs)
-   {
-      return *this;
-   }
+   unordered_set& operator=(unordered_set& rhs);
+   unordered_set& operator=(unordered_set&& rhs);
    unordered_set& operator=(const std::initializer_list<T>& il)
    {
+      clear();
+      insert(il);
       return *this;
    }
    void swap(unordered_set& rhs)
    {
+      swapAllocator(rhs, typename AllocTraits::propagate_on_container_swap());
+      swapContents(rhs);
    }
 
-   // 
+   //
    // Iterator
    //
    class iterator;
    class local_iterator;
-   iterator begin()
-   {
-      return iterator();
-   }
+   class node_type;
+   struct insert_return_type;
+   iterator begin();
    iterator end()
    {
-      return iterator();
+      return iterator(buckets + numBuckets, buckets + numBuckets,
+                      typename Bucket::iterator());
    }
    local_iterator begin(size_t iBucket)
    {
-      return local_iterator();
+      finishRehash();
+      return local_iterator(buckets[iBucket].begin());
    }
    local_iterator end(size_t iBucket)
    {
-      return local_iterator();
+      finishRehash();
+      return local_iterator(buckets[iBucket].end());
    }
 
    //
@@ -101,49 +255,399 @@ public:
    //
    size_t bucket(const T& t)
    {
-      return 99;
+      finishRehash();
+      return hashFunction(t) % numBuckets;
    }
-   iterator find(const T& t);
+   template <class K, class H = Hash, class E = KeyEqual,
+             typename std::enable_if<is_transparent<H>::value && is_transparent<E>::value, int>::type = 0>
+   size_t bucket(const K& k)
+   {
+      finishRehash();
+      return hashFunction(k) % numBuckets;
+   }
+   iterator find(const T& t)
+   {
+      return findKey(t);
+   }
+   template <class K, class H = Hash, class E = KeyEqual,
+             typename std::enable_if<is_transparent<H>::value && is_transparent<E>::value, int>::type = 0>
+   iterator find(const K& k)
+   {
+      return findKey(k);
+   }
+   size_t count(const T& t)
+   {
+      return findKey(t) == end() ? 0 : 1;
+   }
+   template <class K, class H = Hash, class E = KeyEqual,
+             typename std::enable_if<is_transparent<H>::value && is_transparent<E>::value, int>::type = 0>
+   size_t count(const K& k)
+   {
+      return findKey(k) == end() ? 0 : 1;
+   }
+   bool contains(const T& t)
+   {
+      return findKey(t) != end();
+   }
+   template <class K, class H = Hash, class E = KeyEqual,
+             typename std::enable_if<is_transparent<H>::value && is_transparent<E>::value, int>::type = 0>
+   bool contains(const K& k)
+   {
+      return findKey(k) != end();
+   }
+   void find_batch(const T* keys, size_t num, iterator* out);
+   void contains_batch(const T* keys, size_t num, bool* out);
 
-   //   
+   //
    // Insert
    //
-   custom::pair<iterator, bool> insert(const T& t);
+   custom::pair<iterator, bool> insert(const T& t)
+   {
+      return emplaceKey(t, t);
+   }
+   custom::pair<iterator, bool> insert(T&& t)
+   {
+      return emplaceKey(t, std::move(t));
+   }
    void insert(const std::initializer_list<T> & il);
+   template <class Iterator>
+   void insert(Iterator first, Iterator last)
+   {
+      insertRange(first, last,
+                  typename std::iterator_traits<Iterator>::iterator_category());
+   }
+   template <class... Args>
+   custom::pair<iterator, bool> emplace(Args&&... args)
+   {
+      return emplaceArgs(is_key<Args...>(), std::forward<Args>(args)...);
+   }
+   template <class... Args>
+   iterator emplace_hint(iterator, Args&&... args)
+   {
+      // a hash has no use for a hint
+      return emplace(std::forward<Args>(args)...).first;
+   }
+   insert_return_type insert(node_type&& nh);
+   iterator insert(iterator hint, node_type&& nh)
+   {
+      return insert(std::move(nh)).position;
+   }
+   void rehash(size_t numBuckets);
+   void reserve(size_t num)
+   {
+      rehash((size_t)std::ceil((float)num / maxLoadFactor));
+   }
 
-
-   // 
+   //
    // Remove
    //
    void clear() noexcept
    {
+      finishRehash();
+      for (size_t i = 0; i < numBuckets; i++)
+         buckets[i].clear();
+      numElements = 0;
+   }
+   iterator erase(const T& t)
+   {
+      return eraseKey(t);
+   }
+   template <class K, class H = Hash, class E = KeyEqual,
+             typename std::enable_if<is_transparent<H>::value && is_transparent<E>::value, int>::type = 0>
+   iterator erase(const K& k)
+   {
+      return eraseKey(k);
+   }
+   node_type extract(iterator it);
+   node_type extract(const T& t)
+   {
+      return extract(find(t));
+   }
+   void merge(unordered_set& source);
+   void merge(unordered_set&& source)
+   {
+      merge(source);
    }
-   iterator erase(const T& t);
 
    //
    // Status
    //
-   size_t size() const 
-   { 
-      return 99;
+   size_t size() const
+   {
+      return numElements;
    }
-   bool empty() const 
-   { 
-      return false;
+   bool empty() const
+   {
+      return numElements == 0;
    }
-   size_t bucket_count() const 
-   { 
-      return 100;
+   size_t bucket_count() const
+   {
+      return numBuckets;
    }
-   size_t bucket_size(size_t i) const
+   size_t bucket_size(size_t i)
+   {
+      finishRehash();
+      return buckets[i].size();
+   }
+   size_t bucket_size(size_t i) const;
+   float load_factor() const noexcept
+   {
+      return (float)numElements / (float)numBuckets;
+   }
+   float max_load_factor() const noexcept
+   {
+      return maxLoadFactor;
+   }
+   void max_load_factor(float m)
+   {
+      maxLoadFactor = m;
+      if (load_factor() > maxLoadFactor)
+         rehash(0);
+   }
+   size_t rehash_budget() const noexcept
+   {
+      return rehashBudget;
+   }
+   void rehash_budget(size_t num)
+   {
+      rehashBudget = num;
+   }
+   bool rehashing() const noexcept
+   {
+      return bucketsOld != nullptr;
+   }
+   float rehash_progress() const noexcept
+   {
+      return bucketsOld ? (float)iMigrate / (float)numBucketsOld : 1.0f;
+   }
+   Hash     hash_function() const { return hashFunction; }
+   KeyEqual key_eq()        const { return keyEqual;     }
+   Alloc    get_allocator() const { return alloc;        }
+
+   //
+   // Statistics: whatever the Stats policy has gathered. Nothing
+   // with the default no_stats
+   //
+   const Stats& stats() const { return *this; }
+   Stats&       stats()       { return *this; }
+   void dump_stats(std::ostream& os) const
    {
-      return 99;
+      stats().dump(os, *this);
    }
 
 private:
+   static const size_t DEFAULT_BUCKETS = 10;
+   static const size_t BULK_PARTITIONS = 256;
+
+   void allocate(size_t num);
+   Bucket* newBuckets(size_t num);
+   void deleteBuckets(Bucket* pBuckets, size_t num);
+
+   // everything but the allocator, which the two sets must already share
+   void swapContents(unordered_set& rhs)
+   {
+      std::swap(buckets,       rhs.buckets);
+      std::swap(numBuckets,    rhs.numBuckets);
+      std::swap(numElements,   rhs.numElements);
+      std::swap(maxLoadFactor, rhs.maxLoadFactor);
+      std::swap(hashFunction,  rhs.hashFunction);
+      std::swap(keyEqual,      rhs.keyEqual);
+      std::swap(bucketsOld,    rhs.bucketsOld);
+      std::swap(numBucketsOld, rhs.numBucketsOld);
+      std::swap(iMigrate,      rhs.iMigrate);
+      std::swap(migrated,      rhs.migrated);
+      std::swap(rehashBudget,  rhs.rehashBudget);
+   }
+
+   // what the propagate_on_container_* traits of Alloc tell us to do
+   void copyAllocator(const unordered_set& rhs, std::true_type)  { alloc = rhs.alloc; }
+   void copyAllocator(const unordered_set&, std::false_type) {}
+   void moveAllocator(unordered_set& rhs, std::true_type)  { alloc = std::move(rhs.alloc); }
+   void moveAllocator(unordered_set&, std::false_type) {}
+   void swapAllocator(unordered_set& rhs, std::true_type)
+   {
+      using std::swap;
+      swap(alloc, rhs.alloc);
+   }
+   void swapAllocator(unordered_set& rhs, std::false_type)
+   {
+      // without propagation only equal allocators may trade buckets
+      assert(alloc == rhs.alloc);
+   }
+   template <class K>
+   typename Bucket::iterator findIn(Bucket* pBucket, const K& k, size_t hash);
+   template <class K>
+   typename Bucket::iterator locate(const K& k, size_t hash, Bucket*& pBucket);
+   template <class K>
+   iterator findKey(const K& k);
+   template <class K>
+   iterator eraseKey(const K& k);
+   template <class Resolve>
+   void batch(const T* keys, size_t num, Resolve resolve);
+
+   //
+   // Bulk load: a range we can walk more than once is counted first so
+   // the buckets are sized once, then loaded a partition at a time
+   //
+   template <class Iterator>
+   void insertRange(Iterator first, Iterator last, std::input_iterator_tag)
+   {
+      for (auto it = first; it != last; ++it)
+         insert(*it);
+   }
+   template <class Iterator>
+   void insertRange(Iterator first, Iterator last, std::forward_iterator_tag)
+   {
+      typedef typename std::iterator_traits<Iterator>::reference Reference;
+      size_t num = (size_t)std::distance(first, last);
+      finishRehash();
+      if ((float)(numElements + num) > maxLoadFactor * (float)numBuckets)
+         reserve(numElements + num);
+      bulkLoad(first, last, num, std::integral_constant<bool,
+               std::is_lvalue_reference<Reference>::value &&
+               std::is_same<typename std::decay<Reference>::type, T>::value>());
+   }
+   template <class Iterator>
+   void bulkLoad(Iterator first, Iterator last, size_t num, std::false_type)
+   {
+      // the range makes its elements on the fly; nothing to point to
+      for (auto it = first; it != last; ++it)
+         insert(*it);
+   }
+   template <class Iterator>
+   void bulkLoad(Iterator first, Iterator last, size_t num, std::true_type);
+
+   //
+   // Entry access: the same code works whether or not the hash is stored
+   //
+   static T& valueOf(T& entry)             { return entry;      }
+   static T& valueOf(hash_entry<T>& entry) { return entry.data; }
+   size_t hashOf(const T& entry) const     { return hashFunction(entry); }
+   size_t hashOf(const hash_entry<T>& entry) const { return entry.hash; }
+   template <class K>
+   bool matches(const T& entry, const K& k, size_t)
+   {
+      return equals(entry, k);
+   }
+   template <class K>
+   bool matches(const hash_entry<T>& entry, const K& k, size_t hash)
+   {
+      return entry.hash == hash && equals(entry.data, k);
+   }
+   template <class K>
+   bool equals(const T& t, const K& k)
+   {
+      stats().compared();
+      return keyEqual(t, k);
+   }
+
+   // is an element equal to entry's in this bucket? This is our own
+   // bookkeeping rather than a lookup, so the stats do not see it
+   bool holds(Bucket* pBucket, T& entry)
+   {
+      for (auto it = pBucket->begin(); it != pBucket->end(); ++it)
+         if (keyEqual(*it, entry))
+            return true;
+      return false;
+   }
+   bool holds(Bucket* pBucket, hash_entry<T>& entry)
+   {
+      for (auto it = pBucket->begin(); it != pBucket->end(); ++it)
+         if ((*it).hash == entry.hash && keyEqual((*it).data, entry.data))
+            return true;
+      return false;
+   }
+
+   //
+   // Emplace: look the key up before anything is built, then build the
+   // element once and move it into its node
+   //
+
+   // can the arguments to emplace be used as the key without building a T?
+   template <class... Args>
+   struct is_key : std::false_type
+   {
+   };
+   template <class Arg>
+   struct is_key<Arg> : std::integral_constant<bool,
+      std::is_same<typename std::decay<Arg>::type, T>::value ||
+      (is_transparent<Hash>::value && is_transparent<KeyEqual>::value)>
+   {
+   };
+   template <class Arg>
+   custom::pair<iterator, bool> emplaceArgs(std::true_type, Arg&& arg)
+   {
+      return emplaceKey(arg, std::forward<Arg>(arg));
+   }
+   template <class... Args>
+   custom::pair<iterator, bool> emplaceArgs(std::false_type, Args&&... args)
+   {
+      T t(std::forward<Args>(args)...);
+      return emplaceKey(t, std::move(t));
+   }
+   template <class K, class... Args>
+   custom::pair<iterator, bool> emplaceKey(const K& k, Args&&... args);
+   Bucket* makeRoom(size_t hash);
+
+   //
+   // Incremental rehash: growing only allocates the new buckets. The
+   // old ones are emptied into them rehashBudget at a time by every
+   // find, insert and erase that follows, and any old bucket a key
+   // is looked for in is emptied first. Old bucket i empties into new
+   // buckets i and i + numBucketsOld, which are built only then, and
+   // is destroyed once empty
+   //
+   static const size_t BITS = sizeof(size_t) * 8;
+   static size_t numWords(size_t numBits)
+   {
+      return (numBits + BITS - 1) / BITS;
+   }
+   bool isMigrated(size_t iOld) const
+   {
+      return (migrated[iOld / BITS] >> (iOld % BITS)) & 1;
+   }
+   Bucket* home(size_t hash)
+   {
+      if (bucketsOld)
+         migrateBucket(hash % numBucketsOld);
+      return buckets + (hash % numBuckets);
+   }
+   void startRehash(size_t num);
+   void migrate(size_t num);
+   void migrateBucket(size_t iOld);
+   void migrateStep()
+   {
+      if (bucketsOld)
+         migrate(rehashBudget ? rehashBudget : numBucketsOld);
+   }
+   void finishRehash()
+   {
+      if (bucketsOld)
+         migrate(numBucketsOld);
+   }
+   template <class... Args>
+   void pushEntry(Bucket* pBucket, size_t, std::false_type, Args&&... args)
+   {
+      pBucket->emplace_back(std::forward<Args>(args)...);
+   }
+   template <class... Args>
+   void pushEntry(Bucket* pBucket, size_t hash, std::true_type, Args&&... args)
+   {
+      pBucket->emplace_back(hash, std::forward<Args>(args)...);
+   }
 
-   custom::list<T> buckets [10];   // exactly 10 buckets
-   int numElements;                // number of elements in the Hash
+   Bucket * buckets;               // dynamically-allocated array of buckets
+   size_t numBuckets;              // number of buckets in the array
+   size_t numElements;             // number of elements in the Hash
+   float maxLoadFactor;            // grow when numElements / numBuckets exceeds this
+   Hash hashFunction;              // turns an element into a size_t
+   KeyEqual keyEqual;              // are two elements the same?
+   Alloc alloc;                    // where the buckets and nodes come from
+   Bucket * bucketsOld;            // buckets being emptied by a rehash, or nullptr
+   size_t numBucketsOld;           // number of buckets in bucketsOld
+   size_t iMigrate;                // bucketsOld[0, iMigrate) are already empty
+   size_t * migrated;              // one bit per old bucket, set once it is emptied
+   size_t rehashBudget;            // old buckets moved per operation; 0 rehashes at once
 };
 
 
@@ -151,26 +655,30 @@ private:
  * UNORDERED SET ITERATOR
  * Iterator for an unordered set
  ************************************************/
-template <typename T>
-class unordered_set <T> ::iterator
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+class unordered_set <T, Hash, KeyEqual, Alloc, Stats> ::iterator
 {
    friend class ::TestHash;   // give unit tests access to the privates
-   template <class TT>
+   template <class TT, class HH, class EE, class AA, class SS>
    friend class custom::unordered_set;
 public:
-   // 
+   //
    // Construct
    //
-   iterator()  
-   {  
+   iterator() : pBucket(nullptr), pBucketEnd(nullptr), itList(), pSet(nullptr)
+   {
    }
-   iterator(typename custom::list<T>* pBucket,
-            typename custom::list<T>* pBucketEnd,
-            typename custom::list<T>::iterator itList)
+   iterator(Bucket* pBucket,
+            Bucket* pBucketEnd,
+            typename Bucket::iterator itList,
+            const unordered_set* pSet = nullptr) :
+      pBucket(pBucket), pBucketEnd(pBucketEnd), itList(itList), pSet(pSet)
    {
    }
-   iterator(const iterator& rhs) 
-   { 
+   iterator(const iterator& rhs) :
+      pBucket(rhs.pBucket), pBucketEnd(rhs.pBucketEnd), itList(rhs.itList),
+      pSet(rhs.pSet)
+   {
    }
 
    //
@@ -178,27 +686,31 @@ public:
    //
    iterator& operator = (const iterator& rhs)
    {
+      pBucket    = rhs.pBucket;
+      pBucketEnd = rhs.pBucketEnd;
+      itList     = rhs.itList;
+      pSet       = rhs.pSet;
       return *this;
    }
 
    //
    // Compare
    //
-   bool operator != (const iterator& rhs) const 
-   { 
-      return true;
+   bool operator != (const iterator& rhs) const
+   {
+      return !(*this == rhs);
    }
-   bool operator == (const iterator& rhs) const 
-   { 
-      return true;
+   bool operator == (const iterator& rhs) const
+   {
+      return pBucket == rhs.pBucket && itList == rhs.itList;
    }
 
-   // 
+   //
    // Access
    //
    T& operator * ()
    {
-      return *(new T());
+      return unordered_set::valueOf(*itList);
    }
 
    //
@@ -207,13 +719,16 @@ public:
    iterator& operator ++ ();
    iterator operator ++ (int postfix)
    {
-      return *this;
+      iterator itReturn(*this);
+      ++(*this);
+      return itReturn;
    }
 
 private:
-   custom::list<T> *pBucket;
-   custom::list<T> *pBucketEnd;
-   typename list<T>::iterator itList;
+   Bucket *pBucket;
+   Bucket *pBucketEnd;
+   typename Bucket::iterator itList;
+   const unordered_set* pSet;   // to find the old buckets of a rehash, if any
 };
 
 
@@ -221,25 +736,26 @@ private:
  * UNORDERED SET LOCAL ITERATOR
  * Iterator for a single bucket in an unordered set
  ************************************************/
-template <typename T>
-class unordered_set <T> ::local_iterator
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+class unordered_set <T, Hash, KeyEqual, Alloc, Stats> ::local_iterator
 {
    friend class ::TestHash;   // give unit tests access to the privates
 
-   template <class TT>
+   template <class TT, class HH, class EE, class AA, class SS>
    friend class custom::unordered_set;
 public:
-   // 
+   //
    // Construct
    //
-   local_iterator()  
+   local_iterator() : itList()
    {
    }
-   local_iterator(const typename custom::list<T>::iterator& itList) 
+   local_iterator(const typename Bucket::iterator& itList) :
+      itList(itList)
    {
    }
-   local_iterator(const local_iterator& rhs) 
-   { 
+   local_iterator(const local_iterator& rhs) : itList(rhs.itList)
+   {
    }
 
    //
@@ -247,97 +763,1384 @@ public:
    //
    local_iterator& operator = (const local_iterator& rhs)
    {
+      itList = rhs.itList;
       return *this;
    }
 
-   // 
+   //
    // Compare
    //
    bool operator != (const local_iterator& rhs) const
    {
-      return true;
+      return itList != rhs.itList;
    }
    bool operator == (const local_iterator& rhs) const
    {
-      return true;
+      return itList == rhs.itList;
    }
 
-   // 
+   //
    // Access
    //
    T& operator * ()
    {
-      return *(new T());
+      return unordered_set::valueOf(*itList);
    }
 
-   // 
+   //
    // Arithmetic
    //
    local_iterator& operator ++ ()
    {
+      ++itList;
       return *this;
    }
    local_iterator operator ++ (int postfix)
    {
+      local_iterator itReturn(*this);
+      ++itList;
+      return itReturn;
+   }
+
+private:
+   typename Bucket::iterator itList;
+};
+
+/************************************************
+ * UNORDERED SET NODE TYPE
+ * Owns one element, still in the node it had in the set,
+ * between an extract() and an insert()
+ ************************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+class unordered_set <T, Hash, KeyEqual, Alloc, Stats> ::node_type
+{
+   friend class ::TestHash;   // give unit tests access to the privates
+   friend class unordered_set;
+public:
+   //
+   // Construct
+   //
+   node_type()
+   {
+   }
+   node_type(node_type&& rhs) : node(std::move(rhs.node))
+   {
+   }
+
+   //
+   // Assign: a handle always takes the allocator of its node along,
+   // whatever Alloc says about propagating, since only that one
+   // can free it
+   //
+   node_type& operator = (node_type&& rhs)
+   {
+      if (this != &rhs)
+      {
+         node.~Bucket();
+         new (&node) Bucket(std::move(rhs.node));
+      }
       return *this;
    }
+   void swap(node_type& rhs)
+   {
+      node_type tmp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(tmp);
+   }
+
+   //
+   // Access
+   //
+   bool empty() const
+   {
+      return node.empty();
+   }
+   explicit operator bool() const
+   {
+      return !node.empty();
+   }
+   T& value()
+   {
+      return unordered_set::valueOf(node.front());
+   }
 
 private:
-   typename list<T>::iterator itList;
+   explicit node_type(const EntryAlloc& alloc) : node(alloc)
+   {
+   }
+
+   Bucket node;   // the one node, or nothing
+};
+
+/************************************************
+ * UNORDERED SET INSERT RETURN TYPE
+ * Where a node handle went, and the handle back if
+ * the set already had its element
+ ************************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+struct unordered_set <T, Hash, KeyEqual, Alloc, Stats> ::insert_return_type
+{
+   iterator  position;
+   bool      inserted;
+   node_type node;
 };
 
 
 /*****************************************
- * UNORDERED SET :: ERASE
- * Remove one element from the unordered set
+ * UNORDERED SET :: ALLOCATE
+ * Replace the bucket array with num empty buckets
  ****************************************/
-template <typename T>
-typename unordered_set <T> ::iterator unordered_set<T>::erase(const T& t)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::allocate(size_t num)
 {
-   return iterator();
+   assert(num > 0);
+   finishRehash();
+   deleteBuckets(buckets, numBuckets);
+   buckets = nullptr;
+   numBuckets = 0;
+   buckets = newBuckets(num);
+   numBuckets = num;
+   numElements = 0;
 }
 
 /*****************************************
- * UNORDERED SET :: INSERT
- * Insert one element into the hash
+ * UNORDERED SET :: NEW BUCKETS
+ * An array of num empty buckets from our allocator. Each
+ * bucket gets a copy of it for its nodes
  ****************************************/
-template <typename T>
-custom::pair<typename custom::unordered_set<T>::iterator, bool> unordered_set<T>::insert(const T& t)
-{
-   return custom::pair<custom::unordered_set<T>::iterator, bool>(iterator(), true);
-}
-template <typename T>
-void unordered_set<T>::insert(const std::initializer_list<T> & il)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+typename unordered_set<T, Hash, KeyEqual, Alloc, Stats>::Bucket* unordered_set<T, Hash, KeyEqual, Alloc, Stats>::newBuckets(size_t num)
 {
+   BucketAlloc bucketAlloc(alloc);
+   Bucket* pBuckets = BucketTraits::allocate(bucketAlloc, num);
+   EntryAlloc entryAlloc(alloc);
+   for (size_t i = 0; i < num; i++)
+      new (pBuckets + i) Bucket(entryAlloc);
+   return pBuckets;
 }
 
 /*****************************************
- * UNORDERED SET :: FIND
- * Find an element in an unordered set
+ * UNORDERED SET :: DELETE BUCKETS
+ * Free every node in num buckets, then the array itself
  ****************************************/
-template <typename T>
-typename unordered_set <T> ::iterator unordered_set<T>::find(const T& t)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::deleteBuckets(Bucket* pBuckets, size_t num)
 {
-   return iterator();
+   if (pBuckets == nullptr)
+      return;
+   for (size_t i = 0; i < num; i++)
+      pBuckets[i].~Bucket();
+   BucketAlloc bucketAlloc(alloc);
+   BucketTraits::deallocate(bucketAlloc, pBuckets, num);
 }
 
 /*****************************************
- * UNORDERED SET :: ITERATOR :: INCREMENT
- * Advance by one element in an unordered set
+ * UNORDERED SET :: ASSIGN
+ * Copy the buckets of the rhs onto this
  ****************************************/
-template <typename T>
-typename unordered_set <T> ::iterator & unordered_set<T>::iterator::operator ++ ()
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+unordered_set<T, Hash, KeyEqual, Alloc, Stats>& unordered_set<T, Hash, KeyEqual, Alloc, Stats>::operator=(unordered_set& rhs)
 {
+   if (this != &rhs)
+   {
+      rhs.finishRehash();
+
+      // our buckets must go back to our allocator before we take rhs's
+      if (AllocTraits::propagate_on_container_copy_assignment::value && !(alloc == rhs.alloc))
+      {
+         finishRehash();
+         deleteBuckets(buckets, numBuckets);
+         buckets = nullptr;
+         numBuckets = 0;
+      }
+      copyAllocator(rhs, typename AllocTraits::propagate_on_container_copy_assignment());
+
+      allocate(rhs.numBuckets);
+      for (size_t i = 0; i < numBuckets; i++)
+         buckets[i] = rhs.buckets[i];
+      numElements = rhs.numElements;
+      stats().allocated(numElements);
+      maxLoadFactor = rhs.maxLoadFactor;
+      rehashBudget = rhs.rehashBudget;
+      hashFunction = rhs.hashFunction;
+      keyEqual = rhs.keyEqual;
+   }
    return *this;
 }
 
 /*****************************************
- * SWAP
- * Stand-alone unordered set swap
+ * UNORDERED SET :: MOVE ASSIGN
+ * Take the buckets of the rhs, along with its allocator if
+ * Alloc says so. Nodes from an allocator we cannot free
+ * with are left behind, and their elements moved one by one
  ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+unordered_set<T, Hash, KeyEqual, Alloc, Stats>& unordered_set<T, Hash, KeyEqual, Alloc, Stats>::operator=(unordered_set&& rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   if (alloc == rhs.alloc)
+   {
+      clear();
+      swapContents(rhs);
+   }
+   else if (AllocTraits::propagate_on_container_move_assignment::value)
+   {
+      // ours go back to our allocator, then we start over in rhs's
+      finishRehash();
+      deleteBuckets(buckets, numBuckets);
+      buckets = nullptr;
+      numBuckets = 0;
+      moveAllocator(rhs, typename AllocTraits::propagate_on_container_move_assignment());
+      allocate(DEFAULT_BUCKETS);
+      swapContents(rhs);
+   }
+   else
+   {
+      clear();
+      maxLoadFactor = rhs.maxLoadFactor;
+      rehashBudget = rhs.rehashBudget;
+      hashFunction = rhs.hashFunction;
+      keyEqual = rhs.keyEqual;
+      rhs.finishRehash();
+      rehash(rhs.numBuckets);
+      for (size_t i = 0; i < rhs.numBuckets; i++)
+         for (auto it = rhs.buckets[i].begin(); it != rhs.buckets[i].end(); ++it)
+            insert(std::move(valueOf(*it)));
+      rhs.clear();
+   }
+   return *this;
+}
+
+/*****************************************
+ * UNORDERED SET :: BEGIN
+ * The first element in the first non-empty bucket
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+typename unordered_set <T, Hash, KeyEqual, Alloc, Stats> ::iterator unordered_set<T, Hash, KeyEqual, Alloc, Stats>::begin()
+{
+   // a walk must see every element, so none may be left behind
+   finishRehash();
+   for (Bucket* pBucket = buckets; pBucket != buckets + numBuckets; pBucket++)
+      if (!pBucket->empty())
+         return iterator(pBucket, buckets + numBuckets, pBucket->begin(), this);
+   return end();
+}
+
+/*****************************************
+ * UNORDERED SET :: ERASE
+ * Remove one element from the unordered set
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+template <class K>
+typename unordered_set <T, Hash, KeyEqual, Alloc, Stats> ::iterator unordered_set<T, Hash, KeyEqual, Alloc, Stats>::eraseKey(const K& k)
+{
+   // nothing to do if the element is not here
+   migrateStep();
+   size_t hash = hashFunction(k);
+   Bucket* pBucket;
+   auto itList = locate(k, hash, pBucket);
+   if (itList == pBucket->end())
+      return end();
+   iterator itErase(pBucket, buckets + numBuckets, itList, this);
+
+   // find the element after this one before we invalidate it
+   iterator itNext = itErase;
+   ++itNext;
+
+   itErase.pBucket->erase(itErase.itList);
+   numElements--;
+   stats().erased();
+   return itNext;
+}
+
+/*****************************************
+ * UNORDERED SET :: EMPLACE KEY
+ * Insert the element built from args, whose key is k. Nothing
+ * is built and no node is allocated if k is already present
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+template <class K, class... Args>
+custom::pair<typename custom::unordered_set<T, Hash, KeyEqual, Alloc, Stats>::iterator, bool> unordered_set<T, Hash, KeyEqual, Alloc, Stats>::emplaceKey(const K& k, Args&&... args)
+{
+   migrateStep();
+
+   // hash once; the same value picks the bucket before and after a rehash
+   size_t hash = hashFunction(k);
+
+   // only one copy of each element in a set
+   Bucket* pBucket;
+   auto itList = locate(k, hash, pBucket);
+   if (itList != pBucket->end())
+      return custom::pair<iterator, bool>(iterator(pBucket, buckets + numBuckets, itList, this), false);
+
+   // grow first if one more would exceed the max load factor
+   pBucket = makeRoom(hash);
+   pushEntry(pBucket, hash, std::integral_constant<bool, STORE_HASH>(),
+             std::forward<Args>(args)...);
+   numElements++;
+   stats().inserted();
+   stats().allocated(1);
+   return custom::pair<iterator, bool>(
+      iterator(pBucket, buckets + numBuckets, pBucket->rbegin(), this), true);
+}
+
+/*****************************************
+ * UNORDERED SET :: BUCKET SIZE
+ * How many elements bucket i holds, counting those that a
+ * rehash has yet to move there. The new array is always twice
+ * the old, so until old bucket i % old is emptied, bucket i is
+ * not built and all of them are waiting there
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+size_t unordered_set<T, Hash, KeyEqual, Alloc, Stats>::bucket_size(size_t i) const
+{
+   if (!bucketsOld || isMigrated(i % numBucketsOld))
+      return buckets[i].size();
+
+   // list has no const iterator; the walk changes nothing
+   size_t num = 0;
+   Bucket& bucketOld = const_cast<Bucket&>(bucketsOld[i % numBucketsOld]);
+   for (auto it = bucketOld.begin(); it != bucketOld.end(); ++it)
+      if (hashOf(*it) % numBuckets == i)
+         num++;
+   return num;
+}
+
+/*****************************************
+ * UNORDERED SET :: MAKE ROOM
+ * Grow before the average chain length exceeds the max load
+ * factor, and return the bucket for hash afterwards. With a
+ * rehash budget, growing only starts an incremental rehash
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+typename unordered_set<T, Hash, KeyEqual, Alloc, Stats>::Bucket* unordered_set<T, Hash, KeyEqual, Alloc, Stats>::makeRoom(size_t hash)
+{
+   if ((float)(numElements + 1) > maxLoadFactor * (float)numBuckets)
+   {
+      if (rehashBudget == 0)
+         rehash(numBuckets * 2);
+      else
+         startRehash(numBuckets * 2);
+   }
+   return home(hash);
+}
+
+/*****************************************
+ * UNORDERED SET :: START REHASH
+ * Set the current buckets aside to be emptied a few at a time
+ * and carry on in num new ones. The new array is only allocated
+ * here, so starting costs the same at any size. A rehash still
+ * running is finished first: there is only room for one old array
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::startRehash(size_t num)
+{
+   finishRehash();
+   assert(num == numBuckets * 2);
+
+   BucketAlloc bucketAlloc(alloc);
+   Bucket* bucketsNew = BucketTraits::allocate(bucketAlloc, num);
+   BitsAlloc bitsAlloc(alloc);
+   migrated = BitsTraits::allocate(bitsAlloc, numWords(numBuckets));
+   for (size_t i = 0; i < numWords(numBuckets); i++)
+      migrated[i] = 0;
+
+   bucketsOld = buckets;
+   numBucketsOld = numBuckets;
+   iMigrate = 0;
+   buckets = bucketsNew;
+   numBuckets = num;
+   stats().rehashed();
+}
+
+/*****************************************
+ * UNORDERED SET :: MIGRATE
+ * Empty the next num old buckets into the new ones. Each is
+ * destroyed as it is emptied, so once the last of them is
+ * there is only the old array to free. Buckets already emptied
+ * count against num too, so each call does bounded work
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::migrate(size_t num)
+{
+   for (; num > 0 && iMigrate < numBucketsOld; num--)
+      migrateBucket(iMigrate++);
+
+   if (iMigrate == numBucketsOld)
+   {
+      BucketAlloc bucketAlloc(alloc);
+      BucketTraits::deallocate(bucketAlloc, bucketsOld, numBucketsOld);
+      BitsAlloc bitsAlloc(alloc);
+      BitsTraits::deallocate(bitsAlloc, migrated, numWords(numBucketsOld));
+      bucketsOld = nullptr;
+      migrated = nullptr;
+   }
+}
+
+/*****************************************
+ * UNORDERED SET :: MIGRATE BUCKET
+ * Build the two new buckets old bucket iOld empties into,
+ * relink every node of it into them, and destroy it
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::migrateBucket(size_t iOld)
+{
+   if (isMigrated(iOld))
+      return;
+   migrated[iOld / BITS] |= (size_t)1 << (iOld % BITS);
+
+   EntryAlloc entryAlloc(alloc);
+   new (buckets + iOld) Bucket(entryAlloc);
+   new (buckets + iOld + numBucketsOld) Bucket(entryAlloc);
+
+   Bucket& bucketOld = bucketsOld[iOld];
+   while (!bucketOld.empty())
+   {
+      Bucket& bucketNew = buckets[hashOf(bucketOld.front()) % numBuckets];
+      bucketNew.splice(bucketNew.end(), bucketOld, bucketOld.begin());
+   }
+   bucketOld.~Bucket();
+}
+
+/*****************************************
+ * UNORDERED SET :: EXTRACT
+ * Unhook the node holding *it and hand it over in a node handle.
+ * The element is not copied or moved, and the node is not freed
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+typename unordered_set<T, Hash, KeyEqual, Alloc, Stats>::node_type unordered_set<T, Hash, KeyEqual, Alloc, Stats>::extract(iterator it)
+{
+   node_type nh((EntryAlloc(alloc)));
+   if (it == end())
+      return nh;
+
+   nh.node.splice(nh.node.end(), *it.pBucket, it.itList);
+   numElements--;
+   stats().erased();
+   return nh;
+}
+
+/*****************************************
+ * UNORDERED SET :: INSERT NODE
+ * Link the node of a node handle into its bucket. If the element
+ * is already here, the handle is given back untouched
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+typename unordered_set<T, Hash, KeyEqual, Alloc, Stats>::insert_return_type unordered_set<T, Hash, KeyEqual, Alloc, Stats>::insert(node_type&& nh)
+{
+   insert_return_type result;
+   result.position = end();
+   result.inserted = false;
+   if (nh.empty())
+      return result;
+
+   migrateStep();
+   size_t hash = hashOf(nh.node.front());
+   Bucket* pBucket;
+   auto itList = locate(valueOf(nh.node.front()), hash, pBucket);
+   if (itList != pBucket->end())
+   {
+      result.position = iterator(pBucket, buckets + numBuckets, itList, this);
+      result.node = std::move(nh);
+      return result;
+   }
+
+   pBucket = makeRoom(hash);
+   pBucket->splice(pBucket->end(), nh.node, nh.node.begin());
+   numElements++;
+   stats().inserted();
+   result.position = iterator(pBucket, buckets + numBuckets, pBucket->rbegin(), this);
+   result.inserted = true;
+   return result;
+}
+
+/*****************************************
+ * UNORDERED SET :: MERGE
+ * Relink every node of source whose element is not already here.
+ * The duplicates stay behind in source
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::merge(unordered_set& source)
+{
+   if (&source == this)
+      return;
+   assert(alloc == source.alloc);   // or we could not free what we take
+   finishRehash();
+   source.finishRehash();
+
+   for (size_t i = 0; i < source.numBuckets; i++)
+   {
+      auto it = source.buckets[i].begin();
+      while (it != source.buckets[i].end())
+      {
+         auto itNext = it;
+         ++itNext;
+
+         // a rehash may start part way through, so go through home()
+         size_t hash = hashOf(*it);
+         if (!holds(home(hash), *it))
+         {
+            Bucket* pBucket = makeRoom(hash);
+            pBucket->splice(pBucket->end(), source.buckets[i], it);
+            numElements++;
+            source.numElements--;
+            stats().inserted();
+            source.stats().erased();
+         }
+         it = itNext;
+      }
+   }
+}
+
+/*****************************************
+ * UNORDERED SET :: INSERT
+ * Insert a list of elements into the hash
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::insert(const std::initializer_list<T> & il)
+{
+   insert(il.begin(), il.end());
+}
+
+/*****************************************
+ * UNORDERED SET :: BULK LOAD
+ * Insert num elements that are already in a range, after the
+ * buckets have been sized for them. Inserting in range order
+ * touches the bucket array at random, one cache miss per element.
+ * Instead radix-partition the elements by bucket index so each
+ * pass of the final loop works in one small run of buckets:
+ *    1. hash every element once and count each partition
+ *    2. scatter (hash, element) into partition order
+ *    3. insert partition by partition
+ * The scatter is stable so a bucket sees its elements in range order.
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+template <class Iterator>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::bulkLoad(Iterator first, Iterator last,
+                                                       size_t num, std::true_type)
+{
+   struct Item
+   {
+      size_t hash;
+      const T* pElement;
+   };
+
+   // a partition is a run of buckets sharing the high bits of the index
+   size_t shift = 0;
+   while (((numBuckets - 1) >> shift) >= BULK_PARTITIONS)
+      shift++;
+
+   // 1. hash and count
+   std::unique_ptr<Item[]> items(new Item[num]);
+   size_t offsets[BULK_PARTITIONS + 1] = {};
+   size_t i = 0;
+   for (auto it = first; it != last; ++it, ++i)
+   {
+      const T& t = *it;
+      items[i].hash = hashFunction(t);
+      items[i].pElement = &t;
+      offsets[((items[i].hash % numBuckets) >> shift) + 1]++;
+   }
+
+   // 2. scatter
+   for (size_t iPartition = 1; iPartition <= BULK_PARTITIONS; iPartition++)
+      offsets[iPartition] += offsets[iPartition - 1];
+   std::unique_ptr<Item[]> sorted(new Item[num]);
+   for (i = 0; i < num; i++)
+      sorted[offsets[(items[i].hash % numBuckets) >> shift]++] = items[i];
+   items.reset();
+
+   // 3. insert, skipping duplicates within the range or already here
+   for (i = 0; i < num; i++)
+   {
+      Bucket* pBucket = buckets + (sorted[i].hash % numBuckets);
+      if (findIn(pBucket, *sorted[i].pElement, sorted[i].hash) == pBucket->end())
+      {
+         pushEntry(pBucket, sorted[i].hash, std::integral_constant<bool, STORE_HASH>(),
+                   *sorted[i].pElement);
+         numElements++;
+         stats().inserted();
+         stats().allocated(1);
+      }
+   }
+}
+
+/*****************************************
+ * UNORDERED SET :: REHASH
+ * Redistribute the elements into at least numBuckets buckets,
+ * keeping the load factor at or below the max load factor
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::rehash(size_t numBuckets)
+{
+   // never go below what the max load factor allows
+   size_t numMinimum = (size_t)std::ceil((float)numElements / maxLoadFactor);
+   if (numBuckets < numMinimum)
+      numBuckets = numMinimum;
+   if (numBuckets == 0)
+      numBuckets = 1;
+   finishRehash();
+   if (numBuckets == this->numBuckets)
+      return;
+
+   // relink every node into its new bucket; nothing is allocated or
+   // moved. With a stored hash, the hasher is never called
+   Bucket* bucketsNew = newBuckets(numBuckets);
+   for (size_t i = 0; i < this->numBuckets; i++)
+      while (!buckets[i].empty())
+      {
+         Bucket& bucketNew = bucketsNew[hashOf(buckets[i].front()) % numBuckets];
+         bucketNew.splice(bucketNew.end(), buckets[i], buckets[i].begin());
+      }
+
+   deleteBuckets(buckets, this->numBuckets);
+   buckets = bucketsNew;
+   this->numBuckets = numBuckets;
+   stats().rehashed();
+}
+
+/*****************************************
+ * UNORDERED SET :: FIND IN
+ * Find a key in one bucket given its hash
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+template <class K>
+typename unordered_set<T, Hash, KeyEqual, Alloc, Stats>::Bucket::iterator
+unordered_set<T, Hash, KeyEqual, Alloc, Stats>::findIn(Bucket* pBucket,
+                                                const K& k, size_t hash)
+{
+   // with no_stats the count is never read and compiles away
+   size_t length = 0;
+   for (auto it = pBucket->begin(); it != pBucket->end(); ++it)
+   {
+      length++;
+      if (matches(*it, k, hash))
+      {
+         stats().probed(length);
+         return it;
+      }
+   }
+   stats().probed(length);
+   return pBucket->end();
+}
+
+/*****************************************
+ * UNORDERED SET :: LOCATE
+ * Find a key given its hash, and set pBucket to the new bucket
+ * it belongs in. While rehashing, a key not yet moved is still
+ * in its old bucket: that whole bucket is moved over first so
+ * the iterator we hand out stays good as migration goes on
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+template <class K>
+typename unordered_set<T, Hash, KeyEqual, Alloc, Stats>::Bucket::iterator
+unordered_set<T, Hash, KeyEqual, Alloc, Stats>::locate(const K& k, size_t hash,
+                                                Bucket*& pBucket)
+{
+   pBucket = home(hash);
+   return findIn(pBucket, k, hash);
+}
+
+/*****************************************
+ * UNORDERED SET :: FIND
+ * Find an element in an unordered set. K is either T or,
+ * with transparent functors, anything they accept
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+template <class K>
+typename unordered_set <T, Hash, KeyEqual, Alloc, Stats> ::iterator unordered_set<T, Hash, KeyEqual, Alloc, Stats>::findKey(const K& k)
+{
+   migrateStep();
+   size_t hash = hashFunction(k);
+   Bucket* pBucket;
+   auto itList = locate(k, hash, pBucket);
+   stats().found(itList != pBucket->end());
+   if (itList == pBucket->end())
+      return end();
+   return iterator(pBucket, buckets + numBuckets, itList, this);
+}
+
+/*****************************************
+ * UNORDERED SET :: BATCH
+ * Look up many keys at once. Independent lookups would each
+ * wait on a cache miss for the bucket and then another for
+ * its first node. Instead, one chunk of keys at a time:
+ *    1. hash every key and prefetch its bucket
+ *    2. prefetch the first node of every non-empty bucket
+ *    3. walk the buckets, which are now likely in cache
+ * so the misses of the whole chunk overlap.
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+template <class Resolve>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::batch(const T* keys, size_t num, Resolve resolve)
+{
+   const size_t CHUNK = 16;
+   size_t hashes[CHUNK];
+   Bucket* pBuckets[CHUNK];
+   migrateStep();
+
+   for (size_t iChunk = 0; iChunk < num; iChunk += CHUNK)
+   {
+      size_t numChunk = (num - iChunk < CHUNK) ? num - iChunk : CHUNK;
+
+      for (size_t i = 0; i < numChunk; i++)
+      {
+         hashes[i] = hashFunction(keys[iChunk + i]);
+         pBuckets[i] = home(hashes[i]);
+         prefetch(pBuckets[i]);
+      }
+
+      for (size_t i = 0; i < numChunk; i++)
+         if (!pBuckets[i]->empty())
+            prefetch(&*pBuckets[i]->begin());
+
+      for (size_t i = 0; i < numChunk; i++)
+      {
+         auto itList = findIn(pBuckets[i], keys[iChunk + i], hashes[i]);
+         stats().found(itList != pBuckets[i]->end());
+         resolve(iChunk + i, pBuckets[i], itList);
+      }
+   }
+}
+
+/*****************************************
+ * UNORDERED SET :: FIND BATCH
+ * out[i] = find(keys[i]) for every i in [0, num)
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::find_batch(const T* keys, size_t num, iterator* out)
+{
+   batch(keys, num, [this, out](size_t i, Bucket* pBucket,
+                                typename Bucket::iterator itList)
+   {
+      out[i] = (itList == pBucket->end()) ? end() :
+               iterator(pBucket, buckets + numBuckets, itList, this);
+   });
+}
+
+/*****************************************
+ * UNORDERED SET :: CONTAINS BATCH
+ * out[i] = contains(keys[i]) for every i in [0, num)
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void unordered_set<T, Hash, KeyEqual, Alloc, Stats>::contains_batch(const T* keys, size_t num, bool* out)
+{
+   batch(keys, num, [out](size_t i, Bucket* pBucket,
+                          typename Bucket::iterator itList)
+   {
+      out[i] = (itList != pBucket->end());
+   });
+}
+
+/*****************************************
+ * UNORDERED SET :: ITERATOR :: INCREMENT
+ * Advance by one element in an unordered set. During an
+ * incremental rehash the new buckets are followed by the
+ * old ones yet to be emptied. An iterator that has gone on
+ * into those is good only until its bucket is moved
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+typename unordered_set <T, Hash, KeyEqual, Alloc, Stats> ::iterator & unordered_set<T, Hash, KeyEqual, Alloc, Stats>::iterator::operator ++ ()
+{
+   // already at the end
+   if (pBucket == pBucketEnd)
+      return *this;
+
+   // more elements in the current bucket
+   ++itList;
+   if (itList != pBucket->end())
+      return *this;
+
+   // skip to the next non-empty bucket
+   for (++pBucket; ; ++pBucket)
+   {
+      if (pBucket == pBucketEnd)
+      {
+         // out of new buckets: on to the old ones, if we are not there already
+         if (pSet == nullptr || pSet->bucketsOld == nullptr ||
+             pBucketEnd == pSet->bucketsOld + pSet->numBucketsOld)
+            break;
+         pBucket    = pSet->bucketsOld + pSet->iMigrate;
+         pBucketEnd = pSet->bucketsOld + pSet->numBucketsOld;
+         if (pBucket == pBucketEnd)
+            break;
+      }
+      if (pSet != nullptr && pSet->bucketsOld != nullptr)
+      {
+         // a new bucket is built, and its old one destroyed, as the old one is emptied
+         bool inOld = pBucketEnd == pSet->bucketsOld + pSet->numBucketsOld;
+         size_t iOld = inOld ? (size_t)(pBucket - pSet->bucketsOld) :
+                               (size_t)(pBucket - pSet->buckets) % pSet->numBucketsOld;
+         if (pSet->isMigrated(iOld) == inOld)
+            continue;
+      }
+      if (!pBucket->empty())
+      {
+         itList = pBucket->begin();
+         return *this;
+      }
+   }
+
+   // end() is always past the new buckets
+   if (pSet != nullptr)
+      pBucket = pBucketEnd = pSet->buckets + pSet->numBuckets;
+   itList = typename Bucket::iterator();
+   return *this;
+}
+
+/*****************************************
+ * SWAP
+ * Stand-alone unordered set swap
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual, typename Alloc, typename Stats>
+void swap(unordered_set<T, Hash, KeyEqual, Alloc, Stats>& lhs,
+          unordered_set<T, Hash, KeyEqual, Alloc, Stats>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+/************************************************
+ * LINEAR PROBE
+ * Probing policy for flat_unordered_set. An element
+ * takes the first free slot after its home slot and
+ * keeps it until it is erased or rehashed.
+ ************************************************/
+struct linear_probe
+{
+   // a resident never gives up its slot, so a miss must walk the whole run
+   static bool yields(size_t, size_t)
+   {
+      return false;
+   }
+};
+
+/************************************************
+ * ROBIN HOOD PROBE
+ * Probing policy for flat_unordered_set. An element
+ * being inserted takes the slot of any resident that
+ * is closer to its own home than the new element is,
+ * and the resident moves on down the run. Every run
+ * stays sorted by home slot, so a miss can stop as
+ * soon as it passes a resident closer to home than it.
+ ************************************************/
+struct robin_hood_probe
+{
+   static bool yields(size_t distResident, size_t distProbe)
+   {
+      return distResident < distProbe;
+   }
+};
+
+/************************************************
+ * FLAT UNORDERED SET
+ * A set implemented as an open-addressed hash. The
+ * elements live directly in one array of slots and
+ * collisions are resolved with linear probing, so a
+ * lookup walks adjacent memory instead of chasing
+ * list nodes. Erase shifts the rest of the probe run
+ * back one slot so no tombstones are left behind.
+ * Each slot remembers how far it is from its home
+ * slot; the Probe policy decides what to do with that.
+ ************************************************/
+template <typename T, class Probe = linear_probe>
+class flat_unordered_set
+{
+   friend class ::TestHash;   // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+   flat_unordered_set() : slots(nullptr), numSlots(0), numElements(0),
+                          maxLoadFactor(0.75f)
+   {
+      allocate(DEFAULT_SLOTS);
+   }
+   flat_unordered_set(flat_unordered_set&  rhs) : slots(nullptr), numSlots(0),
+                                                  numElements(0), maxLoadFactor(0.75f)
+   {
+      *this = rhs;
+   }
+   flat_unordered_set(flat_unordered_set&& rhs) : flat_unordered_set()
+   {
+      swap(rhs);
+   }
+   template <class Iterator>
+   flat_unordered_set(Iterator first, Iterator last) : flat_unordered_set()
+   {
+      for (auto it = first; it != last; ++it)
+         insert(*it);
+   }
+  ~flat_unordered_set()
+   {
+      delete [] slots;
+   }
+
+   //
+   // Assign
+   //
+   flat_unordered_set& operator=(flat_unordered_set& rhs);
+   flat_unordered_set& operator=(flat_unordered_set&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   flat_unordered_set& operator=(const std::initializer_list<T>& il)
+   {
+      clear();
+      insert(il);
+      return *this;
+   }
+   void swap(flat_unordered_set& rhs)
+   {
+      std::swap(slots,         rhs.slots);
+      std::swap(numSlots,      rhs.numSlots);
+      std::swap(numElements,   rhs.numElements);
+      std::swap(maxLoadFactor, rhs.maxLoadFactor);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin();
+   iterator end();
+
+   //
+   // Access
+   //
+   size_t bucket(const T& t) const
+   {
+      // std::hash is the identity for integers, so keys with a stride
+      // of a power of two would share their low bits and one home slot
+      return (size_t)mix64((uint64_t)std::hash<T>()(t)) & (numSlots - 1);
+   }
+   iterator find(const T& t);
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T& t);
+   void insert(const std::initializer_list<T>& il);
+   void rehash(size_t numSlots);
+   void reserve(size_t num)
+   {
+      rehash((size_t)std::ceil((float)num / maxLoadFactor));
+   }
+
+   //
+   // Remove
+   //
+   void clear() noexcept
+   {
+      for (size_t i = 0; i < numSlots; i++)
+         if (slots[i].used)
+         {
+            slots[i].data = T();
+            slots[i].used = false;
+         }
+      numElements = 0;
+   }
+   iterator erase(const T& t);
+
+   //
+   // Status
+   //
+   size_t size() const
+   {
+      return numElements;
+   }
+   bool empty() const
+   {
+      return numElements == 0;
+   }
+   size_t bucket_count() const
+   {
+      return numSlots;
+   }
+   size_t bucket_size(size_t i) const
+   {
+      return slots[i].used ? 1 : 0;
+   }
+   float load_factor() const noexcept
+   {
+      return (float)numElements / (float)numSlots;
+   }
+   float max_load_factor() const noexcept
+   {
+      return maxLoadFactor;
+   }
+   void max_load_factor(float m)
+   {
+      // open addressing needs at least one empty slot to stop a probe
+      maxLoadFactor = m < 0.95f ? m : 0.95f;
+      if (load_factor() > maxLoadFactor)
+         rehash(0);
+   }
+   size_t max_probe_length() const;
+
+private:
+   static const size_t DEFAULT_SLOTS = 16;   // always a power of two
+
+   // an empty set of num slots, for rehash to fill
+   flat_unordered_set(size_t num, float maxLoadFactor) :
+      slots(new Slot[num]), numSlots(num), numElements(0),
+      maxLoadFactor(maxLoadFactor)
+   {
+      assert((num & (num - 1)) == 0);
+   }
+
+   // one entry in the table: the element, whether it is in use,
+   // and how many slots past its home slot it sits
+   struct Slot
+   {
+      Slot() : data(), used(false), dist(0) {}
+      T data;
+      bool used;
+      unsigned int dist;
+   };
+
+   void allocate(size_t num);
+   size_t findSlot(const T& t) const;
+   size_t place(T&& t);
+
+   Slot * slots;           // dynamically-allocated array of slots
+   size_t numSlots;        // number of slots, always a power of two
+   size_t numElements;     // number of slots in use
+   float maxLoadFactor;    // grow when numElements / numSlots exceeds this
+};
+
+/************************************************
+ * ROBIN HOOD UNORDERED SET
+ * A flat unordered set with Robin Hood probing
+ ************************************************/
 template <typename T>
-void swap(unordered_set<T>& lhs, unordered_set<T>& rhs)
+using robin_hood_unordered_set = flat_unordered_set<T, robin_hood_probe>;
+
+/************************************************
+ * FLAT UNORDERED SET ITERATOR
+ * Iterator for a flat unordered set
+ ************************************************/
+template <typename T, class Probe>
+class flat_unordered_set <T, Probe> ::iterator
+{
+   friend class ::TestHash;   // give unit tests access to the privates
+   template <class TT, class PP>
+   friend class custom::flat_unordered_set;
+public:
+   //
+   // Construct
+   //
+   iterator() : pSlot(nullptr), pSlotEnd(nullptr)
+   {
+   }
+   iterator(Slot* pSlot, Slot* pSlotEnd) : pSlot(pSlot), pSlotEnd(pSlotEnd)
+   {
+   }
+   iterator(const iterator& rhs) : pSlot(rhs.pSlot), pSlotEnd(rhs.pSlotEnd)
+   {
+   }
+
+   //
+   // Assign
+   //
+   iterator& operator = (const iterator& rhs)
+   {
+      pSlot    = rhs.pSlot;
+      pSlotEnd = rhs.pSlotEnd;
+      return *this;
+   }
+
+   //
+   // Compare
+   //
+   bool operator != (const iterator& rhs) const
+   {
+      return pSlot != rhs.pSlot;
+   }
+   bool operator == (const iterator& rhs) const
+   {
+      return pSlot == rhs.pSlot;
+   }
+
+   //
+   // Access
+   //
+   T& operator * ()
+   {
+      return pSlot->data;
+   }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ()
+   {
+      if (pSlot != pSlotEnd)
+         for (++pSlot; pSlot != pSlotEnd && !pSlot->used; ++pSlot)
+            ;
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator itReturn(*this);
+      ++(*this);
+      return itReturn;
+   }
+
+private:
+   Slot* pSlot;
+   Slot* pSlotEnd;
+};
+
+/*****************************************
+ * FLAT UNORDERED SET :: ALLOCATE
+ * Replace the slot array with num empty slots
+ ****************************************/
+template <typename T, class Probe>
+void flat_unordered_set<T, Probe>::allocate(size_t num)
+{
+   assert(num > 0 && (num & (num - 1)) == 0);
+   delete [] slots;
+   slots = new Slot[num];
+   numSlots = num;
+   numElements = 0;
+}
+
+/*****************************************
+ * FLAT UNORDERED SET :: ASSIGN
+ * Copy the slots of the rhs onto this
+ ****************************************/
+template <typename T, class Probe>
+flat_unordered_set<T, Probe>& flat_unordered_set<T, Probe>::operator=(flat_unordered_set& rhs)
+{
+   if (this != &rhs)
+   {
+      allocate(rhs.numSlots);
+      for (size_t i = 0; i < numSlots; i++)
+         slots[i] = rhs.slots[i];
+      numElements = rhs.numElements;
+      maxLoadFactor = rhs.maxLoadFactor;
+   }
+   return *this;
+}
+
+/*****************************************
+ * FLAT UNORDERED SET :: BEGIN and END
+ * The first slot in use, and one past the last slot
+ ****************************************/
+template <typename T, class Probe>
+typename flat_unordered_set <T, Probe> ::iterator flat_unordered_set<T, Probe>::begin()
+{
+   for (Slot* pSlot = slots; pSlot != slots + numSlots; pSlot++)
+      if (pSlot->used)
+         return iterator(pSlot, slots + numSlots);
+   return end();
+}
+template <typename T, class Probe>
+typename flat_unordered_set <T, Probe> ::iterator flat_unordered_set<T, Probe>::end()
+{
+   return iterator(slots + numSlots, slots + numSlots);
+}
+
+/*****************************************
+ * FLAT UNORDERED SET :: FIND SLOT
+ * Walk the probe run for t. Returns the slot holding t,
+ * or numSlots if t is not in the set
+ ****************************************/
+template <typename T, class Probe>
+size_t flat_unordered_set<T, Probe>::findSlot(const T& t) const
+{
+   size_t mask = numSlots - 1;
+   size_t i = bucket(t);
+   for (size_t dist = 0; slots[i].used; dist++)
+   {
+      if (Probe::yields(slots[i].dist, dist))
+         break;
+      if (slots[i].data == t)
+         return i;
+      i = (i + 1) & mask;
+   }
+   return numSlots;
+}
+
+/*****************************************
+ * FLAT UNORDERED SET :: PLACE
+ * Put an element known not to be in the set into its probe
+ * run, displacing residents as the Probe policy allows.
+ * Returns the slot where t itself ended up
+ ****************************************/
+template <typename T, class Probe>
+size_t flat_unordered_set<T, Probe>::place(T&& t)
+{
+   size_t mask = numSlots - 1;
+   size_t i = bucket(t);
+   size_t iPlaced = numSlots;
+   T carry(std::move(t));
+   for (unsigned int dist = 0; ; dist++, i = (i + 1) & mask)
+   {
+      if (!slots[i].used)
+      {
+         slots[i].data = std::move(carry);
+         slots[i].used = true;
+         slots[i].dist = dist;
+         return iPlaced == numSlots ? i : iPlaced;
+      }
+
+      // take the slot and carry its resident on down the run
+      if (Probe::yields(slots[i].dist, dist))
+      {
+         std::swap(carry, slots[i].data);
+         std::swap(dist, slots[i].dist);
+         if (iPlaced == numSlots)
+            iPlaced = i;
+      }
+   }
+}
+
+/*****************************************
+ * FLAT UNORDERED SET :: FIND
+ * Find an element in a flat unordered set
+ ****************************************/
+template <typename T, class Probe>
+typename flat_unordered_set <T, Probe> ::iterator flat_unordered_set<T, Probe>::find(const T& t)
+{
+   size_t i = findSlot(t);
+   return i == numSlots ? end() : iterator(slots + i, slots + numSlots);
+}
+
+/*****************************************
+ * FLAT UNORDERED SET :: INSERT
+ * Insert one element into its probe run
+ ****************************************/
+template <typename T, class Probe>
+custom::pair<typename custom::flat_unordered_set<T, Probe>::iterator, bool> flat_unordered_set<T, Probe>::insert(const T& t)
+{
+   // only one copy of each element in a set
+   size_t i = findSlot(t);
+   if (i != numSlots)
+      return custom::pair<iterator, bool>(iterator(slots + i, slots + numSlots), false);
+
+   // grow first, which moves the end of the probe run
+   if ((float)(numElements + 1) > maxLoadFactor * (float)numSlots)
+      rehash(numSlots * 2);
+
+   T copy(t);
+   i = place(std::move(copy));
+   numElements++;
+   return custom::pair<iterator, bool>(iterator(slots + i, slots + numSlots), true);
+}
+template <typename T, class Probe>
+void flat_unordered_set<T, Probe>::insert(const std::initializer_list<T>& il)
+{
+   reserve(numElements + il.size());
+   for (auto it = il.begin(); it != il.end(); ++it)
+      insert(*it);
+}
+
+/*****************************************
+ * FLAT UNORDERED SET :: REHASH
+ * Move the elements into a slot array of at least numSlots,
+ * rounded up to a power of two
+ ****************************************/
+template <typename T, class Probe>
+void flat_unordered_set<T, Probe>::rehash(size_t numSlots)
+{
+   // never go below what the max load factor allows
+   size_t numMinimum = (size_t)std::ceil((float)numElements / maxLoadFactor);
+   if (numSlots < numMinimum)
+      numSlots = numMinimum;
+   size_t numNew = 1;
+   while (numNew < numSlots)
+      numNew <<= 1;
+   if (numNew == this->numSlots)
+      return;
+
+   // every element is known to be unique; no need to compare
+   flat_unordered_set usNew(numNew, maxLoadFactor);
+   for (size_t i = 0; i < this->numSlots; i++)
+      if (slots[i].used)
+         usNew.place(std::move(slots[i].data));
+   usNew.numElements = numElements;
+   swap(usNew);
+}
+
+/*****************************************
+ * FLAT UNORDERED SET :: ERASE
+ * Remove one element, then pull later members of the probe
+ * run back into the hole so that no run is ever broken.
+ * Returns the element now occupying the erased slot, if any
+ ****************************************/
+template <typename T, class Probe>
+typename flat_unordered_set <T, Probe> ::iterator flat_unordered_set<T, Probe>::erase(const T& t)
+{
+   size_t iErase = findSlot(t);
+   if (iErase == numSlots)
+      return end();
+
+   size_t mask = numSlots - 1;
+   size_t iHole = iErase;
+   for (size_t j = (iHole + 1) & mask; slots[j].used; j = (j + 1) & mask)
+   {
+      // an element may only move back if the hole is still on its probe run
+      size_t gap = (j - iHole) & mask;
+      if (slots[j].dist >= gap)
+      {
+         slots[iHole].data = std::move(slots[j].data);
+         slots[iHole].dist = slots[j].dist - (unsigned int)gap;
+         iHole = j;
+      }
+      else if (Probe::yields(slots[j].dist, gap))
+         break;
+   }
+   slots[iHole].data = T();
+   slots[iHole].used = false;
+   slots[iHole].dist = 0;
+   numElements--;
+
+   iterator itNext(slots + iErase, slots + numSlots);
+   if (!slots[iErase].used)
+      ++itNext;
+   return itNext;
+}
+
+/*****************************************
+ * FLAT UNORDERED SET :: MAX PROBE LENGTH
+ * The most slots any lookup of an element in the set has to
+ * visit. This walks every slot, so it costs O(bucket_count())
+ ****************************************/
+template <typename T, class Probe>
+size_t flat_unordered_set<T, Probe>::max_probe_length() const
+{
+   size_t numMax = 0;
+   for (size_t i = 0; i < numSlots; i++)
+      if (slots[i].used && slots[i].dist + 1 > numMax)
+         numMax = slots[i].dist + 1;
+   return numMax;
+}
+
+/*****************************************
+ * SWAP
+ * Stand-alone flat unordered set swap
+ ****************************************/
+template <typename T, class Probe>
+void swap(flat_unordered_set<T, Probe>& lhs, flat_unordered_set<T, Probe>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+namespace pmr
 {
+   // an unordered_set whose buckets and nodes come from a
+   // std::pmr::memory_resource, such as a per-request arena
+   template <typename T,
+             typename Hash = std::hash<T>,
+             typename KeyEqual = std::equal_to<T> >
+   using unordered_set = custom::unordered_set<T, Hash, KeyEqual, std::pmr::polymorphic_allocator<T>>;
 }
+#endif
 
 }
@@ -0,0 +1,251 @@
+/***********************************************************************
+ * Header:
+ *    HASHERS
+ * Summary:
+ *    Fast, well-mixed hashers to pass as the Hash argument of our
+ *    sets. std::hash hands an integer back unchanged, so keys with a
+ *    pattern in them (multiples of 10, aligned addresses) pile into
+ *    a few buckets; these scramble every key bit into every hash bit.
+ *        custom::unordered_set<size_t, custom::fast_hash> ids;
+ *        custom::unordered_set<std::string, custom::seeded_hash> names;
+ *
+ *    This will contain the definitions of:
+ *        mix64       : Finalizer for one 64-bit value
+ *        hash_bytes  : Hash of a run of bytes
+ *        fast_hash   : Hasher for integers and strings
+ *        seeded_hash : The same, keyed with a per-process random seed
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include <string>      // for std::string
+#include <cstring>     // for std::memcpy and std::strlen
+#include <cstdint>     // for uint64_t
+#include <cstddef>     // for size_t
+#include <random>      // for std::random_device
+#include <type_traits> // for std::enable_if
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>    // for _umul128
+#endif
+
+namespace custom
+{
+
+/************************************************
+ * MIX 64
+ * A multiply-xorshift finalizer (Stafford's variant 13,
+ * the one splitmix64 ends with). Every input bit flips
+ * each output bit about half the time, and distinct
+ * inputs always give distinct outputs. It is constexpr
+ * so tables can be hashed at compile time
+ ************************************************/
+constexpr uint64_t mix64(uint64_t x)
+{
+   x ^= x >> 30;
+   x *= 0xBF58476D1CE4E5B9ull;
+   x ^= x >> 27;
+   x *= 0x94D049BB133111EBull;
+   return x ^ (x >> 31);
+}
+
+/************************************************
+ * MULTIPLY MIX
+ * The full 128-bit product of a and b, folded in half
+ * with an xor. The core step of hash_bytes
+ ************************************************/
+inline uint64_t multiplyMix(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+   __uint128_t product = (__uint128_t)a * b;
+   return (uint64_t)product ^ (uint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+   uint64_t high;
+   uint64_t low = _umul128(a, b, &high);
+   return low ^ high;
+#else
+   // four 32 x 32 products, as a compiler without 128-bit math would
+   uint64_t aLow = (uint32_t)a, aHigh = a >> 32;
+   uint64_t bLow = (uint32_t)b, bHigh = b >> 32;
+   uint64_t ll = aLow * bLow,  lh = aLow * bHigh;
+   uint64_t hl = aHigh * bLow, hh = aHigh * bHigh;
+   uint64_t middle = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+   uint64_t low = (middle << 32) | (uint32_t)ll;
+   uint64_t high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+   return low ^ high;
+#endif
+}
+
+/************************************************
+ * READ 8 / READ 4
+ * An unaligned little-endian load. memcpy compiles to a
+ * single mov on every compiler we build with
+ ************************************************/
+inline uint64_t read8(const unsigned char* p)
+{
+   uint64_t v;
+   std::memcpy(&v, p, sizeof(v));
+   return v;
+}
+inline uint64_t read4(const unsigned char* p)
+{
+   uint32_t v;
+   std::memcpy(&v, p, sizeof(v));
+   return v;
+}
+
+/************************************************
+ * HASH BYTES
+ * Hash num bytes starting at pData, after wyhash. Long
+ * inputs stream through three independent 64-bit lanes,
+ * 48 bytes a pass, so the multiplies overlap. Whatever is
+ * left, 1 to 16 bytes, is read with two word loads that
+ * may overlap rather than a byte at a time, so short keys
+ * take no loop and no branch per byte. Results depend on
+ * byte order; do not store them
+ ************************************************/
+inline uint64_t hash_bytes(const void* pData, size_t num, uint64_t seed = 0)
+{
+   const uint64_t P0 = 0xA0761D6478BD642Full;
+   const uint64_t P1 = 0xE7037ED1A0B428DBull;
+   const uint64_t P2 = 0x8EBC6AF09C88C6E3ull;
+   const uint64_t P3 = 0x589965CC75374CC3ull;
+   const unsigned char* p = (const unsigned char*)pData;
+
+   seed ^= P0;
+   uint64_t a;
+   uint64_t b;
+   if (num <= 16)
+   {
+      if (num >= 4)
+      {
+         // 4..16 bytes: the first and last 4, and the 4 at each quarter
+         size_t quarter = (num >> 3) << 2;
+         a = (read4(p) << 32) | read4(p + quarter);
+         b = (read4(p + num - 4) << 32) | read4(p + num - 4 - quarter);
+      }
+      else if (num > 0)
+      {
+         // 1..3 bytes: first, middle and last, some of them the same byte
+         a = ((uint64_t)p[0] << 16) | ((uint64_t)p[num >> 1] << 8) | p[num - 1];
+         b = 0;
+      }
+      else
+         a = b = 0;
+   }
+   else
+   {
+      size_t i = num;
+      if (i > 48)
+      {
+         uint64_t seed1 = seed;
+         uint64_t seed2 = seed;
+         do
+         {
+            seed  = multiplyMix(read8(p)      ^ P1, read8(p + 8)  ^ seed);
+            seed1 = multiplyMix(read8(p + 16) ^ P2, read8(p + 24) ^ seed1);
+            seed2 = multiplyMix(read8(p + 32) ^ P3, read8(p + 40) ^ seed2);
+            p += 48;
+            i -= 48;
+         }
+         while (i > 48);
+         seed ^= seed1 ^ seed2;
+      }
+      while (i > 16)
+      {
+         seed = multiplyMix(read8(p) ^ P1, read8(p + 8) ^ seed);
+         p += 16;
+         i -= 16;
+      }
+      // the last 16 bytes, reaching back over ones already mixed
+      a = read8(p + i - 16);
+      b = read8(p + i - 8);
+   }
+
+   a ^= P1;
+   b ^= seed;
+   return multiplyMix(P0 ^ num, multiplyMix(a, b) ^ P1);
+}
+
+/************************************************
+ * FAST HASH
+ * Hasher for any integer, enum, std::string or C
+ * string. It is transparent, so with std::equal_to<>
+ * a set of std::string can be searched with a
+ * const char* without building a std::string
+ ************************************************/
+struct fast_hash
+{
+   typedef void is_transparent;
+
+   template <class I, typename std::enable_if<std::is_integral<I>::value ||
+                                              std::is_enum<I>::value, int>::type = 0>
+   size_t operator()(I i) const
+   {
+      return (size_t)mix64((uint64_t)i);
+   }
+   size_t operator()(const std::string& s) const
+   {
+      return (size_t)hash_bytes(s.data(), s.size());
+   }
+   size_t operator()(const char* s) const
+   {
+      return (size_t)hash_bytes(s, std::strlen(s));
+   }
+};
+
+/************************************************
+ * SEEDED HASH
+ * fast_hash keyed with a seed. Anyone who can pick our
+ * keys can also work out keys that all collide under an
+ * unkeyed hash, and turn every lookup into a walk of one
+ * long chain. A seed they cannot see stops that. By
+ * default every seeded_hash in the process shares one
+ * seed drawn at random on first use; two sets that must
+ * agree on hashes must share a seed
+ ************************************************/
+class seeded_hash
+{
+public:
+   typedef void is_transparent;
+
+   seeded_hash() : seed(processSeed()) {}
+   explicit seeded_hash(uint64_t seed) : seed(seed) {}
+
+   template <class I, typename std::enable_if<std::is_integral<I>::value ||
+                                              std::is_enum<I>::value, int>::type = 0>
+   size_t operator()(I i) const
+   {
+      // mixing the seed in both before and after keeps collisions secret
+      return (size_t)mix64(mix64((uint64_t)i ^ seed) + seed);
+   }
+   size_t operator()(const std::string& s) const
+   {
+      return (size_t)hash_bytes(s.data(), s.size(), seed);
+   }
+   size_t operator()(const char* s) const
+   {
+      return (size_t)hash_bytes(s, std::strlen(s), seed);
+   }
+
+   uint64_t get_seed() const
+   {
+      return seed;
+   }
+
+private:
+   static uint64_t processSeed()
+   {
+      static const uint64_t seed = []()
+      {
+         std::random_device random;
+         return ((uint64_t)random() << 32) ^ (uint64_t)random();
+      }();
+      return seed;
+   }
+
+   uint64_t seed;
+};
+
+} // namespace custom
@@ -0,0 +1,626 @@
+/***********************************************************************
+ * Header:
+ *    INTRUSIVE
+ * Summary:
+ *    Containers that hold objects without owning them. list copies
+ *    each element into a node it allocates; here the links live in
+ *    the object itself, in a list_hook member, so putting an object
+ *    in a list or a set allocates nothing and copies nothing, and an
+ *    object can be taken out in O(1) given only a reference to it:
+ *        struct Job
+ *        {
+ *           int id;
+ *           custom::list_hook hook;
+ *        };
+ *        custom::intrusive_list<Job, &Job::hook> ready;
+ *        ready.push_back(job);       // links job in
+ *        ready.erase(job);           // and out again
+ *
+ *    The containers never create or destroy an object. The owner
+ *    must keep each object alive for as long as it is in one, and an
+ *    object with one hook can be in only one container at a time.
+ *
+ *    This will contain the class definitions of:
+ *        list_hook              : The links an object carries
+ *        intrusive_list         : A list of objects linked by a hook
+ *        intrusive_unordered_set: A hash whose bucket chains are
+ *                                 intrusive lists
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"       // for custom::pair
+#include <functional>   // for std::hash and std::equal_to
+#include <utility>      // for std::swap
+#include <cstddef>      // for size_t and ptrdiff_t
+#include <cassert>
+
+class TestIntrusive;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * LIST HOOK
+ * The two links an object needs to be in an intrusive
+ * container. Copying an object does not copy where it
+ * is linked: the copy starts out in no container
+ ************************************************/
+struct list_hook
+{
+   list_hook() : pNext(nullptr), pPrev(nullptr) {}
+   list_hook(const list_hook&) : pNext(nullptr), pPrev(nullptr) {}
+   list_hook& operator=(const list_hook&) { return *this; }
+   ~list_hook()
+   {
+      // an object must leave its container before it dies
+      assert(!is_linked());
+   }
+
+   bool is_linked() const
+   {
+      return pNext != nullptr;
+   }
+
+   list_hook* pNext;
+   list_hook* pPrev;
+};
+
+/************************************************
+ * INTRUSIVE LIST
+ * A doubly linked list of T, linked through the hook
+ * member given. The links form a ring through a hook
+ * inside the list itself, so no link is ever nullptr
+ * and linking or unlinking never tests for an end
+ ************************************************/
+template <class T, list_hook T::*Hook>
+class intrusive_list
+{
+   friend class ::TestIntrusive;   // give unit tests access to the privates
+
+public:
+   //
+   // Construct
+   //
+   intrusive_list() : numElements(0)
+   {
+      root.pNext = root.pPrev = &root;
+   }
+   intrusive_list(const intrusive_list&) = delete;
+   intrusive_list(intrusive_list&& rhs) : intrusive_list()
+   {
+      swap(rhs);
+   }
+   ~intrusive_list()
+   {
+      clear();
+      root.pNext = root.pPrev = nullptr;
+   }
+
+   //
+   // Assign
+   //
+   intrusive_list& operator=(const intrusive_list&) = delete;
+   intrusive_list& operator=(intrusive_list&& rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         swap(rhs);
+      }
+      return *this;
+   }
+   void swap(intrusive_list& rhs)
+   {
+      std::swap(root.pNext, rhs.root.pNext);
+      std::swap(root.pPrev, rhs.root.pPrev);
+      std::swap(numElements, rhs.numElements);
+      repairRoot();
+      rhs.repairRoot();
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() { return iterator(root.pNext); }
+   iterator end()   { return iterator(&root);      }
+   iterator iterator_to(T& t)
+   {
+      assert((t.*Hook).is_linked());
+      return iterator(&(t.*Hook));
+   }
+
+   //
+   // Access
+   //
+   T& front();
+   T& back();
+
+   //
+   // Insert
+   //
+   void push_front(T& t) { link(root.pNext, t.*Hook); }
+   void push_back(T& t)  { link(&root, t.*Hook);      }
+   iterator insert(iterator it, T& t)
+   {
+      link(it.p, t.*Hook);
+      return iterator(&(t.*Hook));
+   }
+
+   //
+   // Remove
+   //
+   void pop_front();
+   void pop_back();
+   iterator erase(iterator it);
+   iterator erase(T& t)  { return erase(iterator_to(t)); }
+   void clear();
+
+   //
+   // Status
+   //
+   size_t size() const { return numElements; }
+   bool empty() const  { return numElements == 0; }
+
+   // the object a hook is in
+   static T& owner(list_hook& hook);
+
+private:
+   void link(list_hook* pNext, list_hook& hook);
+   void unlink(list_hook& hook);
+   void repairRoot();
+
+   list_hook root;     // pNext is the first hook, pPrev the last
+   size_t numElements; // objects linked in
+};
+
+/*************************************************
+ * INTRUSIVE LIST :: ITERATOR
+ * A hook in the ring. The end is the list's own
+ *************************************************/
+template <class T, list_hook T::*Hook>
+class intrusive_list <T, Hook> :: iterator
+{
+   friend class ::TestIntrusive;   // give unit tests access to the privates
+   friend class custom::intrusive_list<T, Hook>;
+public:
+   iterator(list_hook* p = nullptr) : p(p) {}
+
+   bool operator==(const iterator& rhs) const { return p == rhs.p; }
+   bool operator!=(const iterator& rhs) const { return p != rhs.p; }
+
+   T& operator*()  { return owner(*p);  }
+   T* operator->() { return &owner(*p); }
+
+   // Prefix increment
+   iterator& operator++()
+   {
+      p = p->pNext;
+      return *this;
+   }
+
+   // Postfix increment
+   iterator operator++(int)
+   {
+      iterator tmp(*this);
+      p = p->pNext;
+      return tmp;
+   }
+
+   // Prefix decrement
+   iterator& operator--()
+   {
+      p = p->pPrev;
+      return *this;
+   }
+
+   // Postfix decrement
+   iterator operator--(int)
+   {
+      iterator tmp(*this);
+      p = p->pPrev;
+      return tmp;
+   }
+
+private:
+   list_hook* p;
+};
+
+/*****************************************
+ * INTRUSIVE LIST :: OWNER
+ * Step back from a hook to the start of the object it
+ * is a member of. The offset of the member is found
+ * once from storage that is never built into a T
+ ****************************************/
+template <class T, list_hook T::*Hook>
+T& intrusive_list<T, Hook>::owner(list_hook& hook)
+{
+   alignas(T) static char probe[sizeof(T)];
+   static const std::ptrdiff_t offset =
+      reinterpret_cast<char*>(&(reinterpret_cast<T*>(probe)->*Hook)) - probe;
+   return *reinterpret_cast<T*>(reinterpret_cast<char*>(&hook) - offset);
+}
+
+/*****************************************
+ * INTRUSIVE LIST :: FRONT / BACK
+ ****************************************/
+template <class T, list_hook T::*Hook>
+T& intrusive_list<T, Hook>::front()
+{
+   if (empty())
+      throw "ERROR: unable to access data from an empty list";
+   return owner(*root.pNext);
+}
+
+template <class T, list_hook T::*Hook>
+T& intrusive_list<T, Hook>::back()
+{
+   if (empty())
+      throw "ERROR: unable to access data from an empty list";
+   return owner(*root.pPrev);
+}
+
+/*****************************************
+ * INTRUSIVE LIST :: POP FRONT / POP BACK
+ ****************************************/
+template <class T, list_hook T::*Hook>
+void intrusive_list<T, Hook>::pop_front()
+{
+   if (numElements)
+      unlink(*root.pNext);
+}
+
+template <class T, list_hook T::*Hook>
+void intrusive_list<T, Hook>::pop_back()
+{
+   if (numElements)
+      unlink(*root.pPrev);
+}
+
+/*****************************************
+ * INTRUSIVE LIST :: ERASE
+ * Unlink the object at it. It is not destroyed.
+ * Return the one after it
+ ****************************************/
+template <class T, list_hook T::*Hook>
+typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::erase(iterator it)
+{
+   assert(it.p != &root);
+   list_hook* pNext = it.p->pNext;
+   unlink(*it.p);
+   return iterator(pNext);
+}
+
+/*****************************************
+ * INTRUSIVE LIST :: CLEAR
+ * Unlink every object, leaving each free to join
+ * another container
+ ****************************************/
+template <class T, list_hook T::*Hook>
+void intrusive_list<T, Hook>::clear()
+{
+   list_hook* p = root.pNext;
+   while (p != &root)
+   {
+      list_hook* pNext = p->pNext;
+      p->pNext = p->pPrev = nullptr;
+      p = pNext;
+   }
+   root.pNext = root.pPrev = &root;
+   numElements = 0;
+}
+
+/*****************************************
+ * INTRUSIVE LIST :: LINK
+ * Link hook in just before pNext
+ ****************************************/
+template <class T, list_hook T::*Hook>
+void intrusive_list<T, Hook>::link(list_hook* pNext, list_hook& hook)
+{
+   assert(!hook.is_linked());
+   hook.pNext = pNext;
+   hook.pPrev = pNext->pPrev;
+   pNext->pPrev->pNext = &hook;
+   pNext->pPrev = &hook;
+   numElements++;
+}
+
+/*****************************************
+ * INTRUSIVE LIST :: UNLINK
+ * Close the ring around hook and mark it free
+ ****************************************/
+template <class T, list_hook T::*Hook>
+void intrusive_list<T, Hook>::unlink(list_hook& hook)
+{
+   assert(hook.is_linked());
+   hook.pPrev->pNext = hook.pNext;
+   hook.pNext->pPrev = hook.pPrev;
+   hook.pNext = hook.pPrev = nullptr;
+   numElements--;
+}
+
+/*****************************************
+ * INTRUSIVE LIST :: REPAIR ROOT
+ * After a swap the end hooks still point at the
+ * other list's root. Point them at ours
+ ****************************************/
+template <class T, list_hook T::*Hook>
+void intrusive_list<T, Hook>::repairRoot()
+{
+   if (numElements == 0)
+      root.pNext = root.pPrev = &root;
+   else
+   {
+      root.pNext->pPrev = &root;
+      root.pPrev->pNext = &root;
+   }
+}
+
+/************************************************
+ * INTRUSIVE UNORDERED SET
+ * A chained hash whose buckets are intrusive lists, so
+ * an insert or erase is only relinking and a rehash
+ * moves no element. Like unordered_set, the elements
+ * may not be changed in a way that changes their hash
+ * while they are in the set
+ ************************************************/
+template <class T,
+          list_hook T::*Hook,
+          class Hash = std::hash<T>,
+          class KeyEqual = std::equal_to<T> >
+class intrusive_unordered_set
+{
+   friend class ::TestIntrusive;   // give unit tests access to the privates
+
+public:
+   typedef intrusive_list<T, Hook> Bucket;
+
+   //
+   // Construct
+   //
+   intrusive_unordered_set(size_t numBuckets = DEFAULT_BUCKETS,
+                           const Hash& hash = Hash(),
+                           const KeyEqual& equal = KeyEqual()) :
+      buckets(new Bucket[numBuckets ? numBuckets : 1]),
+      numBuckets(numBuckets ? numBuckets : 1), numElements(0),
+      maxLoadFactor(1.0), hashFunction(hash), keyEqual(equal)
+   {
+   }
+   intrusive_unordered_set(const intrusive_unordered_set&) = delete;
+   intrusive_unordered_set& operator=(const intrusive_unordered_set&) = delete;
+   ~intrusive_unordered_set()
+   {
+      delete [] buckets;
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin();
+   iterator end()
+   {
+      return iterator(buckets + numBuckets, buckets + numBuckets, typename Bucket::iterator());
+   }
+
+   //
+   // Access
+   //
+   iterator find(const T& t);
+   bool contains(const T& t)
+   {
+      return find(t) != end();
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(T& t);
+
+   //
+   // Remove
+   //
+   iterator erase(iterator it);
+   void erase(T& t);
+   void clear();
+
+   //
+   // Status
+   //
+   size_t size() const         { return numElements;             }
+   bool empty() const          { return numElements == 0;        }
+   size_t bucket_count() const { return numBuckets;              }
+   size_t bucket_size(size_t i) const { return buckets[i].size(); }
+   float max_load_factor() const      { return maxLoadFactor;     }
+   void max_load_factor(float m)      { maxLoadFactor = m;        }
+   void rehash(size_t numBucketsNew);
+
+private:
+   static const size_t DEFAULT_BUCKETS = 10;
+
+   Bucket* bucketOf(const T& t)
+   {
+      return buckets + hashFunction(t) % numBuckets;
+   }
+
+   Bucket* buckets;        // each chain, linked through the elements
+   size_t numBuckets;      // number of buckets in the array
+   size_t numElements;     // number of elements linked in
+   float maxLoadFactor;    // grow when numElements / numBuckets exceeds this
+   Hash hashFunction;      // turns an element into a size_t
+   KeyEqual keyEqual;      // are two elements the same?
+};
+
+/*************************************************
+ * INTRUSIVE UNORDERED SET :: ITERATOR
+ * A bucket and a place in its chain
+ *************************************************/
+template <class T, list_hook T::*Hook, class Hash, class KeyEqual>
+class intrusive_unordered_set <T, Hook, Hash, KeyEqual> :: iterator
+{
+   friend class ::TestIntrusive;   // give unit tests access to the privates
+   friend class custom::intrusive_unordered_set<T, Hook, Hash, KeyEqual>;
+public:
+   iterator() : pBucket(nullptr), pBucketEnd(nullptr), itList() {}
+   iterator(Bucket* pBucket, Bucket* pBucketEnd, typename Bucket::iterator itList) :
+      pBucket(pBucket), pBucketEnd(pBucketEnd), itList(itList) {}
+
+   bool operator==(const iterator& rhs) const
+   {
+      return pBucket == rhs.pBucket && itList == rhs.itList;
+   }
+   bool operator!=(const iterator& rhs) const
+   {
+      return !(*this == rhs);
+   }
+
+   T& operator*()  { return *itList;  }
+   T* operator->() { return &*itList; }
+
+   // Prefix increment
+   iterator& operator++()
+   {
+      if (++itList == pBucket->end())
+         skipEmpty(pBucket + 1);
+      return *this;
+   }
+
+   // Postfix increment
+   iterator operator++(int)
+   {
+      iterator tmp(*this);
+      ++(*this);
+      return tmp;
+   }
+
+private:
+   // move to the first element of the first non-empty bucket from p on
+   void skipEmpty(Bucket* p)
+   {
+      while (p != pBucketEnd && p->empty())
+         p++;
+      pBucket = p;
+      itList = (p == pBucketEnd) ? typename Bucket::iterator() : p->begin();
+   }
+
+   Bucket* pBucket;
+   Bucket* pBucketEnd;
+   typename Bucket::iterator itList;
+};
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: BEGIN
+ ****************************************/
+template <class T, list_hook T::*Hook, class Hash, class KeyEqual>
+typename intrusive_unordered_set<T, Hook, Hash, KeyEqual>::iterator
+intrusive_unordered_set<T, Hook, Hash, KeyEqual>::begin()
+{
+   iterator it(buckets, buckets + numBuckets, typename Bucket::iterator());
+   it.skipEmpty(buckets);
+   return it;
+}
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: FIND
+ * Walk the one chain t would be in
+ ****************************************/
+template <class T, list_hook T::*Hook, class Hash, class KeyEqual>
+typename intrusive_unordered_set<T, Hook, Hash, KeyEqual>::iterator
+intrusive_unordered_set<T, Hook, Hash, KeyEqual>::find(const T& t)
+{
+   Bucket* pBucket = bucketOf(t);
+   for (auto it = pBucket->begin(); it != pBucket->end(); ++it)
+      if (keyEqual(*it, t))
+         return iterator(pBucket, buckets + numBuckets, it);
+   return end();
+}
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: INSERT
+ * Link t in unless an equal element is already here.
+ * Nothing is allocated unless the buckets must grow
+ ****************************************/
+template <class T, list_hook T::*Hook, class Hash, class KeyEqual>
+custom::pair<typename intrusive_unordered_set<T, Hook, Hash, KeyEqual>::iterator, bool>
+intrusive_unordered_set<T, Hook, Hash, KeyEqual>::insert(T& t)
+{
+   iterator it = find(t);
+   if (it != end())
+      return custom::pair<iterator, bool>(it, false);
+
+   if ((float)(numElements + 1) > maxLoadFactor * (float)numBuckets)
+      rehash(numBuckets * 2);
+
+   Bucket* pBucket = bucketOf(t);
+   pBucket->push_back(t);
+   numElements++;
+   return custom::pair<iterator, bool>(
+      iterator(pBucket, buckets + numBuckets, pBucket->iterator_to(t)), true);
+}
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: ERASE
+ * Unlink an element. Neither is ever destroyed
+ ****************************************/
+template <class T, list_hook T::*Hook, class Hash, class KeyEqual>
+typename intrusive_unordered_set<T, Hook, Hash, KeyEqual>::iterator
+intrusive_unordered_set<T, Hook, Hash, KeyEqual>::erase(iterator it)
+{
+   iterator itNext = it;
+   ++itNext;
+   it.pBucket->erase(it.itList);
+   numElements--;
+   return itNext;
+}
+
+template <class T, list_hook T::*Hook, class Hash, class KeyEqual>
+void intrusive_unordered_set<T, Hook, Hash, KeyEqual>::erase(T& t)
+{
+   bucketOf(t)->erase(t);
+   numElements--;
+}
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: CLEAR
+ ****************************************/
+template <class T, list_hook T::*Hook, class Hash, class KeyEqual>
+void intrusive_unordered_set<T, Hook, Hash, KeyEqual>::clear()
+{
+   for (size_t i = 0; i < numBuckets; i++)
+      buckets[i].clear();
+   numElements = 0;
+}
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: REHASH
+ * Relink every element into a new bucket array. The
+ * elements stay where they are
+ ****************************************/
+template <class T, list_hook T::*Hook, class Hash, class KeyEqual>
+void intrusive_unordered_set<T, Hook, Hash, KeyEqual>::rehash(size_t numBucketsNew)
+{
+   size_t numMinimum = (size_t)((float)numElements / maxLoadFactor);
+   if (numBucketsNew < numMinimum)
+      numBucketsNew = numMinimum;
+   if (numBucketsNew == 0)
+      numBucketsNew = 1;
+   if (numBucketsNew == numBuckets)
+      return;
+
+   Bucket* bucketsNew = new Bucket[numBucketsNew];
+   for (size_t i = 0; i < numBuckets; i++)
+      while (!buckets[i].empty())
+      {
+         T& t = buckets[i].front();
+         buckets[i].pop_front();
+         bucketsNew[hashFunction(t) % numBucketsNew].push_back(t);
+      }
+   delete [] buckets;
+   buckets = bucketsNew;
+   numBuckets = numBucketsNew;
+}
+
+} // namespace custom
@@ -22,7 +22,13 @@
 #include <cassert>     // for ASSERT
 #include <iostream>    // for nullptr
 #include <new>         // std::bad_alloc
-#include <memory>      // for std::allocator
+#include <memory>      // for std::allocator and std::allocator_traits
+#include <utility>     // for std::forward and std::move
+#include <type_traits> // for std::integral_constant
+#include <functional>  // for std::less and std::equal_to
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <memory_resource> // for std::pmr::polymorphic_allocator
+#endif
  
 class TestList;        // forward declaration for unit tests
 class TestHash;        // to be used later
@@ -30,41 +36,77 @@ class TestHash;        // to be used later
 namespace custom
 {
 
+/*************************************************
+ * NODE
+ * the node class.  Since we do not validate any
+ * of the setters, there is no point in making them
+ * private.  This is the case because only the
+ * List class can make validation decisions. It lives
+ * outside the list so the list can inherit from an
+ * allocator of nodes
+ *************************************************/
+template <typename T>
+class list_node
+{
+public:
+    // Construct: the data is built right here from whatever it is built from
+    template <class... Args>
+    list_node(Args&&... args) : data(std::forward<Args>(args)...), pNext(nullptr), pPrev(nullptr) {}
+    
+    // Data
+    T data;
+    list_node* pNext;
+    list_node* pPrev;
+};
+
 /**************************************************
  * LIST
- * Just like std::list
+ * Just like std::list. Every node comes from the
+ * allocator A, rebound to the node type. The list
+ * inherits from that rebound allocator rather than
+ * holding a copy, so an empty allocator such as
+ * std::allocator takes no room in the list, nor in
+ * every bucket built from one, and a node is made
+ * without making an allocator first
  **************************************************/
-template <typename T>
-class list
+template <typename T, typename A = std::allocator<T> >
+class list : private std::allocator_traits<A>::template rebind_alloc<list_node<T> >
 {
    friend class ::TestList; // give unit tests access to the privates
    friend class ::TestHash;
    friend void swap(list& lhs, list& rhs);
 public:  
+   typedef T value_type;
+   typedef A allocator_type;
+
    // 
    // Construct
    //
 
    list();
-   list(list <T> & rhs);
-   list(list <T>&& rhs);
-   list(size_t num, const T & t);
-   list(size_t num);
-   list(const std::initializer_list<T>& il);
+   explicit list(const A& alloc);
+   list(list <T, A> & rhs);
+   list(list <T, A> & rhs, const A& alloc);
+   list(list <T, A>&& rhs);
+   list(list <T, A>&& rhs, const A& alloc);
+   list(size_t num, const T & t, const A& alloc = A());
+   list(size_t num, const A& alloc = A());
+   list(const std::initializer_list<T>& il, const A& alloc = A());
    template <class Iterator>
-   list(Iterator first, Iterator last);
+   list(Iterator first, Iterator last, const A& alloc = A());
   ~list() 
    {
+      clear();
    }
 
    // 
    // Assign
    //
 
-   list <T> & operator = (list &  rhs);
-   list <T> & operator = (list && rhs);
-   list <T> & operator = (const std::initializer_list<T>& il);
-   void swap(list <T>& rhs);
+   list <T, A> & operator = (list &  rhs);
+   list <T, A> & operator = (list && rhs);
+   list <T, A> & operator = (const std::initializer_list<T>& il);
+   void swap(list <T, A>& rhs);
 
    //
    // Iterator
@@ -92,6 +134,12 @@ public:
    void push_back (      T&& data);
    iterator insert(iterator it, const T& data);
    iterator insert(iterator it, T&& data);
+   template <class... Args>
+   T& emplace_front(Args&&... args);
+   template <class... Args>
+   T& emplace_back(Args&&... args);
+   template <class... Args>
+   iterator emplace(iterator it, Args&&... args);
 
    //
    // Remove
@@ -102,17 +150,71 @@ public:
    void clear();
    iterator erase(const iterator& it);
 
+   //
+   // Relink
+   //
+
+   void splice(iterator pos, list <T, A>& rhs);
+   void splice(iterator pos, list <T, A>& rhs, iterator it);
+   void splice(iterator pos, list <T, A>& rhs, iterator first, iterator last);
+   void merge(list <T, A>& rhs)      { merge(rhs, std::less<T>());    }
+   template <class Compare>
+   void merge(list <T, A>& rhs, Compare comp);
+   void sort()                       { sort(std::less<T>());          }
+   template <class Compare>
+   void sort(Compare comp);
+   size_t unique()                   { return unique(std::equal_to<T>()); }
+   template <class BinaryPredicate>
+   size_t unique(BinaryPredicate equal);
+   template <class Predicate>
+   size_t remove_if(Predicate pred);
+   void reverse();
+
    // 
    // Status
    //
 
     bool empty()  const { return numElements == 0; }
     size_t size() const { return numElements;   }
+    A get_allocator() const { return A(allocator()); }
 
 
 private:
-   // nested linked list class
-   class Node;
+   // linked list node
+   typedef list_node<T> Node;
+
+   // the allocator for nodes, and what it can do
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+   typedef std::allocator_traits<NodeAlloc> NodeTraits;
+   static_assert(std::is_same<typename NodeTraits::pointer, Node*>::value,
+                 "custom::list needs an allocator that hands out plain pointers");
+
+   NodeAlloc& allocator()             { return *this; }
+   const NodeAlloc& allocator() const { return *this; }
+
+   template <class... Args>
+   Node* newNode(Args&&... args);
+   void deleteNode(Node* pNode);
+   void unhook(Node* pFirst, Node* pLast);
+   void hook(Node* pNext, Node* pFirst, Node* pLast);
+   template <class Compare>
+   static Node* mergeRuns(Node* pLeft, Node* pRight, Compare& comp);
+
+   // what the propagate_on_container_* traits of A tell us to do
+   void copyAllocator(const list& rhs, std::true_type)  { allocator() = rhs.allocator(); }
+   void copyAllocator(const list&, std::false_type) {}
+   void moveAllocator(list& rhs, std::true_type)  { allocator() = std::move(rhs.allocator()); }
+   void moveAllocator(list&, std::false_type) {}
+   void swapAllocator(list& rhs, std::true_type)
+   {
+      using std::swap;
+      swap(allocator(), rhs.allocator());
+   }
+   void swapAllocator(list& rhs, std::false_type)
+   {
+      // without propagation only equal allocators may trade nodes
+      assert(allocator() == rhs.allocator());
+   }
 
    // member variables
    size_t numElements; // though we could count, it is faster to keep a variable
@@ -120,38 +222,16 @@ private:
    Node * pTail;    // pointer to the ending of the list
 };
 
-/*************************************************
- * NODE
- * the node class.  Since we do not validate any
- * of the setters, there is no point in making them
- * private.  This is the case because only the
- * List class can make validation decisions
- *************************************************/
-template <typename T>
-class list <T> :: Node
-{
-public:
-    // Construct
-    Node() : data(0), pNext(nullptr), pPrev(nullptr) {}
-    Node(const int& data) : data(data), pNext(nullptr), pPrev(nullptr) {}
-    Node(int&& data) : data(std::move(data)), pNext(nullptr), pPrev(nullptr) {}
-    
-    // Data
-    int data;
-    Node* pNext;
-    Node* pPrev;
-};
-
 /*************************************************
  * LIST ITERATOR
  * Iterate through a List, non-constant version
  ************************************************/
-template <typename T>
-class list <T> :: iterator
+template <typename T, typename A>
+class list <T, A> :: iterator
 {
    friend class ::TestList; // give unit tests access to the privates
    friend class ::TestHash;
-   template <typename TT>
+   template <typename TT, typename AA>
    friend class custom::list;
 public:
     iterator(Node* p = nullptr) : p(p) {}
@@ -166,7 +246,7 @@ public:
     bool operator==(const iterator& rhs) const { return p == rhs.p; }
     bool operator!=(const iterator& rhs) const { return p != rhs.p; }
     
-    int& operator*() { return p->data; }
+    T& operator*() { return p->data; }
     
     // Prefix increment
     iterator& operator++()
@@ -206,21 +286,21 @@ public:
  * LIST :: NON-DEFAULT constructors
  * Create a list initialized to a value
  ****************************************/
-template <typename T>
-list <T> ::list(size_t num, const T & t) 
+template <typename T, typename A>
+list <T, A> ::list(size_t num, const T & t, const A& alloc) : NodeAlloc(alloc)
 {
    //make sure its not an empty list
    if (num > 0)
    {
       numElements = num;
-      pHead = pTail = new Node(t);
+      pHead = pTail = newNode(t);
       // set pHead pNext to pTail
       if (num > 1)
          pHead->pNext = pTail;
       //add all the other nodes
       for (size_t i = 1; i < num; i++)
       {
-         Node* pNew = new Node(t);
+         Node* pNew = newNode(t);
          pTail->pNext = pNew;
          pNew->pPrev = pTail;
          pTail = pNew;
@@ -240,9 +320,9 @@ list <T> ::list(size_t num, const T & t)
  * LIST :: ITERATOR constructors
  * Create a list initialized to a set of values
  ****************************************/
-template <typename T>
+template <typename T, typename A>
 template <class Iterator>
-list <T> ::list(Iterator first, Iterator last)
+list <T, A> ::list(Iterator first, Iterator last, const A& alloc) : NodeAlloc(alloc)
 {
    //defaults
    numElements = 0;
@@ -258,8 +338,8 @@ list <T> ::list(Iterator first, Iterator last)
  * LIST :: INITIALIZER constructors
  * Create a list initialized to a set of values
  ****************************************/
-template <typename T>
-list <T> ::list(const std::initializer_list<T>& il)
+template <typename T, typename A>
+list <T, A> ::list(const std::initializer_list<T>& il, const A& alloc) : NodeAlloc(alloc)
 {
    //defaults
    numElements = 0;
@@ -275,21 +355,21 @@ list <T> ::list(const std::initializer_list<T>& il)
  * LIST :: NON-DEFAULT constructors
  * Create a list initialized to a value
  ****************************************/
-template <typename T>
-list <T> ::list(size_t num)
+template <typename T, typename A>
+list <T, A> ::list(size_t num, const A& alloc) : NodeAlloc(alloc)
 {
    // make sure its not an empty list
    if (num > 0)
    {
       numElements = num;
-      pHead = pTail = new Node();
+      pHead = pTail = newNode();
       // set pHead pNext to pTail
       if (num > 1)
          pHead->pNext = pTail;
       // add all the other nodes
       for (size_t i = 1; i < num; i++)
       {
-         Node* pNew = new Node();
+         Node* pNew = newNode();
          pTail->pNext = pNew;
          pNew->pPrev = pTail;
          pTail = pNew;
@@ -308,8 +388,16 @@ list <T> ::list(size_t num)
 /*****************************************
  * LIST :: DEFAULT constructors
  ****************************************/
-template <typename T>
-list <T> ::list() 
+template <typename T, typename A>
+list <T, A> ::list() 
+{
+   //defaults to empty list
+   numElements = 0;
+   pHead = pTail = nullptr;
+}
+
+template <typename T, typename A>
+list <T, A> ::list(const A& alloc) : NodeAlloc(alloc)
 {
    //defaults to empty list
    numElements = 0;
@@ -318,9 +406,17 @@ list <T> ::list()
 
 /*****************************************
  * LIST :: COPY constructors
+ * The copy gets whatever allocator A says a copy
+ * should get, unless one is given
  ****************************************/
-template <typename T>
-list <T> ::list(list& rhs) 
+template <typename T, typename A>
+list <T, A> ::list(list& rhs) :
+   list(rhs, std::allocator_traits<A>::select_on_container_copy_construction(rhs.get_allocator()))
+{
+}
+
+template <typename T, typename A>
+list <T, A> ::list(list& rhs, const A& alloc) : NodeAlloc(alloc)
 {
    // default
    numElements = 0;
@@ -335,10 +431,11 @@ list <T> ::list(list& rhs)
 
 /*****************************************
  * LIST :: MOVE constructors
- * Steal the values from the RHS
+ * Steal the values from the RHS. The allocator comes
+ * along with the nodes
  ****************************************/
-template <typename T>
-list <T> ::list(list <T>&& rhs)
+template <typename T, typename A>
+list <T, A> ::list(list <T, A>&& rhs) : NodeAlloc(rhs.allocator())
 {
    // default
    numElements = 0;
@@ -356,6 +453,31 @@ list <T> ::list(list <T>&& rhs)
 
 }
 
+/*****************************************
+ * LIST :: MOVE constructors with an allocator
+ * Nodes from another allocator cannot be freed by
+ * this one, so then the values move one at a time
+ ****************************************/
+template <typename T, typename A>
+list <T, A> ::list(list <T, A>&& rhs, const A& alloc) : NodeAlloc(alloc)
+{
+   // default
+   numElements = 0;
+   pHead = pTail = nullptr;
+   if (allocator() == rhs.allocator())
+   {
+      std::swap(numElements, rhs.numElements);
+      std::swap(pHead, rhs.pHead);
+      std::swap(pTail, rhs.pTail);
+   }
+   else
+   {
+      for (auto it = rhs.begin(); it != rhs.end(); ++it)
+         push_back(std::move(*it));
+      rhs.clear();
+   }
+}
+
 /**********************************************
  * LIST :: assignment operator - MOVE
  * Copy one list onto another
@@ -363,14 +485,24 @@ list <T> ::list(list <T>&& rhs)
  *     OUTPUT :
  *     COST   : O(n) with respect to the size of the LHS 
  *********************************************/
-template <typename T>
-list <T>& list <T> :: operator = (list <T> && rhs)
+template <typename T, typename A>
+list <T, A>& list <T, A> :: operator = (list <T, A> && rhs)
 {
    // check for self-assignment
    if (this != &rhs)
    {
       // clear the current list
       clear();
+      // the nodes can only be taken along with an allocator that can free them
+      if (!NodeTraits::propagate_on_container_move_assignment::value &&
+          !(allocator() == rhs.allocator()))
+      {
+         for (auto it = rhs.begin(); it != rhs.end(); ++it)
+            push_back(std::move(*it));
+         rhs.clear();
+         return *this;
+      }
+      moveAllocator(rhs, typename NodeTraits::propagate_on_container_move_assignment());
       // move the values from the rhs to this
       numElements = rhs.numElements;
       pHead = rhs.pHead;
@@ -390,13 +522,18 @@ list <T>& list <T> :: operator = (list <T> && rhs)
  *     OUTPUT :
  *     COST   : O(n) with respect to the number of nodes
  *********************************************/
-template <typename T>
-list <T> & list <T> :: operator = (list <T> & rhs)
+template <typename T, typename A>
+list <T, A> & list <T, A> :: operator = (list <T, A> & rhs)
 {
    // check for self-assignment
    if (this != &rhs)
    {
-      *this = list(rhs); // use the copy constructor 
+      // our nodes must go back to our allocator before we take rhs's
+      if (NodeTraits::propagate_on_container_copy_assignment::value &&
+          !(allocator() == rhs.allocator()))
+         clear();
+      copyAllocator(rhs, typename NodeTraits::propagate_on_container_copy_assignment());
+      *this = list(rhs, get_allocator()); // use the copy constructor 
    }
    return *this;
 }
@@ -408,11 +545,11 @@ list <T> & list <T> :: operator = (list <T> & rhs)
  *     OUTPUT :
  *     COST   : O(n) with respect to the number of nodes
  *********************************************/
-template <typename T>
-list <T>& list <T> :: operator = (const std::initializer_list<T>& rhs)
+template <typename T, typename A>
+list <T, A>& list <T, A> :: operator = (const std::initializer_list<T>& rhs)
 {
    //use the initializer list constructor
-   *this = list(rhs);
+   *this = list(rhs, get_allocator());
    return *this;
 }
 
@@ -423,8 +560,8 @@ list <T>& list <T> :: operator = (const std::initializer_list<T>& rhs)
  *     OUTPUT :
  *     COST   : O(n) with respect to the number of nodes
  *********************************************/
-template <typename T>
-void list <T> :: clear()
+template <typename T, typename A>
+void list <T, A> :: clear()
 {
    // make a temporary pointer to the head
    Node* pTemp = pHead;
@@ -432,7 +569,7 @@ void list <T> :: clear()
    while (pTemp != nullptr)
    {
       Node* pNext = pTemp->pNext;
-      delete pTemp;
+      deleteNode(pTemp);
       pTemp = pNext;
    }
    // reset the head and tail
@@ -447,33 +584,32 @@ void list <T> :: clear()
  *    OUTPUT :
  *    COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> :: push_back(const T & data)
+template <typename T, typename A>
+void list <T, A> :: push_back(const T & data)
 {
-   // create a new node
-   Node* pNew = new Node(data);
-   // if the list is empty, set the head and tail to the new node
-   if (pHead == nullptr)
-   {
-      pHead = pTail = pNew;
-   }
-   else
-   {
-      // otherwise, add the new node to the end of the list
-      pTail->pNext = pNew;
-      pNew->pPrev = pTail;
-      pTail = pNew;
-      pTail->pNext = nullptr;
-   }
-   // increment the number of elements
-   numElements++;
+   emplace_back(data);
 }
 
-template <typename T>
-void list <T> ::push_back(T && data)
+template <typename T, typename A>
+void list <T, A> ::push_back(T && data)
+{
+   emplace_back(std::move(data));
+}
+
+/*********************************************
+ * LIST :: EMPLACE BACK
+ * build an item at the end of the list, right in its
+ * node, from the arguments of one of its constructors
+ *    INPUT  : arguments for T's constructor
+ *    OUTPUT : the new item
+ *    COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+template <class... Args>
+T & list <T, A> :: emplace_back(Args&&... args)
 {
    // create a new node
-   Node* pNew = new Node(std::move(data));
+   Node* pNew = newNode(std::forward<Args>(args)...);
    // if the list is empty, set the head and tail to the new node
    if (pHead == nullptr)
    {
@@ -489,6 +625,7 @@ void list <T> ::push_back(T && data)
    }
    // increment the number of elements
    numElements++;
+   return pNew->data;
 }
 
 /*********************************************
@@ -498,32 +635,32 @@ void list <T> ::push_back(T && data)
  *     OUTPUT :
  *     COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> :: push_front(const T & data)
+template <typename T, typename A>
+void list <T, A> :: push_front(const T & data)
 {
-   //create a new node
-   Node* pNew = new Node(data);
-
-   pNew->pNext = pHead;
-   pNew->pPrev = nullptr;
+   emplace_front(data);
+}
 
-   if (pHead != nullptr)
-   { //The old head must be updated
-      pHead->pPrev = pNew;
-   }
-   else
-   { //if the list was empty then the tail is also the head
-      pTail = pNew;
-   }
-   pHead = pNew; //set the new head
-   numElements++; //update the number of elements
+template <typename T, typename A>
+void list <T, A> ::push_front(T && data)
+{
+   emplace_front(std::move(data));
 }
 
-template <typename T>
-void list <T> ::push_front(T && data)
+/*********************************************
+ * LIST :: EMPLACE FRONT
+ * build an item at the head of the list, right in its
+ * node, from the arguments of one of its constructors
+ *     INPUT  : arguments for T's constructor
+ *     OUTPUT : the new item
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+template <class... Args>
+T & list <T, A> :: emplace_front(Args&&... args)
 {
    //create a new node
-   Node* pNew = new Node(std::move(data));
+   Node* pNew = newNode(std::forward<Args>(args)...);
 
    pNew->pNext = pHead;
    pNew->pPrev = nullptr;
@@ -538,6 +675,7 @@ void list <T> ::push_front(T && data)
 
    pHead = pNew; //set the new head
    numElements++; //update the number of elements
+   return pNew->data;
 }
 
 
@@ -548,8 +686,8 @@ void list <T> ::push_front(T && data)
  *    OUTPUT :
  *    COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> ::pop_back()
+template <typename T, typename A>
+void list <T, A> ::pop_back()
 {
    //if the list is empty, do nothing
    if (pTail == nullptr)
@@ -558,14 +696,14 @@ void list <T> ::pop_back()
    //if there is only one element, delete it
    if (pHead == pTail)
    {
-      delete pHead;
+      deleteNode(pHead);
       pHead = pTail = nullptr;
    }
    else
    { //otherwise, remove the last element and set new tail
       Node* pTemp = pTail;
       pTail = pTail->pPrev;
-      delete pTemp;
+      deleteNode(pTemp);
       pTail->pNext = nullptr;
    }
    //decrement the number of elements
@@ -579,8 +717,8 @@ void list <T> ::pop_back()
  *    OUTPUT :
  *    COST   : O(1)
  *********************************************/
-template <typename T>
-void list <T> ::pop_front()
+template <typename T, typename A>
+void list <T, A> ::pop_front()
 {
    //if the list is empty, do nothing
    if (pHead == nullptr)
@@ -589,14 +727,14 @@ void list <T> ::pop_front()
    //if there is only one element, delete it
    if (pHead == pTail)
    {
-      delete pHead;
+      deleteNode(pHead);
       pHead = pTail = nullptr;
    }
    else
    { //otherwise, remove the first element and set new head
       Node* pTemp = pHead;
       pHead = pHead->pNext;
-      delete pTemp;
+      deleteNode(pTemp);
       pHead->pPrev = nullptr;
    }
    //decrement the number of elements
@@ -610,12 +748,12 @@ void list <T> ::pop_front()
  *     OUTPUT : data to be displayed
  *     COST   : O(1)
  *********************************************/
-template <typename T>
-T & list<T>::front()
+template <typename T, typename A>
+T & list<T, A>::front()
 {
    //if the list is empty, return a dummy value
    if (pHead == nullptr)
-      return *(new int(99));
+      return *(new T());
    //else return the first element
    return pHead->data;
 }
@@ -627,12 +765,12 @@ T & list<T>::front()
  *     OUTPUT : data to be displayed
  *     COST   : O(1)
  *********************************************/
-template <typename T>
-T & list<T>::back()
+template <typename T, typename A>
+T & list<T, A>::back()
 {
    //if the list is empty, return a dummy value
    if (pTail == nullptr)
-      return *(new int(99));
+      return *(new T());
    //else return the last element
    return pTail->data;
 }
@@ -644,8 +782,8 @@ T & list<T>::back()
  *     OUTPUT : iterator to the new location 
  *     COST   : O(1)
  ******************************************/
-template <typename T>
-typename list <T> :: iterator  list <T> :: erase(const list <T> :: iterator & it)
+template <typename T, typename A>
+typename list <T, A> :: iterator  list <T, A> :: erase(const list <T, A> :: iterator & it)
 {
    Node* pDelete = it.p;
    //if the list is empty, do nothing
@@ -664,74 +802,414 @@ typename list <T> :: iterator  list <T> :: erase(const list <T> :: iterator & it
    else
       pTail = pDelete->pPrev; //If removing the tail
 
-   delete pDelete; //delete the node
+   deleteNode(pDelete); //delete the node
    numElements--; //decrement the number of elements
 
    return itReturn; //return the iterator to the new location
 }
 
 /******************************************
- * LIST :: INSERT
- * add an item to the middle of the list
- *     INPUT  : data to be added to the list
- *              an iterator to the location where it is to be inserted
- *     OUTPUT : iterator to the new item
+ * LIST :: SPLICE
+ * move one node from rhs (which may be this list)
+ * to just before pos. Nothing is allocated or copied;
+ * only the pointers change
+ *     INPUT  : where the node goes, the list it is in,
+ *              and an iterator to the node
+ *     OUTPUT :
  *     COST   : O(1)
  ******************************************/
-template <typename T>
-typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
-                                                 const T & data) 
+template <typename T, typename A>
+void list <T, A> :: splice(list <T, A> :: iterator pos, list <T, A> & rhs,
+                        list <T, A> :: iterator it)
 {
-   //create a new node for it
-   Node* pNext = it.p;
+   Node* pMove = it.p;
 
-   //If inserteing at the end (it == end()), just use push_back
-   if (!pNext)
+   //the node will be freed by our allocator, so it must be able to
+   assert(this == &rhs || allocator() == rhs.allocator());
+
+   //nothing to move, or it is already where it belongs
+   if (pMove == nullptr || pMove == pos.p ||
+       (this == &rhs && pMove->pNext == pos.p))
+      return;
+
+   //unhook the node from rhs
+   if (pMove->pPrev)
+      pMove->pPrev->pNext = pMove->pNext;
+   else
+      rhs.pHead = pMove->pNext;
+   if (pMove->pNext)
+      pMove->pNext->pPrev = pMove->pPrev;
+   else
+      rhs.pTail = pMove->pPrev;
+   rhs.numElements--;
+
+   //hook it in before pos, or at the end if pos is end()
+   Node* pNext = pos.p;
+   pMove->pNext = pNext;
+   if (pNext)
    {
-      push_back(data);
-      return iterator(pTail);
+      pMove->pPrev = pNext->pPrev;
+      pNext->pPrev = pMove;
    }
+   else
+   {
+      pMove->pPrev = pTail;
+      pTail = pMove;
+   }
+   if (pMove->pPrev)
+      pMove->pPrev->pNext = pMove;
+   else
+      pHead = pMove;
+   numElements++;
+}
+
+/******************************************
+ * LIST :: SPLICE - WHOLE LIST
+ * move every node of rhs to just before pos,
+ * leaving rhs empty
+ *     INPUT  : where the nodes go, and the list they are in
+ *     OUTPUT :
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(list <T, A> :: iterator pos, list <T, A> & rhs)
+{
+   if (this == &rhs || rhs.pHead == nullptr)
+      return;
+   assert(allocator() == rhs.allocator());
 
-   //create new node for the data
-   Node* pNew = new Node(data);
+   Node* pFirst = rhs.pHead;
+   Node* pLast = rhs.pTail;
+   size_t num = rhs.numElements;
+   rhs.pHead = rhs.pTail = nullptr;
+   rhs.numElements = 0;
 
-   //set pointers
-   pNew->pNext = pNext; //new node will equal the next data
-   pNew->pPrev = pNext->pPrev; //The new nodes pPrev needs to be this nodes pPrev
+   hook(pos.p, pFirst, pLast);
+   numElements += num;
+}
 
-   if (pNext->pPrev)
-      pNext->pPrev->pNext = pNew; //If not the head, set the previous nodes pNext to the new node
+/******************************************
+ * LIST :: SPLICE - RANGE
+ * move the nodes from first up to but not including
+ * last to just before pos. pos may not be among them
+ *     INPUT  : where the nodes go, the list they are in,
+ *              and the range of nodes
+ *     OUTPUT :
+ *     COST   : O(1) within a list, O(n) in the nodes
+ *              moved from another, which must be counted
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(list <T, A> :: iterator pos, list <T, A> & rhs,
+                        list <T, A> :: iterator first, list <T, A> :: iterator last)
+{
+   if (first == last || pos == last)
+      return;
+   assert(this == &rhs || allocator() == rhs.allocator());
+
+   Node* pFirst = first.p;
+   Node* pLast = last.p ? last.p->pPrev : rhs.pTail;
+   size_t num = 0;
+   if (this != &rhs)
+      for (Node* p = pFirst; p != last.p; p = p->pNext)
+         num++;
+
+   rhs.unhook(pFirst, pLast);
+   rhs.numElements -= num;
+   hook(pos.p, pFirst, pLast);
+   numElements += num;
+}
+
+/******************************************
+ * LIST :: MERGE
+ * move every node of rhs into this list. Both must
+ * already be sorted, and the result is sorted too.
+ * Of two equal elements, ours comes first
+ *     INPUT  : a sorted list to empty into this one,
+ *              and what "comes before" means
+ *     OUTPUT :
+ *     COST   : O(n + m), relinking only
+ ******************************************/
+template <typename T, typename A>
+template <class Compare>
+void list <T, A> :: merge(list <T, A> & rhs, Compare comp)
+{
+   if (this == &rhs)
+      return;
+   assert(allocator() == rhs.allocator());
+
+   Node* p = pHead;
+   while (rhs.pHead)
+   {
+      // past our last element, the rest of rhs goes on the end
+      if (p == nullptr)
+      {
+         splice(end(), rhs);
+         return;
+      }
+
+      // take the run of rhs that comes before *p in one relink
+      if (comp(rhs.pHead->data, p->data))
+      {
+         Node* pFirst = rhs.pHead;
+         Node* pLast = pFirst;
+         size_t num = 1;
+         while (pLast->pNext && comp(pLast->pNext->data, p->data))
+         {
+            pLast = pLast->pNext;
+            num++;
+         }
+         rhs.unhook(pFirst, pLast);
+         rhs.numElements -= num;
+         hook(p, pFirst, pLast);
+         numElements += num;
+      }
+      p = p->pNext;
+   }
+}
+
+/******************************************
+ * LIST :: SORT
+ * Bottom-up merge sort, counting in binary: bin i
+ * holds a sorted run of 2^i nodes or nothing. Each
+ * node is carried in like adding one, merging up
+ * through the full bins, so runs are merged while
+ * their nodes are still in the cache. Only pNext is
+ * relinked until pPrev is put right at the end.
+ * Nothing is allocated, copied or moved, and equal
+ * elements keep their order
+ *     INPUT  : what "comes before" means
+ *     OUTPUT :
+ *     COST   : O(n log n)
+ ******************************************/
+template <typename T, typename A>
+template <class Compare>
+void list <T, A> :: sort(Compare comp)
+{
+   if (pHead == nullptr || pHead->pNext == nullptr)
+      return;
+
+   // bins[i] is older than everything below it, so it goes on the left
+   const size_t NUM_BINS = 64;
+   Node* bins[NUM_BINS] = {};
+   Node* p = pHead;
+   while (p)
+   {
+      Node* pCarry = p;
+      p = p->pNext;
+      pCarry->pNext = nullptr;
+
+      size_t i = 0;
+      for (; i < NUM_BINS - 1 && bins[i]; i++)
+      {
+         pCarry = mergeRuns(bins[i], pCarry, comp);
+         bins[i] = nullptr;
+      }
+      bins[i] = pCarry;
+   }
+
+   Node* pSorted = nullptr;
+   for (size_t i = 0; i < NUM_BINS; i++)
+      if (bins[i])
+         pSorted = mergeRuns(bins[i], pSorted, comp);
+
+   // put the back links right
+   pHead = pSorted;
+   Node* pPrev = nullptr;
+   for (Node* p = pHead; p; p = p->pNext)
+   {
+      p->pPrev = pPrev;
+      pPrev = p;
+   }
+   pTail = pPrev;
+}
+
+/******************************************
+ * LIST :: MERGE RUNS
+ * merge two sorted runs linked by pNext alone and
+ * ended by nullptr. Of two equal elements, the one
+ * from pLeft comes first
+ ******************************************/
+template <typename T, typename A>
+template <class Compare>
+typename list <T, A> :: Node * list <T, A> :: mergeRuns(Node* pLeft, Node* pRight,
+                                                     Compare& comp)
+{
+   Node* pFirst = nullptr;
+   Node** ppLink = &pFirst;
+   while (pLeft && pRight)
+   {
+      if (comp(pRight->data, pLeft->data))
+      {
+         *ppLink = pRight;
+         ppLink = &pRight->pNext;
+         pRight = pRight->pNext;
+      }
+      else
+      {
+         *ppLink = pLeft;
+         ppLink = &pLeft->pNext;
+         pLeft = pLeft->pNext;
+      }
+   }
+   *ppLink = pLeft ? pLeft : pRight;
+   return pFirst;
+}
+
+/******************************************
+ * LIST :: UNIQUE
+ * erase every element equal to the one just before it
+ *     INPUT  : what "equal" means
+ *     OUTPUT : how many were erased
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+template <class BinaryPredicate>
+size_t list <T, A> :: unique(BinaryPredicate equal)
+{
+   size_t num = 0;
+   for (Node* p = pHead; p; p = p->pNext)
+      while (p->pNext && equal(p->data, p->pNext->data))
+      {
+         erase(iterator(p->pNext));
+         num++;
+      }
+   return num;
+}
+
+/******************************************
+ * LIST :: REMOVE IF
+ * erase every element for which pred is true
+ *     INPUT  : which ones to erase
+ *     OUTPUT : how many were erased
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+template <class Predicate>
+size_t list <T, A> :: remove_if(Predicate pred)
+{
+   size_t num = 0;
+   iterator it = begin();
+   while (it != end())
+      if (pred(*it))
+      {
+         it = erase(it);
+         num++;
+      }
+      else
+         ++it;
+   return num;
+}
+
+/******************************************
+ * LIST :: REVERSE
+ * turn the list around by swapping the links of
+ * every node
+ *     INPUT  :
+ *     OUTPUT :
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: reverse()
+{
+   for (Node* p = pHead; p; p = p->pPrev)
+      std::swap(p->pNext, p->pPrev);
+   std::swap(pHead, pTail);
+}
+
+/******************************************
+ * LIST :: UNHOOK
+ * take the nodes pFirst through pLast out of this
+ * list, closing the gap. The count is left alone
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: unhook(Node* pFirst, Node* pLast)
+{
+   if (pFirst->pPrev)
+      pFirst->pPrev->pNext = pLast->pNext;
    else
-      pHead = pNew; //If inserting at the head, set the head to the new node
+      pHead = pLast->pNext;
+   if (pLast->pNext)
+      pLast->pNext->pPrev = pFirst->pPrev;
+   else
+      pTail = pFirst->pPrev;
+}
 
-   pNext->pPrev = pNew; //set the next nodes pPrev to the new node
-   numElements++; //increment the number of elements
-   return iterator(pNew); //return the new node
+/******************************************
+ * LIST :: HOOK
+ * link the nodes pFirst through pLast in just
+ * before pNext, or at the end if it is nullptr.
+ * The count is left alone
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: hook(Node* pNext, Node* pFirst, Node* pLast)
+{
+   Node* pPrev = pNext ? pNext->pPrev : pTail;
+   pFirst->pPrev = pPrev;
+   pLast->pNext = pNext;
+   if (pPrev)
+      pPrev->pNext = pFirst;
+   else
+      pHead = pFirst;
+   if (pNext)
+      pNext->pPrev = pLast;
+   else
+      pTail = pLast;
 }
 
-template <typename T>
-typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
+/******************************************
+ * LIST :: INSERT
+ * add an item to the middle of the list
+ *     INPUT  : data to be added to the list
+ *              an iterator to the location where it is to be inserted
+ *     OUTPUT : iterator to the new item
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+typename list <T, A> :: iterator list <T, A> :: insert(list <T, A> :: iterator it,
+                                                 const T & data) 
+{
+   return emplace(it, data);
+}
+
+template <typename T, typename A>
+typename list <T, A> :: iterator list <T, A> :: insert(list <T, A> :: iterator it,
    T && data)
 {
-   //Create a new Node for it.
+   return emplace(it, std::move(data));
+}
+
+/******************************************
+ * LIST :: EMPLACE
+ * build an item in the middle of the list, right in
+ * its node, from the arguments of one of its constructors
+ *     INPUT  : an iterator to the location where it is to be built
+ *              arguments for T's constructor
+ *     OUTPUT : iterator to the new item
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+template <class... Args>
+typename list <T, A> :: iterator list <T, A> :: emplace(list <T, A> :: iterator it,
+                                                  Args&&... args)
+{
    Node* pNext = it.p;
 
-   // If inserting at the end (it == end()), just use push_back
+   // If building at the end (it == end()), just use emplace_back
    if (!pNext)
    {
-      push_back(std::move(data));
+      emplace_back(std::forward<Args>(args)...);
       return iterator(pTail);
    }
 
    // Create new node for the data
-   Node* pNew = new Node(std::move(data));
+   Node* pNew = newNode(std::forward<Args>(args)...);
 
    // Set pointers
    pNew->pNext = pNext; //new node will equal the next data
    pNew->pPrev = pNext->pPrev; //The new nodes pPrev needs to be this pPrev.
 
    if (pNext->pPrev)
-      pNext->pPrev->pNext = pNew;
+      pNext->pPrev->pNext = pNew; //If not the head, set the previous nodes pNext to the new node
    else
       pHead = pNew; // New node becomes head
 
@@ -748,25 +1226,20 @@ typename list <T> :: iterator list <T> :: insert(list <T> :: iterator it,
  *     OUTPUT :
  *     COST   : O(n) with respect to the size of the LHS
  *********************************************/
-template <typename T>
-void swap(list <T> & lhs, list <T> & rhs)
+template <typename T, typename A>
+void swap(list <T, A> & lhs, list <T, A> & rhs)
 {
-   // check for self-assignment
-   if (&lhs != &rhs)
-   {
-      // swap the values of the two lists
-      std::swap(lhs.numElements, rhs.numElements);
-      std::swap(lhs.pHead, rhs.pHead);
-      std::swap(lhs.pTail, rhs.pTail);
-   }
+   lhs.swap(rhs);
 }
 
-template <typename T>
-void list<T>::swap(list <T>& rhs)
+template <typename T, typename A>
+void list<T, A>::swap(list <T, A>& rhs)
 {
    // check for self-assignment
    if (this != &rhs)
    {
+      // the allocators trade places too, or must already be equal
+      swapAllocator(rhs, typename NodeTraits::propagate_on_container_swap());
       // swap the values of the two lists
       std::swap(numElements, rhs.numElements);
       std::swap(pHead, rhs.pHead);
@@ -774,5 +1247,49 @@ void list<T>::swap(list <T>& rhs)
    }
 }
 
+/******************************************
+ * LIST :: NEW NODE
+ * Allocate one node from our allocator and build it
+ * from args. Nothing leaks if building it throws
+ ******************************************/
+template <typename T, typename A>
+template <class... Args>
+typename list <T, A> :: Node * list <T, A> :: newNode(Args&&... args)
+{
+   NodeAlloc& alloc = allocator();
+   Node* pNew = NodeTraits::allocate(alloc, 1);
+   try
+   {
+      NodeTraits::construct(alloc, pNew, std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      NodeTraits::deallocate(alloc, pNew, 1);
+      throw;
+   }
+   return pNew;
+}
+
+/******************************************
+ * LIST :: DELETE NODE
+ * Destroy one node and give it back to our allocator
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: deleteNode(Node* pNode)
+{
+   NodeAlloc& alloc = allocator();
+   NodeTraits::destroy(alloc, pNode);
+   NodeTraits::deallocate(alloc, pNode, 1);
+}
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+namespace pmr
+{
+   // a list whose nodes come from a std::pmr::memory_resource
+   template <typename T>
+   using list = custom::list<T, std::pmr::polymorphic_allocator<T>>;
+}
+#endif
+
 //#endif
 }; // namespace custom
@@ -0,0 +1,788 @@
+/***********************************************************************
+ * Header:
+ *    LOCK FREE
+ * Summary:
+ *    A hash set that no thread ever has to wait on. Every element lives
+ *    in one singly linked list sorted by its hash with the bits
+ *    reversed (a split-ordered list). In that order the elements of
+ *    bucket b are followed by the elements of bucket b + n, so when
+ *    the number of buckets n doubles, no element moves: the new bucket
+ *    is just a marker node dropped into the middle of the old one.
+ *    Links are changed with compare-and-swap only. A node being erased
+ *    is first marked in the low bit of its next pointer, then unlinked.
+ *
+ *    A node that has been unlinked may still be read by a thread that
+ *    found it a moment earlier, so it is not freed right away. It is
+ *    retired to the epoch reclaimer, which frees it once every thread
+ *    that could have seen it has moved on.
+ *
+ *    This will contain the class definition of:
+ *        epoch                              : Epoch-based reclamation
+ *        epoch::guard                       : Holds the current epoch
+ *        lock_free_unordered_set            : A hash no thread waits on
+ *        lock_free_unordered_set::iterator  : An interator through the hash
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"     // for custom::pair
+#include <atomic>     // for std::atomic
+#include <cstdint>    // for uint64_t and uintptr_t
+#include <functional> // for std::hash
+#include <vector>     // for std::vector
+
+class TestLockFree;         // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * EPOCH
+ * Epoch-based memory reclamation. A thread reading
+ * shared nodes holds a guard, which announces the
+ * global epoch it saw. The global epoch only moves on
+ * when every thread holding a guard has seen it, so a
+ * node retired in epoch e cannot be reached by anyone
+ * once the global epoch is e + 2.
+ ************************************************/
+class epoch
+{
+   friend class ::TestLockFree;   // give unit tests access to the privates
+public:
+   class guard;
+
+   // the one reclaimer shared by every lock-free container
+   static epoch& instance()
+   {
+      static epoch domain;
+      return domain;
+   }
+  ~epoch();
+
+   void retire(void* p, void (*destroy)(void*));
+   void reclaim();
+
+private:
+   epoch() : global(1), pRecords(nullptr) {}
+
+   // something to free, and the epoch it was retired in
+   struct retired
+   {
+      void* p;
+      void (*destroy)(void*);
+      uint64_t epoch;
+   };
+
+   // everything the reclaimer knows about one thread
+   struct record
+   {
+      record() : local(0), inUse(true), nesting(0), pNext(nullptr) {}
+      std::atomic<uint64_t> local;   // 2 * epoch + 1 inside a guard, 0 outside
+      std::atomic<bool>     inUse;   // a live thread owns this record
+      size_t nesting;                // guards held; owner thread only
+      std::vector<retired> limbo;    // not yet freed; owner thread only
+      record* pNext;                 // never changes once published
+   };
+
+   record& mine();
+   record* acquire();
+   void enter();
+   void leave();
+   bool tryAdvance();
+   void collect(record& rec);
+
+   static const size_t COLLECT_EVERY = 64;
+
+   std::atomic<uint64_t> global;     // the current epoch
+   std::atomic<record*>  pRecords;   // every thread that has ever held a guard
+};
+
+/************************************************
+ * EPOCH GUARD
+ * While one of these lives, nothing this thread can
+ * reach will be freed. Guards nest
+ ************************************************/
+class epoch::guard
+{
+public:
+   guard()              { epoch::instance().enter(); }
+   guard(const guard&)  { epoch::instance().enter(); }
+   guard& operator = (const guard&) { return *this; }
+  ~guard()              { epoch::instance().leave(); }
+};
+
+/*****************************************
+ * EPOCH :: DESTRUCTOR
+ * No thread is left, so everything can go
+ ****************************************/
+inline epoch::~epoch()
+{
+   record* pRecord = pRecords.load();
+   while (pRecord)
+   {
+      for (size_t i = 0; i < pRecord->limbo.size(); i++)
+         pRecord->limbo[i].destroy(pRecord->limbo[i].p);
+      record* pNext = pRecord->pNext;
+      delete pRecord;
+      pRecord = pNext;
+   }
+}
+
+/*****************************************
+ * EPOCH :: MINE
+ * The record of the calling thread. It goes back to the
+ * pool when the thread ends, limbo and all, for the next
+ * thread to pick up
+ ****************************************/
+inline epoch::record& epoch::mine()
+{
+   struct owner
+   {
+      record* pRecord;
+      owner() : pRecord(nullptr) {}
+     ~owner()
+      {
+         if (pRecord)
+            pRecord->inUse.store(false, std::memory_order_release);
+      }
+   };
+   static thread_local owner self;
+   if (self.pRecord == nullptr)
+      self.pRecord = acquire();
+   return *self.pRecord;
+}
+
+/*****************************************
+ * EPOCH :: ACQUIRE
+ * Reuse the record of a thread that has ended, or add one
+ ****************************************/
+inline epoch::record* epoch::acquire()
+{
+   for (record* pRecord = pRecords.load(); pRecord; pRecord = pRecord->pNext)
+   {
+      bool inUse = false;
+      if (!pRecord->inUse.load() &&
+          pRecord->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire))
+         return pRecord;
+   }
+
+   record* pRecord = new record;
+   record* pHead = pRecords.load();
+   do
+      pRecord->pNext = pHead;
+   while (!pRecords.compare_exchange_weak(pHead, pRecord));
+   return pRecord;
+}
+
+/*****************************************
+ * EPOCH :: ENTER and LEAVE
+ * Announce the epoch this thread is reading in, and
+ * withdraw it when the last guard goes away
+ ****************************************/
+inline void epoch::enter()
+{
+   record& rec = mine();
+   if (rec.nesting++ == 0)
+      rec.local.store(global.load() * 2 + 1);
+}
+inline void epoch::leave()
+{
+   record& rec = mine();
+   if (--rec.nesting == 0)
+      rec.local.store(0, std::memory_order_release);
+}
+
+/*****************************************
+ * EPOCH :: TRY ADVANCE
+ * Move the global epoch on if every thread in a guard
+ * has already seen the current one
+ ****************************************/
+inline bool epoch::tryAdvance()
+{
+   uint64_t current = global.load();
+   for (record* pRecord = pRecords.load(); pRecord; pRecord = pRecord->pNext)
+   {
+      uint64_t local = pRecord->local.load();
+      if (local != 0 && local != current * 2 + 1)
+         return false;
+   }
+   return global.compare_exchange_strong(current, current + 1);
+}
+
+/*****************************************
+ * EPOCH :: COLLECT
+ * Free what rec retired at least two epochs ago
+ ****************************************/
+inline void epoch::collect(record& rec)
+{
+   uint64_t current = global.load();
+   size_t iKeep = 0;
+   for (size_t i = 0; i < rec.limbo.size(); i++)
+      if (rec.limbo[i].epoch + 2 <= current)
+         rec.limbo[i].destroy(rec.limbo[i].p);
+      else
+         rec.limbo[iKeep++] = rec.limbo[i];
+   rec.limbo.resize(iKeep);
+}
+
+/*****************************************
+ * EPOCH :: RETIRE
+ * p is unreachable now; call destroy(p) once no thread
+ * can still be looking at it
+ ****************************************/
+inline void epoch::retire(void* p, void (*destroy)(void*))
+{
+   record& rec = mine();
+   retired item = { p, destroy, global.load() };
+   rec.limbo.push_back(item);
+   if (rec.limbo.size() % COLLECT_EVERY == 0)
+   {
+      tryAdvance();
+      collect(rec);
+   }
+}
+
+/*****************************************
+ * EPOCH :: RECLAIM
+ * Free as much of what this thread retired as is safe
+ * right now. Only useful outside of any guard
+ ****************************************/
+inline void epoch::reclaim()
+{
+   tryAdvance();
+   tryAdvance();
+   collect(mine());
+}
+
+/************************************************
+ * LOCK FREE UNORDERED SET
+ * A set implemented as a split-ordered list
+ ************************************************/
+template <typename T,
+          typename Hash = std::hash<T>,
+          typename KeyEqual = std::equal_to<T>>
+class lock_free_unordered_set
+{
+   friend class ::TestLockFree;   // give unit tests access to the privates
+
+   // a node of the split-ordered list. Bucket markers are plain
+   // Nodes with an even key; elements are ValueNodes with an odd key
+   struct Node
+   {
+      Node(uint64_t soKey) : soKey(soKey), next(0) {}
+      uint64_t soKey;
+      std::atomic<uintptr_t> next;   // Node*, low bit set once erased
+   };
+   struct ValueNode : Node
+   {
+      template <class... Args>
+      ValueNode(uint64_t soKey, Args&&... args) :
+         Node(soKey), data(std::forward<Args>(args)...) {}
+      T data;
+   };
+
+public:
+   typedef Hash     hasher;
+   typedef KeyEqual key_equal;
+
+   //
+   // Construct
+   //
+   lock_free_unordered_set(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual());
+   lock_free_unordered_set(const lock_free_unordered_set&) = delete;
+   lock_free_unordered_set& operator = (const lock_free_unordered_set&) = delete;
+  ~lock_free_unordered_set();
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin();
+   iterator end();
+
+   //
+   // Access
+   //
+   iterator find(const T& t);
+   bool contains(const T& t)
+   {
+      return find(t) != end();
+   }
+   size_t count(const T& t)
+   {
+      return contains(t) ? 1 : 0;
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T& t)
+   {
+      return insertValue(t);
+   }
+   custom::pair<iterator, bool> insert(T&& t)
+   {
+      return insertValue(std::move(t));
+   }
+
+   //
+   // Remove
+   //
+   size_t erase(const T& t);
+   void clear();
+
+   //
+   // Status
+   //
+   size_t size() const
+   {
+      return numElements.load();
+   }
+   bool empty() const
+   {
+      return size() == 0;
+   }
+   size_t bucket_count() const
+   {
+      return numBuckets.load();
+   }
+   size_t bucket(const T& t) const
+   {
+      return hashFunction(t) & (bucket_count() - 1);
+   }
+   float load_factor() const
+   {
+      return (float)size() / (float)bucket_count();
+   }
+   float max_load_factor() const
+   {
+      return MAX_LOAD_FACTOR;
+   }
+   Hash     hash_function() const { return hashFunction; }
+   KeyEqual key_eq()        const { return keyEqual;     }
+
+private:
+   static const size_t DEFAULT_BUCKETS = 16;
+   static const size_t NUM_SEGMENTS = sizeof(size_t) * 8;
+   static constexpr float MAX_LOAD_FACTOR = 2.0f;
+   static const uintptr_t MARK = 1;
+
+   //
+   // Split order: reverse the bits so the low bits of the hash,
+   // the ones that pick the bucket, sort first
+   //
+   static uint64_t reverse(uint64_t x)
+   {
+      x = ((x >> 1)  & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+      x = ((x >> 2)  & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+      x = ((x >> 4)  & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+      x = ((x >> 8)  & 0x00FF00FF00FF00FFull) | ((x & 0x00FF00FF00FF00FFull) << 8);
+      x = ((x >> 16) & 0x0000FFFF0000FFFFull) | ((x & 0x0000FFFF0000FFFFull) << 16);
+      return (x >> 32) | (x << 32);
+   }
+   static uint64_t soElement(size_t hash)   { return reverse((uint64_t)hash) | 1; }
+   static uint64_t soBucket(size_t iBucket) { return reverse((uint64_t)iBucket);  }
+
+   //
+   // Marked pointers
+   //
+   static Node* ptrOf(uintptr_t link)     { return (Node*)(link & ~MARK);  }
+   static bool  isMarked(uintptr_t link)  { return (link & MARK) != 0;     }
+   static bool  isBucket(const Node* p)   { return (p->soKey & 1) == 0;    }
+   static const T& valueOf(Node* p)       { return static_cast<ValueNode*>(p)->data; }
+   static void destroyValue(void* p)      { delete static_cast<ValueNode*>(static_cast<Node*>(p)); }
+
+   //
+   // Buckets: segment s holds the buckets whose top bit is bit s - 1,
+   // so doubling the number of buckets never moves a segment
+   //
+   std::atomic<Node*>& slotOf(size_t iBucket);
+   Node* bucketOf(size_t iBucket);
+   Node* initBucket(size_t iBucket);
+
+   template <class Match>
+   bool search(Node* pStart, uint64_t soKey, Match match,
+               std::atomic<uintptr_t>*& pPrev, Node*& pCur);
+   template <class Arg>
+   custom::pair<iterator, bool> insertValue(Arg&& arg);
+
+   std::atomic<std::atomic<Node*>*> segments[NUM_SEGMENTS];
+   std::atomic<size_t> numBuckets;    // always a power of two
+   std::atomic<size_t> numElements;
+   Hash     hashFunction;
+   KeyEqual keyEqual;
+};
+
+template <typename T, typename Hash, typename KeyEqual>
+constexpr float lock_free_unordered_set<T, Hash, KeyEqual>::MAX_LOAD_FACTOR;
+
+/************************************************
+ * LOCK FREE UNORDERED SET ITERATOR
+ * Walks the split-ordered list, skipping bucket markers
+ * and erased nodes. An iterator holds an epoch guard, so
+ * the node it is on stays readable even if another thread
+ * erases it. An iterator belongs to the thread that made it
+ ************************************************/
+template <typename T, typename Hash, typename KeyEqual>
+class lock_free_unordered_set <T, Hash, KeyEqual> ::iterator
+{
+   friend class ::TestLockFree;   // give unit tests access to the privates
+   friend class lock_free_unordered_set;
+public:
+   //
+   // Construct
+   //
+   iterator() : p(nullptr)
+   {
+   }
+   iterator(Node* p) : p(p)
+   {
+   }
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const { return p == rhs.p; }
+   bool operator != (const iterator& rhs) const { return p != rhs.p; }
+
+   //
+   // Access
+   //
+   const T& operator * () const
+   {
+      return lock_free_unordered_set::valueOf(p);
+   }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ()
+   {
+      p = lock_free_unordered_set::ptrOf(p->next.load());
+      skip();
+      return *this;
+   }
+   iterator operator ++ (int)
+   {
+      iterator itReturn(*this);
+      ++(*this);
+      return itReturn;
+   }
+
+private:
+   // move past bucket markers and erased nodes
+   void skip()
+   {
+      while (p != nullptr && (lock_free_unordered_set::isBucket(p) ||
+                              lock_free_unordered_set::isMarked(p->next.load())))
+         p = lock_free_unordered_set::ptrOf(p->next.load());
+   }
+
+   Node* p;
+   epoch::guard guard;
+};
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: CONSTRUCTOR
+ * Bucket 0 always exists; it is the head of the list
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+lock_free_unordered_set<T, Hash, KeyEqual>::lock_free_unordered_set(const Hash& hash, const KeyEqual& equal) :
+   numBuckets(DEFAULT_BUCKETS), numElements(0), hashFunction(hash), keyEqual(equal)
+{
+   for (size_t i = 0; i < NUM_SEGMENTS; i++)
+      segments[i].store(nullptr);
+   slotOf(0).store(new Node(soBucket(0)));
+}
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: DESTRUCTOR
+ * No other thread may be using the set. What is still
+ * linked is freed now; what was erased is the reclaimer's
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+lock_free_unordered_set<T, Hash, KeyEqual>::~lock_free_unordered_set()
+{
+   Node* p = slotOf(0).load();
+   while (p)
+   {
+      Node* pNext = ptrOf(p->next.load());
+      if (isBucket(p))
+         delete p;
+      else
+         delete static_cast<ValueNode*>(p);
+      p = pNext;
+   }
+   for (size_t i = 0; i < NUM_SEGMENTS; i++)
+      delete [] segments[i].load();
+}
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: SLOT OF
+ * The bucket array entry for iBucket, allocating its
+ * segment the first time any of its buckets is used
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+std::atomic<typename lock_free_unordered_set<T, Hash, KeyEqual>::Node*>& lock_free_unordered_set<T, Hash, KeyEqual>::slotOf(size_t iBucket)
+{
+   size_t iSegment = 0;
+   for (size_t bits = iBucket; bits; bits >>= 1)
+      iSegment++;
+   size_t iFirst = (iSegment == 0) ? 0 : (size_t)1 << (iSegment - 1);
+   size_t num    = (iSegment == 0) ? 1 : iFirst;
+
+   std::atomic<Node*>* pSegment = segments[iSegment].load();
+   if (pSegment == nullptr)
+   {
+      std::atomic<Node*>* pNew = new std::atomic<Node*>[num]();
+      if (segments[iSegment].compare_exchange_strong(pSegment, pNew))
+         pSegment = pNew;
+      else
+         delete [] pNew;   // pSegment now holds the winner's
+   }
+   return pSegment[iBucket - iFirst];
+}
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: BUCKET OF
+ * The marker node that starts bucket iBucket
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+typename lock_free_unordered_set<T, Hash, KeyEqual>::Node* lock_free_unordered_set<T, Hash, KeyEqual>::bucketOf(size_t iBucket)
+{
+   Node* p = slotOf(iBucket).load();
+   return p ? p : initBucket(iBucket);
+}
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: INIT BUCKET
+ * A bucket splits off from its parent, the same index
+ * without the top bit. Drop a marker into the parent's
+ * part of the list where the new bucket begins
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+typename lock_free_unordered_set<T, Hash, KeyEqual>::Node* lock_free_unordered_set<T, Hash, KeyEqual>::initBucket(size_t iBucket)
+{
+   size_t iParent = iBucket;
+   for (size_t bit = 1; bit <= iBucket; bit <<= 1)
+      if (iBucket & bit)
+         iParent = iBucket & ~bit;
+   Node* pParent = bucketOf(iParent);
+
+   // marker keys are even and element keys odd, so the key alone matches
+   uint64_t soKey = soBucket(iBucket);
+   Node* pNew = new Node(soKey);
+   std::atomic<uintptr_t>* pPrev;
+   Node* pCur;
+   while (true)
+   {
+      if (search(pParent, soKey, [](Node*) { return true; }, pPrev, pCur))
+      {
+         delete pNew;
+         pNew = pCur;
+         break;
+      }
+      pNew->next.store((uintptr_t)pCur, std::memory_order_relaxed);
+      uintptr_t expected = (uintptr_t)pCur;
+      if (pPrev->compare_exchange_strong(expected, (uintptr_t)pNew))
+         break;
+   }
+
+   // anyone else who got here first stored this same marker
+   Node* pEmpty = nullptr;
+   slotOf(iBucket).compare_exchange_strong(pEmpty, pNew);
+   return pNew;
+}
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: SEARCH
+ * Walk from pStart to the node with soKey that satisfies
+ * match. On the way, finish unlinking any erased node.
+ * Afterwards *pPrev is the link that points to pCur: the
+ * match, or where a new node with soKey would go
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+template <class Match>
+bool lock_free_unordered_set<T, Hash, KeyEqual>::search(Node* pStart, uint64_t soKey, Match match,
+                                                        std::atomic<uintptr_t>*& pPrev, Node*& pCur)
+{
+   bool restart = true;
+   while (restart)
+   {
+      restart = false;
+      pPrev = &pStart->next;
+      pCur = ptrOf(pPrev->load());
+      while (pCur != nullptr)
+      {
+         uintptr_t next = pCur->next.load();
+
+         // the node before us was erased or changed; start over
+         if (pPrev->load() != (uintptr_t)pCur)
+         {
+            restart = true;
+            break;
+         }
+
+         // help the eraser: unlink the marked node and retire it
+         if (isMarked(next))
+         {
+            uintptr_t expected = (uintptr_t)pCur;
+            if (!pPrev->compare_exchange_strong(expected, next & ~MARK))
+            {
+               restart = true;
+               break;
+            }
+            epoch::instance().retire(pCur, &destroyValue);
+            pCur = ptrOf(next);
+            continue;
+         }
+
+         if (pCur->soKey > soKey)
+            return false;
+         if (pCur->soKey == soKey && match(pCur))
+            return true;
+         pPrev = &pCur->next;
+         pCur = ptrOf(next);
+      }
+   }
+   return false;
+}
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: BEGIN and END
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+typename lock_free_unordered_set<T, Hash, KeyEqual>::iterator lock_free_unordered_set<T, Hash, KeyEqual>::begin()
+{
+   iterator it(slotOf(0).load());
+   it.skip();
+   return it;
+}
+template <typename T, typename Hash, typename KeyEqual>
+typename lock_free_unordered_set<T, Hash, KeyEqual>::iterator lock_free_unordered_set<T, Hash, KeyEqual>::end()
+{
+   return iterator();
+}
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: FIND
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+typename lock_free_unordered_set<T, Hash, KeyEqual>::iterator lock_free_unordered_set<T, Hash, KeyEqual>::find(const T& t)
+{
+   epoch::guard guard;
+   size_t hash = hashFunction(t);
+   Node* pBucket = bucketOf(hash & (numBuckets.load() - 1));
+   std::atomic<uintptr_t>* pPrev;
+   Node* pCur;
+   if (search(pBucket, soElement(hash), [&](Node* p) { return keyEqual(valueOf(p), t); },
+              pPrev, pCur))
+      return iterator(pCur);
+   return end();
+}
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: INSERT
+ * Link a new node in where the search stopped. If another
+ * thread changed that link first, search again. The node
+ * is only built once the element is known to be missing
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+template <class Arg>
+custom::pair<typename lock_free_unordered_set<T, Hash, KeyEqual>::iterator, bool> lock_free_unordered_set<T, Hash, KeyEqual>::insertValue(Arg&& arg)
+{
+   epoch::guard guard;
+   size_t hash = hashFunction(arg);
+   uint64_t soKey = soElement(hash);
+   Node* pBucket = bucketOf(hash & (numBuckets.load() - 1));
+
+   // once arg has been moved into the node, compare against the node
+   const T* pKey = &arg;
+   ValueNode* pNew = nullptr;
+   std::atomic<uintptr_t>* pPrev;
+   Node* pCur;
+   while (true)
+   {
+      if (search(pBucket, soKey, [&](Node* p) { return keyEqual(valueOf(p), *pKey); },
+                 pPrev, pCur))
+      {
+         delete pNew;   // never seen by anyone else
+         return custom::pair<iterator, bool>(iterator(pCur), false);
+      }
+
+      if (pNew == nullptr)
+      {
+         pNew = new ValueNode(soKey, std::forward<Arg>(arg));
+         pKey = &pNew->data;
+      }
+      pNew->next.store((uintptr_t)pCur, std::memory_order_relaxed);
+      uintptr_t expected = (uintptr_t)pCur;
+      if (pPrev->compare_exchange_strong(expected, (uintptr_t)pNew))
+         break;
+   }
+
+   // double the buckets when the chains get long. The new buckets
+   // are filled in lazily, the first time each is used
+   size_t num = numElements.fetch_add(1) + 1;
+   size_t numBucketsNow = numBuckets.load();
+   if ((float)num > MAX_LOAD_FACTOR * (float)numBucketsNow &&
+       numBucketsNow < ((size_t)1 << (NUM_SEGMENTS - 2)))
+      numBuckets.compare_exchange_strong(numBucketsNow, numBucketsNow * 2);
+
+   return custom::pair<iterator, bool>(iterator(pNew), true);
+}
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: ERASE
+ * Mark the node, which is the moment it leaves the set,
+ * then try to unlink it. If that fails, a search will
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+size_t lock_free_unordered_set<T, Hash, KeyEqual>::erase(const T& t)
+{
+   epoch::guard guard;
+   size_t hash = hashFunction(t);
+   uint64_t soKey = soElement(hash);
+   Node* pBucket = bucketOf(hash & (numBuckets.load() - 1));
+   auto match = [&](Node* p) { return keyEqual(valueOf(p), t); };
+   std::atomic<uintptr_t>* pPrev;
+   Node* pCur;
+   while (true)
+   {
+      if (!search(pBucket, soKey, match, pPrev, pCur))
+         return 0;
+
+      uintptr_t next = pCur->next.load();
+      if (isMarked(next) ||
+          !pCur->next.compare_exchange_strong(next, next | MARK))
+         continue;   // someone changed it; look again
+
+      numElements.fetch_sub(1);
+      uintptr_t expected = (uintptr_t)pCur;
+      if (pPrev->compare_exchange_strong(expected, next))
+         epoch::instance().retire(pCur, &destroyValue);
+      else
+         search(pBucket, soKey, match, pPrev, pCur);
+      return 1;
+   }
+}
+
+/*****************************************
+ * LOCK FREE UNORDERED SET :: CLEAR
+ * Erase every element, one at a time, so other
+ * threads may keep using the set
+ ****************************************/
+template <typename T, typename Hash, typename KeyEqual>
+void lock_free_unordered_set<T, Hash, KeyEqual>::clear()
+{
+   iterator it = begin();
+   while (it != end())
+   {
+      iterator itErase = it++;
+      erase(*itErase);
+   }
+}
+
+} // namespace custom
@@ -0,0 +1,321 @@
+/***********************************************************************
+ * Header:
+ *    POOL
+ * Summary:
+ *    A node pool for the linked containers. Every list node costs a
+ *    trip through malloc on the way in and another on the way out,
+ *    and a list that churns spends most of its time there. The pool
+ *    carves nodes out of large chunks, keeps the ones given back on
+ *    a free list for the next insert, and returns the chunks to the
+ *    system all at once when the last container using it goes away:
+ *        custom::pool_list<int> queue;     // a list with a pool of its own
+ *
+ *        custom::pool_allocator<int> pool; // several lists, one pool
+ *        custom::list<int, custom::pool_allocator<int>> a(pool), b(pool);
+ *
+ *    A pool is not thread safe; lists sharing one must share a thread.
+ *
+ *    This will contain the definitions of:
+ *        node_pool      : Blocks of one size, carved from chunks
+ *        pool_allocator : An allocator that draws single nodes from a pool
+ *        pool_list      : A list with a pool of its own
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "list.h"      // for custom::list
+#include <memory>      // for std::shared_ptr
+#include <new>         // for ::operator new
+#include <type_traits> // for std::true_type
+#include <cstddef>     // for size_t and std::max_align_t
+#include <cassert>
+
+class TestPool;        // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * NODE POOL
+ * Hands out blocks of one size. Fresh chunks are carved
+ * a block at a time as they are needed, so a chunk that
+ * is never used all the way is never touched all the way.
+ * Each chunk is twice the size of the last, up to a limit
+ ************************************************/
+class node_pool
+{
+   friend class ::TestPool;   // give unit tests access to the privates
+
+public:
+   explicit node_pool(size_t blockSize = 0) :
+      blockSize(0), numNextChunk(FIRST_CHUNK), numOutstanding(0),
+      pFree(nullptr), pChunks(nullptr), pCarve(nullptr), pCarveEnd(nullptr)
+   {
+      if (blockSize)
+         set_block_size(blockSize);
+   }
+   node_pool(const node_pool&) = delete;
+   node_pool& operator=(const node_pool&) = delete;
+   ~node_pool()
+   {
+      release();
+   }
+
+   //
+   // Access
+   //
+   void* allocate();
+   void deallocate(void* p);
+   void release();
+
+   //
+   // Status
+   //
+   size_t block_size() const       { return blockSize; }
+   void set_block_size(size_t size);
+   size_t num_outstanding() const  { return numOutstanding; }
+   size_t num_chunks() const;
+
+   // the block size that would serve objects of size bytes
+   static size_t round(size_t size)
+   {
+      const size_t ALIGN = alignof(Block);
+      if (size < sizeof(Block))
+         size = sizeof(Block);
+      return (size + ALIGN - 1) / ALIGN * ALIGN;
+   }
+
+private:
+   static const size_t FIRST_CHUNK = 32;     // blocks in the first chunk
+   static const size_t MAX_CHUNK = 4096;     // most blocks in any chunk
+
+   // a block on the free list holds the next free block
+   struct Block
+   {
+      Block* pNext;
+   };
+
+   // a chunk starts with this, and the blocks follow it
+   struct alignas(std::max_align_t) Chunk
+   {
+      Chunk* pNext;
+   };
+
+   void grow();
+
+   size_t blockSize;        // bytes in every block
+   size_t numNextChunk;     // blocks the next chunk will hold
+   size_t numOutstanding;   // blocks handed out and not given back
+   Block* pFree;            // blocks given back, most recent first
+   Chunk* pChunks;          // every chunk, newest first
+   char* pCarve;            // the next never-used block in the newest chunk
+   char* pCarveEnd;         // the end of the newest chunk
+};
+
+/*****************************************
+ * NODE POOL :: SET BLOCK SIZE
+ * Fix the size of a block. Every block must hold a free
+ * list link and keep the next one aligned
+ ****************************************/
+inline void node_pool::set_block_size(size_t size)
+{
+   assert(blockSize == 0 || blockSize == round(size));
+   blockSize = round(size);
+}
+
+/*****************************************
+ * NODE POOL :: ALLOCATE
+ * A block given back if there is one, else the next
+ * block of the newest chunk, else a new chunk
+ ****************************************/
+inline void* node_pool::allocate()
+{
+   assert(blockSize != 0);
+   numOutstanding++;
+
+   if (pFree)
+   {
+      Block* pBlock = pFree;
+      pFree = pFree->pNext;
+      return pBlock;
+   }
+
+   if (pCarve == pCarveEnd)
+      grow();
+   void* p = pCarve;
+   pCarve += blockSize;
+   return p;
+}
+
+/*****************************************
+ * NODE POOL :: DEALLOCATE
+ * Keep the block for the next allocate. Nothing goes
+ * back to the system until release()
+ ****************************************/
+inline void node_pool::deallocate(void* p)
+{
+   assert(numOutstanding > 0);
+   numOutstanding--;
+
+   Block* pBlock = static_cast<Block*>(p);
+   pBlock->pNext = pFree;
+   pFree = pBlock;
+}
+
+/*****************************************
+ * NODE POOL :: RELEASE
+ * Give every chunk back to the system in one pass.
+ * Every block must already have been given back
+ ****************************************/
+inline void node_pool::release()
+{
+   assert(numOutstanding == 0);
+   while (pChunks)
+   {
+      Chunk* pNext = pChunks->pNext;
+      ::operator delete(pChunks);
+      pChunks = pNext;
+   }
+   pFree = nullptr;
+   pCarve = pCarveEnd = nullptr;
+   numNextChunk = FIRST_CHUNK;
+}
+
+/*****************************************
+ * NODE POOL :: NUM CHUNKS
+ * How many chunks we have from the system
+ ****************************************/
+inline size_t node_pool::num_chunks() const
+{
+   size_t num = 0;
+   for (Chunk* p = pChunks; p; p = p->pNext)
+      num++;
+   return num;
+}
+
+/*****************************************
+ * NODE POOL :: GROW
+ * Get a new chunk from the system. The rest of the
+ * old one, if any, is already on the free list or
+ * handed out, so carving moves to the new one
+ ****************************************/
+inline void node_pool::grow()
+{
+   Chunk* pChunk = static_cast<Chunk*>(
+      ::operator new(sizeof(Chunk) + numNextChunk * blockSize));
+   pChunk->pNext = pChunks;
+   pChunks = pChunk;
+
+   pCarve = reinterpret_cast<char*>(pChunk + 1);
+   pCarveEnd = pCarve + numNextChunk * blockSize;
+   if (numNextChunk < MAX_CHUNK)
+      numNextChunk *= 2;
+}
+
+/************************************************
+ * POOL ALLOCATOR
+ * An allocator whose single-object requests come from
+ * a node_pool. The pool is shared by every copy of the
+ * allocator, including the copies rebound to the node
+ * type, and lives until the last of them is gone. A
+ * list copy gets a pool of its own, and the pool moves
+ * along with the nodes when a list is moved or swapped.
+ *
+ * The pool serves the first size asked of it. Arrays,
+ * and any object of another size, go to the system
+ ************************************************/
+template <class T>
+class pool_allocator
+{
+   friend class ::TestPool;   // give unit tests access to the privates
+   template <class U>
+   friend class pool_allocator;
+
+public:
+   typedef T value_type;
+   typedef std::true_type  propagate_on_container_move_assignment;
+   typedef std::true_type  propagate_on_container_swap;
+   typedef std::false_type propagate_on_container_copy_assignment;
+   template <class U>
+   struct rebind
+   {
+      typedef pool_allocator<U> other;
+   };
+
+   //
+   // Construct
+   //
+   pool_allocator() : pPool(std::make_shared<node_pool>()) {}
+   pool_allocator(const pool_allocator& rhs) : pPool(rhs.pPool) {}
+   template <class U>
+   pool_allocator(const pool_allocator<U>& rhs) : pPool(rhs.pPool) {}
+
+   // a moved-from allocator must still work, so a move is a copy
+   pool_allocator& operator=(const pool_allocator& rhs)
+   {
+      pPool = rhs.pPool;
+      return *this;
+   }
+
+   // a copy of a container starts a pool of its own
+   pool_allocator select_on_container_copy_construction() const
+   {
+      return pool_allocator();
+   }
+
+   //
+   // Access
+   //
+   T* allocate(size_t num)
+   {
+      if (!pooled(num))
+         return static_cast<T*>(::operator new(num * sizeof(T)));
+      return static_cast<T*>(pPool->allocate());
+   }
+   void deallocate(T* p, size_t num)
+   {
+      if (!pooled(num))
+         ::operator delete(p);
+      else
+         pPool->deallocate(p);
+   }
+
+   const node_pool& pool() const
+   {
+      return *pPool;
+   }
+
+   //
+   // Compare
+   //
+   template <class U>
+   bool operator==(const pool_allocator<U>& rhs) const { return pPool == rhs.pPool; }
+   template <class U>
+   bool operator!=(const pool_allocator<U>& rhs) const { return pPool != rhs.pPool; }
+
+private:
+   // does a request for num objects go to the pool? The first
+   // single object sets the block size. A block is a multiple of
+   // the alignment of any T that rounds up to exactly its size
+   bool pooled(size_t num) const
+   {
+      if (num != 1 || alignof(T) > alignof(std::max_align_t))
+         return false;
+      if (pPool->block_size() == 0)
+         pPool->set_block_size(sizeof(T));
+      return pPool->block_size() == node_pool::round(sizeof(T));
+   }
+
+   std::shared_ptr<node_pool> pPool;
+};
+
+/************************************************
+ * POOL LIST
+ * A list whose nodes come from a pool of its own
+ ************************************************/
+template <class T>
+using pool_list = list<T, pool_allocator<T> >;
+
+} // namespace custom
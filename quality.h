@@ -0,0 +1,248 @@
+/***********************************************************************
+ * Header:
+ *    QUALITY
+ * Summary:
+ *    Measure how well a hasher spreads a sample of real keys before
+ *    we pick it for an unordered_set. For each bucket count we look
+ *    at how evenly the keys land compared to what a truly random
+ *    hash would do, and for the hash itself whether every output bit
+ *    is used and whether changing one key bit changes about half of
+ *    them. Run it against a dump of production keys:
+ *        std::vector<size_t> keys = ...;
+ *        custom::analyze_hash(keys.begin(), keys.end(), Hash()).print(std::cout);
+ *
+ *    This will contain the definitions of:
+ *        bucket_quality : How evenly the keys fill one bucket count
+ *        hash_quality   : Everything measured about a hasher
+ *        analyze_hash   : Measure a hasher over a range of keys
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include <vector>      // for std::vector
+#include <algorithm>   // for std::sort and std::max
+#include <ostream>     // for std::ostream
+#include <iomanip>     // for std::setw
+#include <cmath>       // for std::pow and std::fabs
+#include <climits>     // for CHAR_BIT
+#include <type_traits> // for std::is_integral
+#include <cstddef>     // for size_t
+
+namespace custom
+{
+
+/************************************************
+ * BUCKET QUALITY
+ * The keys dropped into numBuckets buckets with
+ * hash % numBuckets, as unordered_set does
+ ************************************************/
+struct bucket_quality
+{
+   size_t numBuckets;       // bucket count measured
+   size_t longestChain;     // most keys in any one bucket
+   size_t numEmpty;         // buckets with no key
+   size_t numCollisions;    // keys that are not alone in their bucket's first slot
+   double variance;         // variance of the keys per bucket
+   double varianceRandom;   // what a random hash would give on average
+   double expectedCollisions; // what a random hash would give on average
+
+   // 1.0 is as even as random; much more than that is clustering
+   double varianceRatio() const
+   {
+      return varianceRandom > 0.0 ? variance / varianceRandom : 1.0;
+   }
+};
+
+/************************************************
+ * HASH QUALITY
+ * The report. Scores for bias and avalanche run from
+ * 0.0 (ideal) to 0.5 (a bit that never changes)
+ ************************************************/
+struct hash_quality
+{
+   // worse than these and we recommend a mixing finalizer
+   static constexpr double MAX_VARIANCE_RATIO = 2.0;
+   static constexpr double MAX_BIT_BIAS       = 0.1;
+   static constexpr double MAX_AVALANCHE      = 0.1;
+
+   size_t numKeys;          // keys in the sample
+   size_t numSameHash;      // keys whose full hash equals another key's
+   double bitBias;          // worst |P(output bit is 1) - 1/2| over every bit
+   double avalanche;        // worst |P(output bit flips) - 1/2| over every
+                            // key bit and output bit; -1 when not measured
+   std::vector<bucket_quality> buckets;
+
+   bool needsMixing() const
+   {
+      for (size_t i = 0; i < buckets.size(); i++)
+         if (buckets[i].varianceRatio() > MAX_VARIANCE_RATIO)
+            return true;
+      return bitBias > MAX_BIT_BIAS || avalanche > MAX_AVALANCHE;
+   }
+
+   void print(std::ostream& os) const;
+};
+
+/*****************************************
+ * HASH QUALITY :: PRINT
+ * One line per bucket count, then the scores of the hash
+ ****************************************/
+inline void hash_quality::print(std::ostream& os) const
+{
+   os << numKeys << " keys, " << numSameHash << " share a full hash\n";
+   os << std::setw(10) << "buckets"   << std::setw(10) << "longest"
+      << std::setw(10) << "empty"     << std::setw(12) << "collisions"
+      << std::setw(12) << "(random)"  << std::setw(12) << "variance"
+      << std::setw(12) << "x random"  << "\n";
+   for (size_t i = 0; i < buckets.size(); i++)
+      os << std::fixed << std::setprecision(2)
+         << std::setw(10) << buckets[i].numBuckets
+         << std::setw(10) << buckets[i].longestChain
+         << std::setw(10) << buckets[i].numEmpty
+         << std::setw(12) << buckets[i].numCollisions
+         << std::setw(12) << buckets[i].expectedCollisions
+         << std::setw(12) << buckets[i].variance
+         << std::setw(12) << buckets[i].varianceRatio() << "\n";
+   os << "bit bias " << bitBias << ", avalanche ";
+   if (avalanche < 0.0)
+      os << "not measured";
+   else
+      os << avalanche;
+   os << "\n" << (needsMixing() ? "a mixing finalizer is recommended"
+                                : "no mixing finalizer needed") << "\n";
+}
+
+/*****************************************
+ * MEASURE BUCKETS
+ * Drop every hash into numBuckets buckets and compare the
+ * spread with a random hash: the keys per bucket would then
+ * be binomial, with variance n/m (1 - 1/m), and the number of
+ * occupied buckets would be m (1 - (1 - 1/m)^n)
+ ****************************************/
+inline bucket_quality measureBuckets(const std::vector<size_t>& hashes, size_t numBuckets)
+{
+   bucket_quality bq = {};
+   bq.numBuckets = numBuckets;
+   std::vector<size_t> counts(numBuckets);
+   for (size_t i = 0; i < hashes.size(); i++)
+      counts[hashes[i] % numBuckets]++;
+
+   double n = (double)hashes.size();
+   double m = (double)numBuckets;
+   double mean = n / m;
+   for (size_t i = 0; i < numBuckets; i++)
+   {
+      bq.longestChain = std::max(bq.longestChain, counts[i]);
+      if (counts[i] == 0)
+         bq.numEmpty++;
+      bq.variance += ((double)counts[i] - mean) * ((double)counts[i] - mean);
+   }
+   bq.variance /= m;
+   bq.numCollisions = hashes.size() - (numBuckets - bq.numEmpty);
+   bq.varianceRandom = mean * (1.0 - 1.0 / m);
+   bq.expectedCollisions = n - m * (1.0 - std::pow(1.0 - 1.0 / m, n));
+   return bq;
+}
+
+/*****************************************
+ * MEASURE AVALANCHE
+ * For integer keys, flip each key bit in turn and count how
+ * often each output bit flips with it. A good hash flips every
+ * output bit half the time. Other keys cannot be flipped a bit
+ * at a time, so they are not measured
+ ****************************************/
+template <class Iterator, class Hash>
+double measureAvalanche(Iterator first, Iterator last, Hash& hash, std::true_type)
+{
+   typedef typename std::decay<decltype(*first)>::type Key;
+   const size_t KEY_BITS = sizeof(Key) * CHAR_BIT;
+   const size_t HASH_BITS = sizeof(size_t) * CHAR_BIT;
+   const size_t MAX_SAMPLE = 1024;   // plenty for a two-decimal score
+
+   std::vector<size_t> flips(KEY_BITS * HASH_BITS);
+   size_t numSample = 0;
+   for (Iterator it = first; it != last && numSample < MAX_SAMPLE; ++it, ++numSample)
+   {
+      Key key = *it;
+      size_t h = hash(key);
+      for (size_t iKey = 0; iKey < KEY_BITS; iKey++)
+      {
+         Key keyFlipped = (Key)((unsigned long long)key ^ (1ull << iKey));
+         size_t diff = h ^ (size_t)hash(keyFlipped);
+         for (size_t iHash = 0; iHash < HASH_BITS; iHash++)
+            flips[iKey * HASH_BITS + iHash] += (diff >> iHash) & 1;
+      }
+   }
+
+   double worst = 0.0;
+   for (size_t i = 0; numSample && i < flips.size(); i++)
+      worst = std::max(worst, std::fabs((double)flips[i] / (double)numSample - 0.5));
+   return worst;
+}
+template <class Iterator, class Hash>
+double measureAvalanche(Iterator, Iterator, Hash&, std::false_type)
+{
+   return -1.0;
+}
+
+/*****************************************
+ * ANALYZE HASH
+ * Measure hash over the keys in [first, last), which should be
+ * distinct. With no bucket counts given, we measure the 10 that
+ * an empty unordered_set starts with, the count it would grow
+ * to for all these keys, and the power of two the flat sets would
+ * use, since those pick a slot from the low bits alone
+ ****************************************/
+template <class Iterator, class Hash>
+hash_quality analyze_hash(Iterator first, Iterator last, Hash hash,
+                          std::vector<size_t> bucketCounts = std::vector<size_t>())
+{
+   hash_quality hq;
+   std::vector<size_t> hashes;
+   for (Iterator it = first; it != last; ++it)
+      hashes.push_back(hash(*it));
+   hq.numKeys = hashes.size();
+
+   if (bucketCounts.empty())
+   {
+      size_t numGrown = 10;
+      while (numGrown < hq.numKeys)
+         numGrown *= 2;
+      size_t numPower = 16;
+      while (numPower < hq.numKeys)
+         numPower *= 2;
+      bucketCounts.push_back(10);
+      if (numGrown != 10)
+         bucketCounts.push_back(numGrown);
+      bucketCounts.push_back(numPower);
+   }
+   for (size_t i = 0; i < bucketCounts.size(); i++)
+      hq.buckets.push_back(measureBuckets(hashes, bucketCounts[i]));
+
+   // bias: how far each output bit is from being set half the time
+   const size_t HASH_BITS = sizeof(size_t) * CHAR_BIT;
+   hq.bitBias = 0.0;
+   for (size_t iBit = 0; iBit < HASH_BITS && hq.numKeys; iBit++)
+   {
+      size_t numOnes = 0;
+      for (size_t i = 0; i < hashes.size(); i++)
+         numOnes += (hashes[i] >> iBit) & 1;
+      hq.bitBias = std::max(hq.bitBias,
+                            std::fabs((double)numOnes / (double)hq.numKeys - 0.5));
+   }
+
+   // keys sharing a full hash collide at every bucket count
+   std::sort(hashes.begin(), hashes.end());
+   hq.numSameHash = 0;
+   for (size_t i = 1; i < hashes.size(); i++)
+      if (hashes[i] == hashes[i - 1])
+         hq.numSameHash += (i == 1 || hashes[i - 1] != hashes[i - 2]) ? 2 : 1;
+
+   hq.avalanche = measureAvalanche(first, last, hash,
+      std::is_integral<typename std::decay<decltype(*first)>::type>());
+   return hq;
+}
+
+} // namespace custom
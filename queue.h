@@ -0,0 +1,319 @@
+/***********************************************************************
+ * Header:
+ *    QUEUE
+ * Summary:
+ *    A queue any number of threads can push onto while one thread
+ *    pops, with no lock. It is Vyukov's multi-producer single-consumer
+ *    queue: a singly linked list of nodes like those of list, less the
+ *    back link, which a queue never follows. A producer claims the
+ *    tail with one atomic exchange and then links its node in behind
+ *    the old tail. The consumer owns the head outright, so popping
+ *    needs no atomic read-modify-write at all.
+ *
+ *    A producer stopped between its exchange and its link hides the
+ *    nodes pushed after it until it resumes, so try_pop can fail for a
+ *    moment while the queue is not empty. It never blocks.
+ *
+ *    The consumer owns every node it has popped, so nodes need no
+ *    deferred reclamation: they go straight back to node_recycler to
+ *    be pushed again.
+ *
+ *    This will contain the class definitions of:
+ *        node_recycler          : Free nodes, cached per thread
+ *        mpsc_queue             : The queue
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>     // for std::atomic
+#include <new>        // for std::nothrow and placement new
+#include <utility>    // for std::move and std::forward
+#include <cstddef>    // for size_t
+
+class TestQueue;      // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * NODE RECYCLER
+ * Spare nodes of one type. Each thread keeps its own
+ * chain, so getting or giving back a node is a couple of
+ * pointer moves. Nodes flow from producers to the
+ * consumer, so the consumer's chain is handed on to a
+ * shared stack every BATCH nodes, and a producer that
+ * runs dry takes that whole stack. Taking all of it with
+ * one exchange is what keeps the stack free of ABA.
+ * Node needs only a std::atomic<Node*> pNext
+ ************************************************/
+template <class Node>
+class node_recycler
+{
+   friend class ::TestQueue;   // give unit tests access to the privates
+public:
+   static Node* acquire();
+   static void release(Node* pNode);
+
+private:
+   static const size_t BATCH = 64;
+
+   // a chain of spare nodes; what is left goes when the chain does
+   struct chain
+   {
+      chain() : pHead(nullptr), num(0) {}
+     ~chain()
+      {
+         destroy(pHead);
+      }
+      Node* pHead;
+      size_t num;     // given back since this chain was last handed on
+   };
+   struct stack
+   {
+      stack() : pHead(nullptr) {}
+     ~stack()
+      {
+         destroy(pHead.load());
+      }
+      std::atomic<Node*> pHead;
+   };
+
+   static chain& local()
+   {
+      static thread_local chain spares;
+      return spares;
+   }
+   static stack& shared()
+   {
+      static stack spares;
+      return spares;
+   }
+   static void destroy(Node* pNode)
+   {
+      while (pNode)
+      {
+         Node* pNext = pNode->pNext.load(std::memory_order_relaxed);
+         ::operator delete(pNode);
+         pNode = pNext;
+      }
+   }
+};
+
+/*****************************************
+ * NODE RECYCLER :: ACQUIRE
+ * Raw storage for one node: a spare from this thread,
+ * else every spare the other threads have handed on,
+ * else a new one. nullptr if there is no memory
+ ****************************************/
+template <class Node>
+Node* node_recycler<Node>::acquire()
+{
+   chain& spares = local();
+   if (spares.pHead == nullptr)
+      spares.pHead = shared().pHead.exchange(nullptr, std::memory_order_acquire);
+   if (spares.pHead == nullptr)
+      return static_cast<Node*>(::operator new(sizeof(Node), std::nothrow));
+
+   Node* pNode = spares.pHead;
+   spares.pHead = pNode->pNext.load(std::memory_order_relaxed);
+   return pNode;
+}
+
+/*****************************************
+ * NODE RECYCLER :: RELEASE
+ * Keep the storage of a node whose contents are gone
+ ****************************************/
+template <class Node>
+void node_recycler<Node>::release(Node* pNode)
+{
+   chain& spares = local();
+   pNode->pNext.store(spares.pHead, std::memory_order_relaxed);
+   spares.pHead = pNode;
+   if (++spares.num < BATCH)
+      return;
+
+   // hand the whole chain on for the producers
+   Node* pLast = spares.pHead;
+   for (Node* pNext; (pNext = pLast->pNext.load(std::memory_order_relaxed)) != nullptr; )
+      pLast = pNext;
+   std::atomic<Node*>& pTop = shared().pHead;
+   Node* pOld = pTop.load(std::memory_order_relaxed);
+   do
+      pLast->pNext.store(pOld, std::memory_order_relaxed);
+   while (!pTop.compare_exchange_weak(pOld, spares.pHead,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed));
+   spares.pHead = nullptr;
+   spares.num = 0;
+}
+
+/************************************************
+ * MPSC QUEUE
+ * A first-in first-out queue. try_push, emplace and
+ * their kin may be called from any thread at once;
+ * try_pop, pop_all and empty from only one thread at
+ * a time
+ ************************************************/
+template <class T>
+class mpsc_queue
+{
+   friend class ::TestQueue;   // give unit tests access to the privates
+
+   // one element: the data and the link to the one pushed after it
+   struct Node
+   {
+      T* data() { return reinterpret_cast<T*>(storage); }
+      std::atomic<Node*> pNext;
+      alignas(T) unsigned char storage[sizeof(T)];
+   };
+   typedef node_recycler<Node> recycler;
+
+public:
+   //
+   // Construct
+   //
+   mpsc_queue();
+   mpsc_queue(const mpsc_queue&) = delete;
+   mpsc_queue& operator = (const mpsc_queue&) = delete;
+  ~mpsc_queue();
+
+   //
+   // Insert. false if there was no memory for the node
+   //
+   bool try_push(const T& t)   { return emplace(t);            }
+   bool try_push(T&& t)        { return emplace(std::move(t)); }
+   template <class... Args>
+   bool emplace(Args&&... args);
+
+   //
+   // Remove. Consumer only
+   //
+   bool try_pop(T& t);
+   template <class Visit>
+   size_t pop_all(Visit visit);
+
+   //
+   // Status. Consumer only
+   //
+   bool empty() const
+   {
+      return pHead->pNext.load(std::memory_order_acquire) == nullptr;
+   }
+
+private:
+   // retire the old head, whose data is already gone
+   void advance(Node* pNext)
+   {
+      Node* pOld = pHead;
+      pHead = pNext;
+      recycler::release(pOld);
+   }
+
+   // the consumer's end: a node whose data has been taken
+   alignas(64) Node* pHead;
+   // the producers' end: the last node pushed
+   alignas(64) std::atomic<Node*> pTail;
+};
+
+/*****************************************
+ * MPSC QUEUE :: CONSTRUCTOR
+ * Head and tail both start at a node with no data
+ ****************************************/
+template <class T>
+mpsc_queue<T>::mpsc_queue()
+{
+   Node* pStub = recycler::acquire();
+   if (pStub == nullptr)
+      throw "ERROR: unable to allocate a new node for a queue";
+   pStub->pNext.store(nullptr, std::memory_order_relaxed);
+   pHead = pStub;
+   pTail.store(pStub, std::memory_order_relaxed);
+}
+
+/*****************************************
+ * MPSC QUEUE :: DESTRUCTOR
+ * No one is pushing any more. Destroy what is left
+ ****************************************/
+template <class T>
+mpsc_queue<T>::~mpsc_queue()
+{
+   Node* pNext;
+   while ((pNext = pHead->pNext.load(std::memory_order_acquire)) != nullptr)
+   {
+      pNext->data()->~T();
+      advance(pNext);
+   }
+   recycler::release(pHead);
+}
+
+/*****************************************
+ * MPSC QUEUE :: EMPLACE
+ * Build the element in a node, claim the tail, then
+ * link the old tail to it. The consumer cannot see the
+ * node until the link is stored
+ ****************************************/
+template <class T>
+template <class... Args>
+bool mpsc_queue<T>::emplace(Args&&... args)
+{
+   Node* pNode = recycler::acquire();
+   if (pNode == nullptr)
+      return false;
+   try
+   {
+      new (pNode->data()) T(std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      recycler::release(pNode);
+      throw;
+   }
+   pNode->pNext.store(nullptr, std::memory_order_relaxed);
+
+   Node* pPrev = pTail.exchange(pNode, std::memory_order_acq_rel);
+   pPrev->pNext.store(pNode, std::memory_order_release);
+   return true;
+}
+
+/*****************************************
+ * MPSC QUEUE :: TRY POP
+ * Move the oldest element into t. The node it was in
+ * becomes the new head
+ ****************************************/
+template <class T>
+bool mpsc_queue<T>::try_pop(T& t)
+{
+   Node* pNext = pHead->pNext.load(std::memory_order_acquire);
+   if (pNext == nullptr)
+      return false;
+
+   t = std::move(*pNext->data());
+   pNext->data()->~T();
+   advance(pNext);
+   return true;
+}
+
+/*****************************************
+ * MPSC QUEUE :: POP ALL
+ * Hand every element there is now to visit, oldest
+ * first, and return how many there were
+ ****************************************/
+template <class T>
+template <class Visit>
+size_t mpsc_queue<T>::pop_all(Visit visit)
+{
+   size_t num = 0;
+   Node* pNext;
+   while ((pNext = pHead->pNext.load(std::memory_order_acquire)) != nullptr)
+   {
+      visit(std::move(*pNext->data()));
+      pNext->data()->~T();
+      advance(pNext);
+      num++;
+   }
+   return num;
+}
+
+} // namespace custom
@@ -0,0 +1,474 @@
+/***********************************************************************
+ * Header:
+ *    SMALL
+ * Summary:
+ *    A set for the common case of a handful of elements. Most of our
+ *    sets never hold more than a few, yet an unordered_set allocates
+ *    a bucket array when it is built and a node for every element.
+ *    This one keeps up to N elements in an array inside the object
+ *    and finds them by comparing against each in turn, which for a
+ *    few keys costs less than hashing one. Building one allocates
+ *    nothing. Insert element N + 1 and it moves everything into an
+ *    unordered_set on the heap and behaves as one from then on:
+ *        custom::small_unordered_set<int> ids;        // up to 8 inline
+ *        custom::small_unordered_set<std::string, 4> tags;
+ *
+ *    This will contain the class definition of:
+ *        small_unordered_set           : A set that starts out inline
+ *        small_unordered_set::iterator : An iterator through the set
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "hash.h"     // for custom::unordered_set, the hashed form
+#include "pair.h"     // for custom::pair
+#include <functional> // for std::hash and std::equal_to
+#include <new>        // for placement new
+#include <utility>    // for std::move and std::forward
+#include <cstddef>    // for size_t
+#include <cassert>
+
+class TestSmall;            // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * SMALL UNORDERED SET
+ * Up to N elements inline and unordered; past that,
+ * an unordered_set. Like unordered_set the elements
+ * may not be changed through an iterator, and any
+ * insert or erase invalidates every iterator
+ ************************************************/
+template <typename T,
+          size_t N = 8,
+          typename Hash = std::hash<T>,
+          typename KeyEqual = std::equal_to<T> >
+class small_unordered_set
+{
+   friend class ::TestSmall;   // give unit tests access to the privates
+
+public:
+   typedef custom::unordered_set<T, Hash, KeyEqual> hashed_type;
+
+   //
+   // Construct
+   //
+   small_unordered_set(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual()) :
+      pHash(nullptr), numInline(0), hashFunction(hash), keyEqual(equal)
+   {
+   }
+   small_unordered_set(const small_unordered_set& rhs) :
+      small_unordered_set(rhs.hashFunction, rhs.keyEqual)
+   {
+      *this = rhs;
+   }
+   small_unordered_set(small_unordered_set&& rhs) :
+      small_unordered_set(rhs.hashFunction, rhs.keyEqual)
+   {
+      *this = std::move(rhs);
+   }
+   template <class Iterator>
+   small_unordered_set(Iterator first, Iterator last) : small_unordered_set()
+   {
+      insert(first, last);
+   }
+   small_unordered_set(const std::initializer_list<T>& il) : small_unordered_set()
+   {
+      insert(il);
+   }
+   ~small_unordered_set()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+   small_unordered_set& operator=(const small_unordered_set& rhs);
+   small_unordered_set& operator=(small_unordered_set&& rhs);
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end() const;
+
+   //
+   // Access
+   //
+   iterator find(const T& t) const;
+   bool contains(const T& t) const
+   {
+      return find(t) != end();
+   }
+   size_t count(const T& t) const
+   {
+      return contains(t) ? 1 : 0;
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T& t)
+   {
+      return insertKey(t);
+   }
+   custom::pair<iterator, bool> insert(T&& t)
+   {
+      return insertKey(std::move(t));
+   }
+   void insert(const std::initializer_list<T>& il)
+   {
+      insert(il.begin(), il.end());
+   }
+   template <class Iterator>
+   void insert(Iterator first, Iterator last)
+   {
+      for (; first != last; ++first)
+         insert(*first);
+   }
+   void reserve(size_t num);
+
+   //
+   // Remove
+   //
+   size_t erase(const T& t);
+   void clear() noexcept;
+
+   //
+   // Status
+   //
+   size_t size() const
+   {
+      return pHash ? pHash->size() : numInline;
+   }
+   bool empty() const
+   {
+      return size() == 0;
+   }
+   bool is_small() const
+   {
+      return pHash == nullptr;
+   }
+   static constexpr size_t inline_capacity()
+   {
+      return N;
+   }
+   Hash     hash_function() const { return hashFunction; }
+   KeyEqual key_eq()        const { return keyEqual;     }
+
+private:
+   T* elements()             { return reinterpret_cast<T*>(storage);       }
+   const T* elements() const { return reinterpret_cast<const T*>(storage); }
+
+   template <class U>
+   custom::pair<iterator, bool> insertKey(U&& t);
+   size_t findInline(const T& t) const;
+   void promote(size_t num);
+   void destroyInline();
+
+   alignas(T) unsigned char storage[N * sizeof(T)]; // the first numInline are live
+   hashed_type* pHash;       // the hashed form, or nullptr while small
+   size_t numInline;         // elements in storage while small
+   Hash hashFunction;
+   KeyEqual keyEqual;
+};
+
+/************************************************
+ * SMALL UNORDERED SET ITERATOR
+ * Either a pointer into the inline array or an
+ * iterator into the hashed form
+ ************************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+class small_unordered_set <T, N, Hash, KeyEqual> ::iterator
+{
+   friend class ::TestSmall;   // give unit tests access to the privates
+   template <class TT, size_t NN, class HH, class EE>
+   friend class custom::small_unordered_set;
+
+public:
+   iterator() : p(nullptr), itHash()
+   {
+   }
+   iterator(const T* p) : p(p), itHash()
+   {
+   }
+   iterator(const typename hashed_type::iterator& itHash) : p(nullptr), itHash(itHash)
+   {
+   }
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const
+   {
+      return p == rhs.p && itHash == rhs.itHash;
+   }
+   bool operator != (const iterator& rhs) const
+   {
+      return !(*this == rhs);
+   }
+
+   //
+   // Access
+   //
+   const T& operator * () const
+   {
+      return p ? *p : *itHash;
+   }
+   const T* operator -> () const
+   {
+      return &**this;
+   }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ()
+   {
+      if (p)
+         ++p;
+      else
+         ++itHash;
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator itReturn(*this);
+      ++*this;
+      return itReturn;
+   }
+
+private:
+   const T* p;                                    // while small
+   mutable typename hashed_type::iterator itHash; // once promoted
+};
+
+/*****************************************
+ * SMALL UNORDERED SET :: BEGIN / END
+ * An empty inline array gives a null pointer to both,
+ * which then compare equal to each other
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+typename small_unordered_set <T, N, Hash, KeyEqual> ::iterator
+small_unordered_set <T, N, Hash, KeyEqual> ::begin() const
+{
+   if (pHash)
+      return iterator(pHash->begin());
+   return iterator(numInline ? elements() : nullptr);
+}
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+typename small_unordered_set <T, N, Hash, KeyEqual> ::iterator
+small_unordered_set <T, N, Hash, KeyEqual> ::end() const
+{
+   if (pHash)
+      return iterator(pHash->end());
+   return iterator(numInline ? elements() + numInline : nullptr);
+}
+
+/*****************************************
+ * SMALL UNORDERED SET :: FIND INLINE
+ * The index of t in the inline array, or numInline.
+ * With N this small a linear scan beats hashing
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+size_t small_unordered_set <T, N, Hash, KeyEqual> ::findInline(const T& t) const
+{
+   const T* pElements = elements();
+   size_t i = 0;
+   while (i < numInline && !keyEqual(pElements[i], t))
+      i++;
+   return i;
+}
+
+/*****************************************
+ * SMALL UNORDERED SET :: FIND
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+typename small_unordered_set <T, N, Hash, KeyEqual> ::iterator
+small_unordered_set <T, N, Hash, KeyEqual> ::find(const T& t) const
+{
+   if (pHash)
+      return iterator(pHash->find(t));
+   size_t i = findInline(t);
+   return i == numInline ? end() : iterator(elements() + i);
+}
+
+/*****************************************
+ * SMALL UNORDERED SET :: INSERT KEY
+ * Append to the inline array while there is room.
+ * The element that does not fit promotes the set
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+template <class U>
+custom::pair<typename small_unordered_set <T, N, Hash, KeyEqual> ::iterator, bool>
+small_unordered_set <T, N, Hash, KeyEqual> ::insertKey(U&& t)
+{
+   if (!pHash)
+   {
+      size_t i = findInline(t);
+      if (i != numInline)
+         return custom::pair<iterator, bool>(iterator(elements() + i), false);
+      if (numInline < N)
+      {
+         new (elements() + numInline) T(std::forward<U>(t));
+         numInline++;
+         return custom::pair<iterator, bool>(iterator(elements() + i), true);
+      }
+      promote(N + 1);
+   }
+
+   auto result = pHash->insert(std::forward<U>(t));
+   return custom::pair<iterator, bool>(iterator(result.first), result.second);
+}
+
+/*****************************************
+ * SMALL UNORDERED SET :: PROMOTE
+ * Move the inline elements into a new unordered_set with
+ * room for num, and use that from now on
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+void small_unordered_set <T, N, Hash, KeyEqual> ::promote(size_t num)
+{
+   assert(pHash == nullptr);
+   hashed_type* pHashNew = new hashed_type(hashFunction, keyEqual);
+   try
+   {
+      pHashNew->reserve(num);
+      T* pElements = elements();
+      for (size_t i = 0; i < numInline; i++)
+         pHashNew->insert(std::move(pElements[i]));
+   }
+   catch (...)
+   {
+      delete pHashNew;
+      throw;
+   }
+   destroyInline();
+   pHash = pHashNew;
+}
+
+/*****************************************
+ * SMALL UNORDERED SET :: RESERVE
+ * Room for num elements. More than fit inline promotes the
+ * set now rather than on the insert that overflows it
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+void small_unordered_set <T, N, Hash, KeyEqual> ::reserve(size_t num)
+{
+   if (pHash)
+      pHash->reserve(num);
+   else if (num > N)
+      promote(num);
+}
+
+/*****************************************
+ * SMALL UNORDERED SET :: ERASE
+ * While small, the last element moves into the hole.
+ * Once promoted the set stays hashed until clear()
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+size_t small_unordered_set <T, N, Hash, KeyEqual> ::erase(const T& t)
+{
+   if (pHash)
+   {
+      size_t numBefore = pHash->size();
+      pHash->erase(t);
+      return numBefore - pHash->size();
+   }
+
+   size_t i = findInline(t);
+   if (i == numInline)
+      return 0;
+   T* pElements = elements();
+   if (i != numInline - 1)
+      pElements[i] = std::move(pElements[numInline - 1]);
+   pElements[numInline - 1].~T();
+   numInline--;
+   return 1;
+}
+
+/*****************************************
+ * SMALL UNORDERED SET :: CLEAR
+ * Empty, and small again
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+void small_unordered_set <T, N, Hash, KeyEqual> ::clear() noexcept
+{
+   delete pHash;
+   pHash = nullptr;
+   destroyInline();
+}
+
+/*****************************************
+ * SMALL UNORDERED SET :: DESTROY INLINE
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+void small_unordered_set <T, N, Hash, KeyEqual> ::destroyInline()
+{
+   T* pElements = elements();
+   for (size_t i = 0; i < numInline; i++)
+      pElements[i].~T();
+   numInline = 0;
+}
+
+/*****************************************
+ * SMALL UNORDERED SET :: ASSIGN
+ * Copy the other set in whichever form it is in
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+small_unordered_set <T, N, Hash, KeyEqual>&
+small_unordered_set <T, N, Hash, KeyEqual> ::operator=(const small_unordered_set& rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   clear();
+   hashFunction = rhs.hashFunction;
+   keyEqual = rhs.keyEqual;
+   if (rhs.pHash)
+      pHash = new hashed_type(*rhs.pHash);
+   else
+   {
+      const T* pElements = rhs.elements();
+      for (; numInline < rhs.numInline; numInline++)
+         new (elements() + numInline) T(pElements[numInline]);
+   }
+   return *this;
+}
+
+/*****************************************
+ * SMALL UNORDERED SET :: MOVE ASSIGN
+ * A hashed set hands over its pointer. Inline elements
+ * have to be moved one at a time; rhs is left empty
+ ****************************************/
+template <typename T, size_t N, typename Hash, typename KeyEqual>
+small_unordered_set <T, N, Hash, KeyEqual>&
+small_unordered_set <T, N, Hash, KeyEqual> ::operator=(small_unordered_set&& rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   clear();
+   hashFunction = rhs.hashFunction;
+   keyEqual = rhs.keyEqual;
+   if (rhs.pHash)
+   {
+      pHash = rhs.pHash;
+      rhs.pHash = nullptr;
+   }
+   else
+   {
+      T* pElements = rhs.elements();
+      for (; numInline < rhs.numInline; numInline++)
+         new (elements() + numInline) T(std::move(pElements[numInline]));
+      rhs.destroyInline();
+   }
+   return *this;
+}
+
+} // namespace custom
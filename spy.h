@@ -10,6 +10,9 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>      // for size_t
+#include <new>          // for ::operator new
+#include <type_traits>  // for std::integral_constant
 
 enum { ALLOC,      // 0  allocations, number of times NEW is called
        DELETE,     // 1  deletions, number of times DELETE is called
@@ -206,3 +209,77 @@ inline void swap(Spy & s1, Spy & s2)
 {
    s1.swap(s2);
 }
+
+/*************************************************************
+ * SPY ARENA
+ * Where a SpyAlloc gets its memory, counting what it hands
+ * out and what comes back, and how often an allocator
+ * drawing from it is copied
+ *************************************************************/
+struct SpyArena
+{
+   SpyArena() : numAllocate(0), numDeallocate(0), numBytes(0), numCopy(0) {}
+
+   int numAllocate;      // calls to allocate()
+   int numDeallocate;    // calls to deallocate()
+   size_t numBytes;      // bytes handed out and not yet returned
+   int numCopy;          // SpyAllocs copied, rebound or not
+};
+
+/*************************************************************
+ * SPY ALLOC
+ * A mock allocator that records how it was used. Two are
+ * equal when they draw from the same arena. PROPAGATE sets
+ * all three propagate_on_container_* traits
+ *************************************************************/
+template <class T, bool PROPAGATE = false>
+class SpyAlloc
+{
+public:
+   typedef T value_type;
+   typedef std::integral_constant<bool, PROPAGATE> propagate_on_container_copy_assignment;
+   typedef std::integral_constant<bool, PROPAGATE> propagate_on_container_move_assignment;
+   typedef std::integral_constant<bool, PROPAGATE> propagate_on_container_swap;
+   template <class U>
+   struct rebind
+   {
+      typedef SpyAlloc<U, PROPAGATE> other;
+   };
+
+   SpyAlloc(SpyArena * pArena = nullptr) : pArena(pArena) {}
+   SpyAlloc(const SpyAlloc & rhs) : pArena(rhs.pArena)
+   {
+      if (pArena)
+         pArena->numCopy++;
+   }
+   template <class U>
+   SpyAlloc(const SpyAlloc<U, PROPAGATE> & rhs) : pArena(rhs.pArena)
+   {
+      if (pArena)
+         pArena->numCopy++;
+   }
+   SpyAlloc & operator=(const SpyAlloc & rhs) = default;
+
+   T * allocate(size_t num)
+   {
+      assert(pArena != nullptr);
+      pArena->numAllocate++;
+      pArena->numBytes += num * sizeof(T);
+      return static_cast<T *>(::operator new(num * sizeof(T)));
+   }
+   void deallocate(T * p, size_t num)
+   {
+      assert(pArena != nullptr);
+      assert(pArena->numBytes >= num * sizeof(T));
+      pArena->numDeallocate++;
+      pArena->numBytes -= num * sizeof(T);
+      ::operator delete(p);
+   }
+
+   template <class U>
+   bool operator==(const SpyAlloc<U, PROPAGATE> & rhs) const { return pArena == rhs.pArena; }
+   template <class U>
+   bool operator!=(const SpyAlloc<U, PROPAGATE> & rhs) const { return pArena != rhs.pArena; }
+
+   SpyArena * pArena;
+};
@@ -0,0 +1,141 @@
+/***********************************************************************
+ * Header:
+ *    STATS
+ * Summary:
+ *    A statistics policy for unordered_set that counts what the set
+ *    does. Name it as the last template parameter to turn it on:
+ *        custom::unordered_set<T, Hash, KeyEqual, Alloc, custom::hash_stats>
+ *    and call dump_stats() on the set to log the numbers.
+ *
+ *    This will contain the class definition of:
+ *        hash_stats : Operation counts and chain-length histograms
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include <ostream>    // for std::ostream
+#include <cstddef>    // for size_t
+
+class TestHash;             // forward declaration for Hash unit tests
+
+namespace custom
+{
+
+/************************************************
+ * HASH STATS
+ * Counts every operation on one unordered_set since it
+ * was built or last reset. Lengths of NUM_LENGTHS - 1
+ * or more share the last slot of a histogram
+ ************************************************/
+class hash_stats
+{
+   friend class ::TestHash;   // give unit tests access to the privates
+
+public:
+   static const size_t NUM_LENGTHS = 16;
+
+   hash_stats()
+   {
+      reset();
+   }
+
+   //
+   // Hooks called by unordered_set
+   //
+   void inserted()            { numInserts++;                }
+   void found(bool hit)       { (hit ? numHits : numMisses)++; }
+   void erased()              { numErases++;                 }
+   void rehashed()            { numRehashes++;               }
+   void allocated(size_t num) { numAllocations += num;       }
+   void compared()            { numCompares++;               }
+   void probed(size_t length)
+   {
+      probeLengths[length < NUM_LENGTHS ? length : NUM_LENGTHS - 1]++;
+   }
+
+   //
+   // Status
+   //
+   size_t inserts()     const { return numInserts;     }
+   size_t hits()        const { return numHits;        }
+   size_t misses()      const { return numMisses;      }
+   size_t erases()      const { return numErases;      }
+   size_t rehashes()    const { return numRehashes;    }
+   size_t allocations() const { return numAllocations; }
+   size_t compares()    const { return numCompares;    }
+   size_t probes(size_t length) const
+   {
+      return probeLengths[length < NUM_LENGTHS ? length : NUM_LENGTHS - 1];
+   }
+
+   void reset()
+   {
+      numInserts = numHits = numMisses = numErases = 0;
+      numRehashes = numAllocations = numCompares = 0;
+      for (size_t i = 0; i < NUM_LENGTHS; i++)
+         probeLengths[i] = 0;
+   }
+
+   template <class Set>
+   void dump(std::ostream& os, const Set& set) const;
+
+private:
+   static void dumpHistogram(std::ostream& os, const char* name, const size_t* counts);
+
+   size_t numInserts;     // elements added
+   size_t numHits;        // lookups that found their element
+   size_t numMisses;      // lookups that did not
+   size_t numErases;      // elements erased
+   size_t numRehashes;    // times the buckets were replaced
+   size_t numAllocations; // nodes allocated
+   size_t numCompares;    // calls to KeyEqual
+   size_t probeLengths[NUM_LENGTHS]; // chain walks by number of nodes visited
+};
+
+/*****************************************
+ * HASH STATS :: DUMP
+ * Write the counts, then a histogram of how many buckets
+ * have each bucket_size(). The chain lengths are taken from
+ * the set now rather than counted as it goes. During an
+ * incremental rehash they count what is yet to be moved
+ ****************************************/
+template <class Set>
+void hash_stats::dump(std::ostream& os, const Set& set) const
+{
+   size_t chainLengths[NUM_LENGTHS] = {};
+   for (size_t i = 0; i < set.bucket_count(); i++)
+   {
+      size_t length = set.bucket_size(i);
+      chainLengths[length < NUM_LENGTHS ? length : NUM_LENGTHS - 1]++;
+   }
+
+   os << "size "         << set.size()
+      << ", buckets "    << set.bucket_count()
+      << ", load "       << set.load_factor() << "\n"
+      << "inserts "      << numInserts
+      << ", hits "       << numHits
+      << ", misses "     << numMisses
+      << ", erases "     << numErases << "\n"
+      << "rehashes "     << numRehashes
+      << ", allocations " << numAllocations
+      << ", compares "   << numCompares << "\n";
+   dumpHistogram(os, "probe lengths", probeLengths);
+   dumpHistogram(os, "chain lengths", chainLengths);
+}
+
+/*****************************************
+ * HASH STATS :: DUMP HISTOGRAM
+ * One line of length:count pairs, leaving out empty slots
+ ****************************************/
+inline void hash_stats::dumpHistogram(std::ostream& os, const char* name, const size_t* counts)
+{
+   os << name << ":";
+   for (size_t i = 0; i < NUM_LENGTHS; i++)
+      if (counts[i] != 0)
+         os << " " << i << (i == NUM_LENGTHS - 1 ? "+" : "") << ":" << counts[i];
+   os << "\n";
+}
+
+} // namespace custom
@@ -0,0 +1,582 @@
+/***********************************************************************
+ * Header:
+ *    SWISS
+ * Summary:
+ *    An open-addressed hash set that probes a whole group of slots
+ *    at once. Next to the slots sits a separate array of control
+ *    bytes, one per slot, holding either EMPTY, DELETED, or the low
+ *    seven bits of the element's hash. A lookup compares the control
+ *    bytes of an entire group against those seven bits in a single
+ *    SIMD instruction and only calls operator== on the slots that match.
+ *
+ *    The group width is picked at compile time:
+ *        AVX2   : 32 control bytes per group
+ *        SSE2   : 16 control bytes per group
+ *        other  : 16 control bytes per group, compared one at a time
+ *
+ *    This will contain the class definition of:
+ *        swiss_group                   : The control bytes of one group
+ *        swiss_unordered_set           : A hash probed a group at a time
+ *        swiss_unordered_set::iterator : An interator through the hash
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"     // for custom::pair
+#include <cassert>    // because I am paranoid
+#include <cstdint>    // for int8_t and uint32_t
+#include <cstring>    // for std::memset
+#include <functional> // for std::hash
+#include <cmath>      // for std::ceil
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CUSTOM_SWISS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CUSTOM_SWISS_SSE2
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>   // for _BitScanForward
+#endif
+
+class TestSwiss;            // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * SWISS GROUP
+ * The control bytes of one group of slots. Each
+ * match returns a bitmask with bit i set when
+ * control byte i satisfies the test.
+ ************************************************/
+struct swiss_group
+{
+   // special control bytes. Full slots are 0..127
+   static const int8_t EMPTY   = -128;   // 0b10000000
+   static const int8_t DELETED = -2;     // 0b11111110
+
+#if defined(CUSTOM_SWISS_AVX2)
+   static const size_t WIDTH = 32;
+
+   explicit swiss_group(const int8_t* pCtrl) :
+      ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pCtrl))) {}
+
+   uint32_t match(int8_t h2) const
+   {
+      return (uint32_t)_mm256_movemask_epi8(
+         _mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl));
+   }
+   uint32_t matchEmpty() const
+   {
+      return match(EMPTY);
+   }
+   uint32_t matchEmptyOrDeleted() const
+   {
+      // EMPTY and DELETED are the only control bytes below -1
+      return (uint32_t)_mm256_movemask_epi8(
+         _mm256_cmpgt_epi8(_mm256_set1_epi8(-1), ctrl));
+   }
+
+   __m256i ctrl;
+#elif defined(CUSTOM_SWISS_SSE2)
+   static const size_t WIDTH = 16;
+
+   explicit swiss_group(const int8_t* pCtrl) :
+      ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pCtrl))) {}
+
+   uint32_t match(int8_t h2) const
+   {
+      return (uint32_t)_mm_movemask_epi8(
+         _mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+   }
+   uint32_t matchEmpty() const
+   {
+      return match(EMPTY);
+   }
+   uint32_t matchEmptyOrDeleted() const
+   {
+      // EMPTY and DELETED are the only control bytes below -1
+      return (uint32_t)_mm_movemask_epi8(
+         _mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl));
+   }
+
+   __m128i ctrl;
+#else
+   static const size_t WIDTH = 16;
+
+   explicit swiss_group(const int8_t* pCtrl) : pCtrl(pCtrl) {}
+
+   uint32_t match(int8_t h2) const
+   {
+      uint32_t mask = 0;
+      for (size_t i = 0; i < WIDTH; i++)
+         if (pCtrl[i] == h2)
+            mask |= (uint32_t)1 << i;
+      return mask;
+   }
+   uint32_t matchEmpty() const
+   {
+      return match(EMPTY);
+   }
+   uint32_t matchEmptyOrDeleted() const
+   {
+      uint32_t mask = 0;
+      for (size_t i = 0; i < WIDTH; i++)
+         if (pCtrl[i] < -1)
+            mask |= (uint32_t)1 << i;
+      return mask;
+   }
+
+   const int8_t* pCtrl;
+#endif
+
+   // index of the lowest set bit of a non-zero mask
+   static size_t lowest(uint32_t mask)
+   {
+      assert(mask != 0);
+#if defined(__GNUC__) || defined(__clang__)
+      return (size_t)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+      unsigned long i;
+      _BitScanForward(&i, mask);
+      return (size_t)i;
+#else
+      size_t i = 0;
+      while (!(mask & 1))
+      {
+         mask >>= 1;
+         i++;
+      }
+      return i;
+#endif
+   }
+};
+
+/************************************************
+ * SWISS UNORDERED SET
+ * A set implemented as an open-addressed hash that
+ * is probed one group of control bytes at a time
+ ************************************************/
+template <typename T>
+class swiss_unordered_set
+{
+   friend class ::TestSwiss;   // give unit tests access to the privates
+public:
+   //
+   // Construct
+   //
+   swiss_unordered_set() : ctrl(nullptr), slots(nullptr), numSlots(0),
+                           numElements(0), numDeleted(0)
+   {
+      allocate(swiss_group::WIDTH);
+   }
+   swiss_unordered_set(swiss_unordered_set&  rhs) : swiss_unordered_set()
+   {
+      *this = rhs;
+   }
+   swiss_unordered_set(swiss_unordered_set&& rhs) : swiss_unordered_set()
+   {
+      swap(rhs);
+   }
+   template <class Iterator>
+   swiss_unordered_set(Iterator first, Iterator last) : swiss_unordered_set()
+   {
+      for (auto it = first; it != last; ++it)
+         insert(*it);
+   }
+  ~swiss_unordered_set()
+   {
+      delete [] ctrl;
+      delete [] slots;
+   }
+
+   //
+   // Assign
+   //
+   swiss_unordered_set& operator=(swiss_unordered_set& rhs);
+   swiss_unordered_set& operator=(swiss_unordered_set&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(swiss_unordered_set& rhs)
+   {
+      std::swap(ctrl,        rhs.ctrl);
+      std::swap(slots,       rhs.slots);
+      std::swap(numSlots,    rhs.numSlots);
+      std::swap(numElements, rhs.numElements);
+      std::swap(numDeleted,  rhs.numDeleted);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin();
+   iterator end()
+   {
+      return iterator(ctrl + numSlots, slots + numSlots, ctrl + numSlots);
+   }
+
+   //
+   // Access
+   //
+   iterator find(const T& t);
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T& t);
+   void rehash(size_t numSlots);
+   void reserve(size_t num)
+   {
+      rehash((size_t)std::ceil((float)num / max_load_factor()));
+   }
+
+   //
+   // Remove
+   //
+   void clear() noexcept;
+   iterator erase(const T& t);
+
+   //
+   // Status
+   //
+   size_t size()         const { return numElements;    }
+   bool   empty()        const { return numElements == 0; }
+   size_t bucket_count() const { return numSlots;       }
+   float load_factor() const noexcept
+   {
+      return (float)numElements / (float)numSlots;
+   }
+   float max_load_factor() const noexcept
+   {
+      return 0.875f;
+   }
+
+private:
+   // split a hash into the group to start probing (h1) and the control byte (h2)
+   static size_t hashOf(const T& t)
+   {
+      // std::hash is the identity for integers, which would put every small
+      // key in group zero. Fold the high bits of a multiply back down.
+      uint64_t h = (uint64_t)std::hash<T>()(t) * 0x9E3779B97F4A7C15ull;
+      return (size_t)(h ^ (h >> 32));
+   }
+   static size_t h1(size_t hash) { return hash >> 7;            }
+   static int8_t h2(size_t hash) { return (int8_t)(hash & 0x7F); }
+
+   void allocate(size_t num);
+   size_t findSlot(const T& t, size_t hash) const;
+   size_t findFree(size_t hash) const;
+
+   int8_t * ctrl;           // one control byte per slot
+   T * slots;               // the elements themselves
+   size_t numSlots;         // a power of two and a multiple of the group width
+   size_t numElements;      // number of full slots
+   size_t numDeleted;       // number of DELETED control bytes
+};
+
+/************************************************
+ * SWISS UNORDERED SET ITERATOR
+ * Iterator for a swiss unordered set
+ ************************************************/
+template <typename T>
+class swiss_unordered_set <T> ::iterator
+{
+   friend class ::TestSwiss;   // give unit tests access to the privates
+   template <class TT>
+   friend class custom::swiss_unordered_set;
+public:
+   //
+   // Construct
+   //
+   iterator() : pCtrl(nullptr), pSlot(nullptr), pCtrlEnd(nullptr) {}
+   iterator(int8_t* pCtrl, T* pSlot, int8_t* pCtrlEnd) :
+      pCtrl(pCtrl), pSlot(pSlot), pCtrlEnd(pCtrlEnd) {}
+   iterator(const iterator& rhs) :
+      pCtrl(rhs.pCtrl), pSlot(rhs.pSlot), pCtrlEnd(rhs.pCtrlEnd) {}
+
+   //
+   // Assign
+   //
+   iterator& operator = (const iterator& rhs)
+   {
+      pCtrl    = rhs.pCtrl;
+      pSlot    = rhs.pSlot;
+      pCtrlEnd = rhs.pCtrlEnd;
+      return *this;
+   }
+
+   //
+   // Compare
+   //
+   bool operator != (const iterator& rhs) const { return pSlot != rhs.pSlot; }
+   bool operator == (const iterator& rhs) const { return pSlot == rhs.pSlot; }
+
+   //
+   // Access
+   //
+   T& operator * ()
+   {
+      return *pSlot;
+   }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ()
+   {
+      // full slots are the only ones with a non-negative control byte
+      if (pCtrl != pCtrlEnd)
+         do
+         {
+            ++pCtrl;
+            ++pSlot;
+         }
+         while (pCtrl != pCtrlEnd && *pCtrl < 0);
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator itReturn(*this);
+      ++(*this);
+      return itReturn;
+   }
+
+private:
+   int8_t* pCtrl;
+   T*      pSlot;
+   int8_t* pCtrlEnd;
+};
+
+/*****************************************
+ * SWISS UNORDERED SET :: ALLOCATE
+ * Replace the table with num empty slots
+ ****************************************/
+template <typename T>
+void swiss_unordered_set<T>::allocate(size_t num)
+{
+   assert(num >= swiss_group::WIDTH && (num & (num - 1)) == 0);
+   delete [] ctrl;
+   delete [] slots;
+   ctrl = new int8_t[num];
+   slots = new T[num];
+   std::memset(ctrl, swiss_group::EMPTY, num);
+   numSlots = num;
+   numElements = 0;
+   numDeleted = 0;
+}
+
+/*****************************************
+ * SWISS UNORDERED SET :: ASSIGN
+ * Copy the table of the rhs onto this
+ ****************************************/
+template <typename T>
+swiss_unordered_set<T>& swiss_unordered_set<T>::operator=(swiss_unordered_set& rhs)
+{
+   if (this != &rhs)
+   {
+      allocate(rhs.numSlots);
+      for (size_t i = 0; i < numSlots; i++)
+      {
+         ctrl[i] = rhs.ctrl[i];
+         if (ctrl[i] >= 0)
+            slots[i] = rhs.slots[i];
+      }
+      numElements = rhs.numElements;
+      numDeleted = rhs.numDeleted;
+   }
+   return *this;
+}
+
+/*****************************************
+ * SWISS UNORDERED SET :: BEGIN
+ * The first full slot
+ ****************************************/
+template <typename T>
+typename swiss_unordered_set <T> ::iterator swiss_unordered_set<T>::begin()
+{
+   for (size_t i = 0; i < numSlots; i++)
+      if (ctrl[i] >= 0)
+         return iterator(ctrl + i, slots + i, ctrl + numSlots);
+   return end();
+}
+
+/*****************************************
+ * SWISS UNORDERED SET :: FIND SLOT
+ * Probe group by group. Within a group only the slots whose
+ * control byte matches h2 are compared. A group with an EMPTY
+ * control byte ends the probe. Returns numSlots on a miss
+ ****************************************/
+template <typename T>
+size_t swiss_unordered_set<T>::findSlot(const T& t, size_t hash) const
+{
+   size_t groupMask = numSlots / swiss_group::WIDTH - 1;
+   size_t iGroup = h1(hash) & groupMask;
+   int8_t h = h2(hash);
+   for (size_t probe = 1; probe <= groupMask + 1; probe++)
+   {
+      swiss_group group(ctrl + iGroup * swiss_group::WIDTH);
+      for (uint32_t mask = group.match(h); mask; mask &= mask - 1)
+      {
+         size_t i = iGroup * swiss_group::WIDTH + swiss_group::lowest(mask);
+         if (slots[i] == t)
+            return i;
+      }
+      if (group.matchEmpty())
+         break;
+
+      // triangular steps visit every group when the count is a power of two
+      iGroup = (iGroup + probe) & groupMask;
+   }
+   return numSlots;
+}
+
+/*****************************************
+ * SWISS UNORDERED SET :: FIND FREE
+ * The first EMPTY or DELETED slot along the probe sequence
+ ****************************************/
+template <typename T>
+size_t swiss_unordered_set<T>::findFree(size_t hash) const
+{
+   size_t groupMask = numSlots / swiss_group::WIDTH - 1;
+   size_t iGroup = h1(hash) & groupMask;
+   for (size_t probe = 1; ; probe++)
+   {
+      uint32_t mask = swiss_group(ctrl + iGroup * swiss_group::WIDTH).matchEmptyOrDeleted();
+      if (mask)
+         return iGroup * swiss_group::WIDTH + swiss_group::lowest(mask);
+      iGroup = (iGroup + probe) & groupMask;
+   }
+}
+
+/*****************************************
+ * SWISS UNORDERED SET :: FIND
+ * Find an element in a swiss unordered set
+ ****************************************/
+template <typename T>
+typename swiss_unordered_set <T> ::iterator swiss_unordered_set<T>::find(const T& t)
+{
+   size_t i = findSlot(t, hashOf(t));
+   return iterator(ctrl + i, slots + i, ctrl + numSlots);
+}
+
+/*****************************************
+ * SWISS UNORDERED SET :: INSERT
+ * Insert one element into the first free slot along its probe
+ ****************************************/
+template <typename T>
+custom::pair<typename custom::swiss_unordered_set<T>::iterator, bool> swiss_unordered_set<T>::insert(const T& t)
+{
+   // only one copy of each element in a set
+   size_t hash = hashOf(t);
+   size_t i = findSlot(t, hash);
+   if (i != numSlots)
+      return custom::pair<iterator, bool>(iterator(ctrl + i, slots + i, ctrl + numSlots), false);
+
+   // DELETED slots lengthen probes just like full ones, so count them too.
+   // When they make up most of the load, rebuilding at the same size is enough
+   if ((float)(numElements + numDeleted + 1) > max_load_factor() * (float)numSlots)
+      rehash(numDeleted > numElements ? numSlots : numSlots * 2);
+
+   i = findFree(hash);
+   if (ctrl[i] == swiss_group::DELETED)
+      numDeleted--;
+   ctrl[i] = h2(hash);
+   slots[i] = t;
+   numElements++;
+   return custom::pair<iterator, bool>(iterator(ctrl + i, slots + i, ctrl + numSlots), true);
+}
+
+/*****************************************
+ * SWISS UNORDERED SET :: REHASH
+ * Rebuild the table with at least numSlots slots. This also
+ * clears out every DELETED control byte
+ ****************************************/
+template <typename T>
+void swiss_unordered_set<T>::rehash(size_t numSlots)
+{
+   size_t numMinimum = (size_t)std::ceil((float)numElements / max_load_factor());
+   if (numSlots < numMinimum)
+      numSlots = numMinimum;
+   size_t numNew = swiss_group::WIDTH;
+   while (numNew < numSlots)
+      numNew <<= 1;
+   if (numNew == this->numSlots && numDeleted == 0)
+      return;
+
+   swiss_unordered_set<T> usNew;
+   usNew.allocate(numNew);
+   for (size_t i = 0; i < this->numSlots; i++)
+      if (ctrl[i] >= 0)
+      {
+         size_t hash = hashOf(slots[i]);
+         size_t j = usNew.findFree(hash);
+         usNew.ctrl[j] = h2(hash);
+         usNew.slots[j] = std::move(slots[i]);
+      }
+   usNew.numElements = numElements;
+   swap(usNew);
+}
+
+/*****************************************
+ * SWISS UNORDERED SET :: CLEAR
+ * Empty every slot but keep the table
+ ****************************************/
+template <typename T>
+void swiss_unordered_set<T>::clear() noexcept
+{
+   for (size_t i = 0; i < numSlots; i++)
+      if (ctrl[i] >= 0)
+         slots[i] = T();
+   std::memset(ctrl, swiss_group::EMPTY, numSlots);
+   numElements = 0;
+   numDeleted = 0;
+}
+
+/*****************************************
+ * SWISS UNORDERED SET :: ERASE
+ * Remove one element. A group that has never been full has
+ * never sent a probe on to the next group, so the slot can go
+ * straight back to EMPTY. Otherwise it becomes DELETED so that
+ * probes keep walking past it
+ ****************************************/
+template <typename T>
+typename swiss_unordered_set <T> ::iterator swiss_unordered_set<T>::erase(const T& t)
+{
+   size_t i = findSlot(t, hashOf(t));
+   if (i == numSlots)
+      return end();
+
+   size_t iGroup = i / swiss_group::WIDTH;
+   if (swiss_group(ctrl + iGroup * swiss_group::WIDTH).matchEmpty())
+      ctrl[i] = swiss_group::EMPTY;
+   else
+   {
+      ctrl[i] = swiss_group::DELETED;
+      numDeleted++;
+   }
+   slots[i] = T();
+   numElements--;
+
+   iterator itNext(ctrl + i, slots + i, ctrl + numSlots);
+   return ++itNext;
+}
+
+/*****************************************
+ * SWAP
+ * Stand-alone swiss unordered set swap
+ ****************************************/
+template <typename T>
+void swap(swiss_unordered_set<T>& lhs, swiss_unordered_set<T>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
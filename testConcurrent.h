@@ -0,0 +1,262 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT
+ * Summary:
+ *    Unit tests for the sharded concurrent hash
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrent.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class TestConcurrent : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Insert
+      test_insert_oneShard();
+      test_insert_duplicate();
+      test_insert_spread();
+
+      // Remove
+      test_erase_standard();
+      test_clear_standard();
+
+      // Iterate
+      test_forEachShard_serial();
+      test_forEachShard_parallel();
+
+      // Threads
+      test_threads_insertDisjoint();
+      test_threads_readWhileWrite();
+
+      report("Concurrent");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // a new set has every shard empty
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::concurrent_unordered_set<std::size_t, 8> cs;
+      // verify
+      assertUnit(cs.size() == 0);
+      assertUnit(cs.empty());
+      assertUnit(cs.shard_count() == 8);
+      assertUnit(cs.SHARD_BITS == 3);
+      for (size_t i = 0; i < 8; i++)
+         assertUnit(cs.shards[i].set.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // an element goes into exactly one shard, the one its hash picks
+   void test_insert_oneShard()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t, 8> cs;
+      // exercise
+      bool inserted = cs.insert(42);
+      // verify
+      assertUnit(inserted == true);
+      assertUnit(cs.size() == 1);
+      assertUnit(cs.contains(42));
+      assertUnit(cs.count(43) == 0);
+      size_t iShard = cs.shard(42);
+      for (size_t i = 0; i < 8; i++)
+         assertUnit(cs.shards[i].set.size() == (i == iShard ? 1 : 0));
+   }  // teardown
+
+   // the second insert of an element does nothing
+   void test_insert_duplicate()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t, 8> cs;
+      cs.insert(42);
+      // exercise
+      bool inserted = cs.insert(42);
+      // verify
+      assertUnit(inserted == false);
+      assertUnit(cs.size() == 1);
+   }  // teardown
+
+   // consecutive keys do not all crowd into one shard
+   void test_insert_spread()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t, 16> cs;
+      // exercise
+      for (std::size_t i = 0; i < 1600; i++)
+         cs.insert(i);
+      // verify
+      assertUnit(cs.size() == 1600);
+      bool allBusy = true;
+      for (size_t i = 0; i < 16; i++)
+         if (cs.shards[i].set.size() < 50 || cs.shards[i].set.size() > 150)
+            allBusy = false;
+      assertUnit(allBusy);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase removes one element and reports it
+   void test_erase_standard()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t, 8> cs;
+      for (std::size_t i = 0; i < 100; i++)
+         cs.insert(i);
+      // exercise
+      size_t numErased = cs.erase(50);
+      size_t numMissing = cs.erase(50);
+      // verify
+      assertUnit(numErased == 1);
+      assertUnit(numMissing == 0);
+      assertUnit(cs.size() == 99);
+      assertUnit(!cs.contains(50));
+      assertUnit(cs.contains(49));
+   }  // teardown
+
+   // clear empties every shard
+   void test_clear_standard()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t, 8> cs;
+      for (std::size_t i = 0; i < 100; i++)
+         cs.insert(i);
+      // exercise
+      cs.clear();
+      // verify
+      assertUnit(cs.empty());
+      for (size_t i = 0; i < 8; i++)
+         assertUnit(cs.shards[i].set.size() == 0);
+   }  // teardown
+
+   /***************************************
+    * ITERATE
+    ***************************************/
+
+   // every shard is visited once, in order
+   void test_forEachShard_serial()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t, 8> cs;
+      for (std::size_t i = 0; i < 100; i++)
+         cs.insert(i);
+      std::vector<size_t> visited;
+      std::size_t sum = 0;
+      // exercise
+      cs.for_each_shard([&](size_t iShard,
+         custom::concurrent_unordered_set<std::size_t, 8>::shard_type& set)
+      {
+         visited.push_back(iShard);
+         for (auto it = set.begin(); it != set.end(); ++it)
+            sum += *it;
+      });
+      // verify
+      assertUnit(visited.size() == 8);
+      for (size_t i = 0; i < visited.size(); i++)
+         assertUnit(visited[i] == i);
+      assertUnit(sum == 4950);
+   }  // teardown
+
+   // with several threads every shard is still visited exactly once
+   void test_forEachShard_parallel()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t, 16> cs;
+      for (std::size_t i = 0; i < 1000; i++)
+         cs.insert(i);
+      std::atomic<size_t> visits[16];
+      for (size_t i = 0; i < 16; i++)
+         visits[i] = 0;
+      std::atomic<size_t> count(0);
+      // exercise
+      cs.for_each_shard([&](size_t iShard,
+         custom::concurrent_unordered_set<std::size_t, 16>::shard_type& set)
+      {
+         visits[iShard]++;
+         count += set.size();
+      }, 4);
+      // verify
+      for (size_t i = 0; i < 16; i++)
+         assertUnit(visits[i] == 1);
+      assertUnit(count == 1000);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // many writers, each with its own keys, lose nothing
+   void test_threads_insertDisjoint()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t, 8> cs;
+      std::vector<std::thread> threads;
+      // exercise
+      for (std::size_t t = 0; t < 8; t++)
+         threads.push_back(std::thread([&cs, t]()
+         {
+            for (std::size_t i = 0; i < 1000; i++)
+               cs.insert(t * 1000 + i);
+         }));
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      assertUnit(cs.size() == 8000);
+      bool allFound = true;
+      for (std::size_t i = 0; i < 8000; i++)
+         if (!cs.contains(i))
+            allFound = false;
+      assertUnit(allFound);
+   }  // teardown
+
+   // readers always see the elements that were there before they started
+   void test_threads_readWhileWrite()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t, 4> cs;
+      for (std::size_t i = 0; i < 1000; i++)
+         cs.insert(i);
+      std::atomic<bool> allFound(true);
+      std::vector<std::thread> threads;
+      // exercise
+      for (std::size_t t = 0; t < 4; t++)
+         threads.push_back(std::thread([&cs, &allFound]()
+         {
+            for (std::size_t pass = 0; pass < 5; pass++)
+               for (std::size_t i = 0; i < 1000; i++)
+                  if (!cs.contains(i))
+                     allFound = false;
+         }));
+      for (std::size_t t = 0; t < 2; t++)
+         threads.push_back(std::thread([&cs, t]()
+         {
+            for (std::size_t i = 0; i < 2000; i++)
+               cs.insert(1000 + t * 2000 + i);
+         }));
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      assertUnit(allFound);
+      assertUnit(cs.size() == 5000);
+   }  // teardown
+
+};
+
+#endif // DEBUG
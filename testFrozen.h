@@ -0,0 +1,253 @@
+/***********************************************************************
+ * Header:
+ *    TEST FROZEN
+ * Summary:
+ *    Unit tests for the perfect-hash frozen sets
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "frozen.h"
+#include "unitTest.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+class TestFrozen : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_list();
+      test_construct_duplicates();
+      test_construct_fromSet();
+      test_construct_sameHash();
+
+      // Find
+      test_find_minimal();
+      test_find_oneCompare();
+      test_find_transparent();
+
+      // Static
+      test_static_compileTime();
+      test_static_runTime();
+
+      report("Frozen");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty frozen set finds nothing
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::frozen_unordered_set<std::size_t> fs;
+      // verify
+      assertUnit(fs.size() == 0);
+      assertUnit(fs.empty());
+      assertUnit(fs.begin() == fs.end());
+      assertUnit(fs.find(3) == fs.end());
+      assertUnit(!fs.contains(3));
+   }  // teardown
+
+   // every key gets a slot of its own and nothing else is found
+   void test_construct_list()
+   {  // setup
+      // exercise
+      custom::frozen_unordered_set<std::size_t> fs = { 31, 67, 59, 49 };
+      // verify
+      assertUnit(fs.size() == 4);
+      assertUnit(fs.bucket_count() == 2);
+      assertUnit(fs.contains(31));
+      assertUnit(fs.contains(67));
+      assertUnit(fs.contains(59));
+      assertUnit(fs.contains(49));
+      assertUnit(fs.count(50) == 0);
+      assertUnit(*fs.find(59) == 59);
+   }  // teardown
+
+   // a key listed twice is kept once
+   void test_construct_duplicates()
+   {  // setup
+      std::vector<std::size_t> keys = { 1, 2, 2, 3, 1 };
+      // exercise
+      custom::frozen_unordered_set<std::size_t> fs(keys.begin(), keys.end());
+      // verify
+      assertUnit(fs.size() == 3);
+      assertUnit(fs.contains(1));
+      assertUnit(fs.contains(2));
+      assertUnit(fs.contains(3));
+   }  // teardown
+
+   // freeze an unordered_set, taking its hasher along
+   void test_construct_fromSet()
+   {  // setup
+      custom::unordered_set<std::string> us;
+      for (int i = 0; i < 100; i++)
+         us.insert("key" + std::to_string(i));
+      // exercise
+      custom::frozen_unordered_set<std::string> fs(us);
+      // verify
+      assertUnit(fs.size() == 100);
+      bool allFound = true;
+      for (auto it = us.begin(); it != us.end(); ++it)
+         if (!fs.contains(*it))
+            allFound = false;
+      assertUnit(allFound);
+      assertUnit(!fs.contains("key100"));
+   }  // teardown
+
+   // two keys with the same full hash can never be told apart
+   void test_construct_sameHash()
+   {  // setup
+      std::vector<std::size_t> keys = { 4, 5 };
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::frozen_unordered_set<std::size_t, Halve> fs(keys.begin(), keys.end());
+      }
+      catch (const char*)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // many keys fill every slot exactly once
+   void test_find_minimal()
+   {  // setup
+      std::vector<std::size_t> keys;
+      for (std::size_t i = 0; i < 10000; i++)
+         keys.push_back(i * 10);
+      // exercise
+      custom::frozen_unordered_set<std::size_t> fs(keys.begin(), keys.end());
+      // verify
+      assertUnit(fs.size() == 10000);
+      assertUnit(fs.bucket_count() == 2501);
+      std::vector<bool> used(fs.size());
+      bool allFound = true;
+      for (std::size_t i = 0; i < keys.size(); i++)
+      {
+         auto it = fs.find(keys[i]);
+         if (it == fs.end() || *it != keys[i] || used[it - fs.begin()])
+            allFound = false;
+         else
+            used[it - fs.begin()] = true;
+      }
+      assertUnit(allFound);
+      assertUnit(std::find(used.begin(), used.end(), false) == used.end());
+      assertUnit(!fs.contains(5));
+      assertUnit(!fs.contains(100000));
+   }  // teardown
+
+   // a find, hit or miss, compares exactly one key
+   void test_find_oneCompare()
+   {  // setup
+      std::vector<std::size_t> keys;
+      for (std::size_t i = 0; i < 1000; i++)
+         keys.push_back(i);
+      custom::frozen_unordered_set<std::size_t, std::hash<std::size_t>, CountEqual>
+         fs(keys.begin(), keys.end());
+      CountEqual::count = 0;
+      // exercise
+      bool hit = fs.contains(500);
+      int numHit = CountEqual::count;
+      bool miss = fs.contains(5000);
+      int numMiss = CountEqual::count - numHit;
+      // verify
+      assertUnit(hit);
+      assertUnit(!miss);
+      assertUnit(numHit == 1);
+      assertUnit(numMiss == 1);
+   }  // teardown
+
+   // strings can be searched without building a string
+   void test_find_transparent()
+   {  // setup
+      custom::frozen_unordered_set<std::string, custom::fast_hash, std::equal_to<>>
+         fs = { "red", "green", "blue" };
+      // exercise
+      auto it = fs.find("green");
+      // verify
+      assertUnit(it != fs.end());
+      assertUnit(*it == "green");
+      assertUnit(fs.find("purple") == fs.end());
+   }  // teardown
+
+   /***************************************
+    * STATIC
+    ***************************************/
+
+   // the compiler builds the table and answers lookups
+   void test_static_compileTime()
+   {  // setup
+      static constexpr int primes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29 };
+      // exercise
+      constexpr auto fs = custom::make_frozen_set(primes);
+      // verify
+      static_assert(fs.size() == 10, "");
+      static_assert(fs.contains(7), "");
+      static_assert(fs.contains(29), "");
+      static_assert(!fs.contains(9), "");
+      static_assert(fs.count(4) == 0, "");
+      assertUnit(fs.contains(13));
+   }  // teardown
+
+   // the same table serves lookups at run time
+   void test_static_runTime()
+   {  // setup
+      static constexpr long long ids[] = { 100, 200, 300, -400, 500, 600, 700 };
+      constexpr auto fs = custom::make_frozen_set(ids);
+      std::vector<long long> seen(fs.begin(), fs.end());
+      std::sort(seen.begin(), seen.end());
+      // exercise
+      // verify
+      assertUnit(seen.size() == 7);
+      assertUnit(seen[0] == -400);
+      assertUnit(seen[6] == 700);
+      for (size_t i = 0; i < 7; i++)
+         assertUnit(fs.find(ids[i]) != fs.end() && *fs.find(ids[i]) == ids[i]);
+      assertUnit(fs.find(400) == fs.end());
+   }  // teardown
+
+private:
+   // a hasher that gives pairs of keys the same hash
+   struct Halve
+   {
+      std::size_t operator()(std::size_t i) const { return i / 2; }
+   };
+
+   // an equality that counts how many times it is called
+   struct CountEqual
+   {
+      static int count;
+      bool operator()(std::size_t lhs, std::size_t rhs) const
+      {
+         count++;
+         return lhs == rhs;
+      }
+   };
+};
+
+int TestFrozen::CountEqual::count = 0;
+
+#endif // DEBUG
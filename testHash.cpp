@@ -16,6 +16,16 @@
 #include "testPair.h"       // for the pair unit tests
 #include "testHash.h"       // for the hash unit tests
 #include "testList.h"       // for the list unit tests
+#include "testSwiss.h"      // for the swiss table unit tests
+#include "testConcurrent.h"  // for the concurrent hash unit tests
+#include "testLockFree.h"    // for the lock-free hash unit tests
+#include "testFrozen.h"      // for the frozen hash unit tests
+#include "testSmall.h"       // for the small hash unit tests
+#include "testPool.h"        // for the node pool unit tests
+#include "testUnrolled.h"    // for the unrolled list unit tests
+#include "testIntrusive.h"   // for the intrusive list unit tests
+#include "testQueue.h"       // for the lock-free queue unit tests
+#include "testVector.h"      // for the vector unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -30,6 +40,16 @@ int main()
    TestPair().run();
    TestList().run();
    TestHash().run();
+   TestSwiss().run();
+   TestConcurrent().run();
+   TestLockFree().run();
+   TestFrozen().run();
+   TestSmall().run();
+   TestPool().run();
+   TestUnrolled().run();
+   TestIntrusive().run();
+   TestQueue().run();
+   TestVector().run();
 #endif // DEBUG
    
    // driver
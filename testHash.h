@@ -12,6 +12,11 @@
 #ifdef DEBUG
 
 #include "hash.h"
+#include "stats.h"
+#include "quality.h"
+#include "hashers.h"
+#include "vector.h"
+#include "spy.h"
 #include "unitTest.h"
 
 #include <cassert>
@@ -19,6 +24,10 @@
 #include <unordered_set>
 #include <functional>
 #include <vector>
+#include <string>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
 
 using std::cout;
 using std::endl;
@@ -38,6 +47,74 @@ namespace std
 }
 #endif // __APPLE__
 
+// a hasher that puts every element three buckets over
+struct HashTimesThree
+{
+   std::size_t operator()(std::size_t i) const noexcept
+   {
+      return i * 3;
+   }
+};
+
+// a string hasher that counts how many times it is called
+struct HashCounted
+{
+   static int count;
+   std::size_t operator()(const std::string& s) const
+   {
+      count++;
+      return std::hash<std::string>()(s);
+   }
+};
+int HashCounted::count = 0;
+
+// a string equality that counts how many times it is called
+struct EqualCounted
+{
+   static int count;
+   bool operator()(const std::string& lhs, const std::string& rhs) const
+   {
+      count++;
+      return lhs == rhs;
+   }
+};
+int EqualCounted::count = 0;
+
+// a transparent hasher so a set of Spy can be searched with an int
+struct SpyHash
+{
+   typedef void is_transparent;
+   std::size_t operator()(const Spy& s) const { return (std::size_t)s.get(); }
+   std::size_t operator()(int i)        const { return (std::size_t)i;       }
+};
+
+// a transparent equality so a set of Spy can be searched with an int
+struct SpyEqual
+{
+   typedef void is_transparent;
+   bool operator()(const Spy& lhs, const Spy& rhs) const { return lhs.get() == rhs.get(); }
+   bool operator()(const Spy& lhs, int rhs)        const { return lhs.get() == rhs;       }
+};
+
+// a hasher that scrambles every key bit into every hash bit
+struct MixHash
+{
+   std::size_t operator()(std::size_t i) const
+   {
+      i ^= i >> 30;
+      i *= 0xBF58476D1CE4E5B9ull;
+      i ^= i >> 27;
+      i *= 0x94D049BB133111EBull;
+      return i ^ (i >> 31);
+   }
+};
+
+// a hasher that throws away the low bit, so keys come in colliding pairs
+struct HalfHash
+{
+   std::size_t operator()(std::size_t i) const { return i / 2; }
+};
+
 class TestHash : public UnitTest
 {
 
@@ -49,6 +126,10 @@ public:
       // Construct
       test_construct_default();
       test_constructIterator_standard();
+      test_constructIterator_duplicate();
+      test_constructIterator_presize();
+      test_constructIterator_hashOnce();
+      test_constructIterator_input();
       test_constructCopy_empty();
       test_constructCopy_standard();
 
@@ -91,6 +172,9 @@ public:
       test_find_standardBack();
       test_find_standardMissingEmptyList();
       test_find_standardMissingFilledList();
+      test_findBatch_standard();
+      test_findBatch_large();
+      test_containsBatch_standard();
 
       // Insert
       test_insert_empty0();
@@ -98,6 +182,105 @@ public:
       test_insert_standard3();
       test_insert_standard77();
       test_insert_standardDuplicate();
+      test_insert_grow();
+      test_insertRange_customVector();
+      test_insert_copyOnce();
+      test_insertMove_noCopy();
+      test_insertMove_duplicate();
+      test_emplace_constructOnce();
+      test_emplace_duplicate();
+      test_emplaceHint_standard();
+
+      // Rehash
+      test_rehash_emptyGrow();
+      test_rehash_standardGrow();
+      test_rehash_standardTooSmall();
+      test_rehash_relink();
+      test_reserve_empty();
+      test_loadFactor_standard();
+
+      // Hash and KeyEqual
+      test_hash_custom();
+      test_storeHash_trait();
+      test_storeHash_rehashWithoutHashing();
+      test_storeHash_rejectOnHash();
+
+      // Transparent
+      test_transparent_detect();
+      test_transparent_find();
+      test_transparent_countContains();
+      test_transparent_erase();
+      test_transparent_bucket();
+
+      // Node handle
+      test_extract_standard();
+      test_extract_missing();
+      test_insertNode_standard();
+      test_insertNode_duplicate();
+      test_merge_standard();
+
+      // Allocator
+      test_alloc_everything();
+      test_alloc_moveAcross();
+      test_alloc_extract();
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+      test_alloc_pmrArena();
+#endif
+
+      // Incremental rehash
+      test_incremental_budgetZero();
+      test_incremental_start();
+      test_incremental_budget();
+      test_incremental_findOld();
+      test_incremental_findBatch();
+      test_incremental_insertDuplicate();
+      test_incremental_erase();
+      test_incremental_finish();
+      test_incremental_beginFinishes();
+      test_incremental_walkFromFind();
+      test_incremental_eraseNext();
+      test_incremental_merge();
+      test_incremental_bucket();
+
+      // Statistics
+      test_stats_none();
+      test_stats_count();
+      test_stats_extract();
+      test_stats_merge();
+      test_stats_rehash();
+      test_stats_dump();
+
+      // Hash quality
+      test_quality_clustered();
+      test_quality_mixed();
+      test_quality_sameHash();
+      test_quality_strings();
+
+      // Fast hashers
+      test_fastHash_mix();
+      test_fastHash_bytesEveryLength();
+      test_fastHash_strings();
+      test_fastHash_set();
+      test_seededHash_seed();
+
+      // Flat
+      test_flat_construct_default();
+      test_flat_insert_collide();
+      test_flat_insert_duplicate();
+      test_flat_insert_grow();
+      test_flat_insert_strided();
+      test_flat_find_missing();
+      test_flat_erase_shiftBack();
+      test_flat_erase_wrap();
+      test_flat_iterate();
+      test_flat_maxProbeLength();
+
+      // Robin Hood
+      test_robinHood_insert_displace();
+      test_robinHood_find_stopEarly();
+      test_robinHood_erase_shiftBack();
+      test_robinHood_maxProbeLength();
+      test_robinHood_strided();
 
       // Remove
       test_clear_empty();
@@ -171,6 +354,85 @@ public:
       assertStandardFixture(us);
    }  // teardown
 
+   // duplicates in the range are kept once, in range order
+   void test_constructIterator_duplicate()
+   {  // setup
+      std::vector<std::size_t> v{59, 67, 31, 49, 59, 31};
+      // exercise
+      custom::unordered_set<std::size_t> us(v.begin(), v.end());
+      // verify
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      assertStandardFixture(us);
+   }  // teardown
+
+   // a long range sizes the buckets once before anything goes in
+   void test_constructIterator_presize()
+   {  // setup
+      std::vector<std::size_t> v;
+      for (std::size_t i = 0; i < 1000; i++)
+         v.push_back(i);
+      // exercise
+      custom::unordered_set<std::size_t> us(v.begin(), v.end());
+      // verify
+      //      h[0]   --> 0
+      //      h[1]   --> 1
+      //      ...
+      //      h[999] --> 999
+      assertUnit(us.numElements == 1000);
+      assertUnit(us.numBuckets == 1000);
+      bool allAlone = true;
+      for (std::size_t i = 0; i < 1000; i++)
+         if (us.buckets[i].size() != 1 || us.buckets[i].front() != i)
+            allAlone = false;
+      assertUnit(allAlone);
+   }  // teardown
+
+   // every element of the range is hashed exactly once
+   void test_constructIterator_hashOnce()
+   {  // setup
+      std::vector<std::string> v;
+      for (int i = 0; i < 50; i++)
+         v.push_back(std::to_string(i));
+      HashCounted::count = 0;
+      // exercise
+      custom::unordered_set<std::string, HashCounted, EqualCounted> us(v.begin(), v.end());
+      // verify
+      assertUnit(us.numElements == 50);
+      assertUnit(HashCounted::count == 50);
+      assertUnit(us.find(std::string("17")) != us.end());
+   }  // teardown
+
+   // a range that can only be walked once is inserted as it is read
+   void test_constructIterator_input()
+   {  // setup
+      std::istringstream in("59 67 31 49");
+      std::istream_iterator<std::size_t> first(in);
+      std::istream_iterator<std::size_t> last;
+      // exercise
+      custom::unordered_set<std::size_t> us(first, last);
+      // verify
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      assertStandardFixture(us);
+   }  // teardown
+
    // copy an empty unordered set
    void test_constructCopy_empty()
    {  // setup
@@ -1477,6 +1739,74 @@ public:
       assertStandardFixture(us);
    }
    
+   // look up a batch of keys, some present and some not
+   void test_findBatch_standard()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::size_t keys[] = { 49, 50, 31, 67, 77 };
+      custom::unordered_set<std::size_t>::iterator out[5];
+      // exercise
+      us.find_batch(keys, 5, out);
+      // verify
+      assertUnit(out[0].pBucket == us.buckets + 9);
+      assertUnit(out[0].itList == us.buckets[9].rbegin());
+      assertUnit(out[1] == us.end());
+      assertUnit(out[2].pBucket == us.buckets + 1);
+      assertUnit(out[2].itList == us.buckets[1].begin());
+      assertUnit(out[3].pBucket == us.buckets + 7);
+      assertUnit(out[4] == us.end());
+      assertStandardFixture(us);
+   }  // teardown
+
+   // a batch spanning several chunks agrees with find
+   void test_findBatch_large()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i * 2);
+      std::vector<std::size_t> keys;
+      for (std::size_t i = 0; i < 150; i++)
+         keys.push_back(i);
+      std::vector<custom::unordered_set<std::size_t>::iterator> out(keys.size());
+      // exercise
+      us.find_batch(keys.data(), keys.size(), out.data());
+      // verify
+      bool allMatch = true;
+      for (std::size_t i = 0; i < keys.size(); i++)
+         if (out[i] != us.find(keys[i]))
+            allMatch = false;
+      assertUnit(allMatch);
+   }  // teardown
+
+   // check membership of a batch of keys
+   void test_containsBatch_standard()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::size_t keys[] = { 49, 50, 31, 67, 77 };
+      bool out[5] = { false, true, false, false, true };
+      // exercise
+      us.contains_batch(keys, 5, out);
+      // verify
+      assertUnit(out[0] == true);
+      assertUnit(out[1] == false);
+      assertUnit(out[2] == true);
+      assertUnit(out[3] == true);
+      assertUnit(out[4] == false);
+      assertStandardFixture(us);
+   }  // teardown
+
    /***************************************
     * INSERT
     ***************************************/
@@ -1725,6 +2055,68 @@ public:
       assertUnit(p.first.itList == us.buckets[7].begin());
       assertUnit(p.second == false);
    }
+
+   // insert a custom::vector into a filled set, growing once
+   void test_insertRange_customVector()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      custom::vector<std::size_t> v;
+      for (std::size_t i = 100; i < 120; i++)
+         v.push_back(i);
+      v.push_back(67);
+      // exercise
+      us.insert(v.begin(), v.end());
+      // verify
+      assertUnit(us.numElements == 24);
+      assertUnit(us.numBuckets == 25);  // sized before 67 is found to be a duplicate
+      assertUnit(us.find(67) != us.end());
+      assertUnit(us.find(119) != us.end());
+      assertUnit(us.find(120) == us.end());
+   }  // teardown
+
+   // inserting past the max load factor doubles the number of buckets
+   void test_insert_grow()
+   {  // setup
+      //      h[0] --> 0
+      //      h[1] --> 1
+      //      ...
+      //      h[9] --> 9
+      custom::unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 10; i++)
+         us.buckets[i].push_back(i);
+      us.numElements = 10;
+      custom::pair<custom::unordered_set<std::size_t>::iterator, bool> p;
+      // exercise
+      p = us.insert(10);  // 10 % 20 == 10
+      // verify
+      //      h[0]  --> 0
+      //      ...
+      //      h[10] --> 10
+      //      h[11] -->
+      //      ...
+      //      h[19] -->
+      assertUnit(us.numElements == 11);
+      assertUnit(us.numBuckets == 20);
+      for (size_t i = 0; i < 11; i++)
+         assertUnit(us.buckets[i].size() == 1);
+      for (size_t i = 11; i < 20; i++)
+         assertUnit(us.buckets[i].size() == 0);
+      assertUnit(p.first.pBucket == us.buckets + 10);
+      assertUnit(p.first.pBucketEnd == us.buckets + 20);
+      assertUnit(p.first.itList == us.buckets[10].begin());
+      assertUnit(p.second == true);
+   }  // teardown
    
    /***************************************
     * REMOVE
@@ -2051,77 +2443,126 @@ public:
       assertUnit(it.itList == us.buckets[0].end());
    }
    
-   /***************************************
-    * SIZE EMPTY 
-    ***************************************/
+   // inserting an lvalue copies it exactly once
+   void test_insert_copyOnce()
+   {  // setup
+      custom::unordered_set<Spy, SpyHash, SpyEqual> us;
+      Spy s(67);
+      Spy::reset();
+      // exercise
+      custom::pair<custom::unordered_set<Spy, SpyHash, SpyEqual>::iterator, bool> p = us.insert(s);
+      // verify
+      assertUnit(p.second == true);
+      assertUnit(us.numElements == 1);
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numAlloc() == 1);
+      assertUnit(s.get() == 67);
+   }  // teardown
 
-    // size of an empty hash
-   void test_size_empty()
+   // inserting an rvalue moves it without a copy
+   void test_insertMove_noCopy()
    {  // setup
-      custom::unordered_set<std::size_t> us;
+      custom::unordered_set<Spy, SpyHash, SpyEqual> us;
+      Spy s(67);
+      Spy::reset();
       // exercise
-      size_t size = us.size();
+      custom::pair<custom::unordered_set<Spy, SpyHash, SpyEqual>::iterator, bool> p = us.insert(std::move(s));
       // verify
-      assertUnit(0 == size);
-      assertEmptyFixture(us);
+      assertUnit(p.second == true);
+      assertUnit(us.numElements == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(s.empty());
+      if (p.second)
+         assertUnit((*p.first).get() == 67);
    }  // teardown
 
-   // size of the standard hash
-   void test_size_standard()
+   // inserting a duplicate rvalue leaves it alone
+   void test_insertMove_duplicate()
+   {  // setup
+      custom::unordered_set<Spy, SpyHash, SpyEqual> us;
+      us.insert(Spy(67));
+      Spy s(67);
+      Spy::reset();
+      // exercise
+      custom::pair<custom::unordered_set<Spy, SpyHash, SpyEqual>::iterator, bool> p = us.insert(std::move(s));
+      // verify
+      assertUnit(p.second == false);
+      assertUnit(us.numElements == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(!s.empty());
+   }  // teardown
+
+   // emplace builds the element once, from the arguments
+   void test_emplace_constructOnce()
+   {  // setup
+      custom::unordered_set<Spy, SpyHash, SpyEqual> us;
+      Spy::reset();
+      // exercise
+      custom::pair<custom::unordered_set<Spy, SpyHash, SpyEqual>::iterator, bool> p = us.emplace(67);
+      // verify
+      assertUnit(p.second == true);
+      assertUnit(us.numElements == 1);
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 1);
+      if (p.second)
+         assertUnit((*p.first).get() == 67);
+   }  // teardown
+
+   // emplace of a duplicate builds nothing at all
+   void test_emplace_duplicate()
+   {  // setup
+      custom::unordered_set<Spy, SpyHash, SpyEqual> us;
+      us.emplace(67);
+      Spy::reset();
+      // exercise
+      custom::pair<custom::unordered_set<Spy, SpyHash, SpyEqual>::iterator, bool> p = us.emplace(67);
+      // verify
+      assertUnit(p.second == false);
+      assertUnit(us.numElements == 1);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit((*p.first).get() == 67);
+   }  // teardown
+
+   // emplace with a hint returns the new element
+   void test_emplaceHint_standard()
    {  // setup
-      //      h[0] -->
-      //      h[1] --> 31
-      //      h[2] -->
-      //      h[3] -->
-      //      h[4] -->
-      //      h[5] -->
-      //      h[6] -->
-      //      h[7] --> 67
-      //      h[8] -->
-      //      h[9] --> 59 49
       custom::unordered_set<std::size_t> us;
       setupStandardFixture(us);
       // exercise
-      size_t size = us.size();
+      custom::unordered_set<std::size_t>::iterator it = us.emplace_hint(us.end(), 23);
       // verify
-      assertUnit(4 == size);
-      assertStandardFixture(us);
-      // teardown
-   }
+      assertUnit(us.numElements == 5);
+      assertUnit(us.buckets[3].size() == 1);
+      assertUnit(it.pBucket == us.buckets + 3);
+      assertUnit(*it == 23);
+   }  // teardown
 
-   // empty hash empty?
-   void test_empty_empty()
+   /***************************************
+    * REHASH
+    ***************************************/
+
+   // rehash an empty hash into 20 buckets
+   void test_rehash_emptyGrow()
    {  // setup
-      //      h[0] -->
-      //      h[1] -->
-      //      h[2] -->
-      //      h[3] -->
-      //      h[4] -->
-      //      h[5] -->
-      //      h[6] -->
-      //      h[7] -->
-      //      h[8] -->
-      //      h[9] -->
       custom::unordered_set<std::size_t> us;
       // exercise
-      bool empty = us.empty();
+      us.rehash(20);
       // verify
-      assertUnit(true == empty);
-      //      h[0] -->
-      //      h[1] -->
-      //      h[2] -->
-      //      h[3] -->
-      //      h[4] -->
-      //      h[5] -->
-      //      h[6] -->
-      //      h[7] -->
-      //      h[8] -->
-      //      h[9] -->
-      assertEmptyFixture(us);
+      assertUnit(us.numElements == 0);
+      assertUnit(us.numBuckets == 20);
+      for (size_t i = 0; i < 20; i++)
+         assertUnit(us.buckets[i].size() == 0);
    }  // teardown
 
-   // standard hash empty?
-   void test_empty_standard()
+   // rehash the standard fixture into 20 buckets
+   void test_rehash_standardGrow()
    {  // setup
       //      h[0] -->
       //      h[1] --> 31
@@ -2136,28 +2577,1513 @@ public:
       custom::unordered_set<std::size_t> us;
       setupStandardFixture(us);
       // exercise
-      bool empty = us.empty();
+      us.rehash(20);
       // verify
-      assertUnit(false == empty);
-      //      h[0] -->
-      //      h[1] --> 31
-      //      h[2] -->
-      //      h[3] -->
-      //      h[4] -->
-      //      h[5] -->
-      //      h[6] -->
-      //      h[7] --> 67
-      //      h[8] -->
-      //      h[9] --> 59 49
-      assertStandardFixture(us);
-      // teardown
-   }
+      //      h[7]  --> 67
+      //      h[9]  --> 49
+      //      h[11] --> 31
+      //      h[19] --> 59
+      assertUnit(us.numElements == 4);
+      assertUnit(us.numBuckets == 20);
+      assertUnit(us.buckets[7].size() == 1);  // 67
+      assertUnit(us.buckets[9].size() == 1);  // 49
+      assertUnit(us.buckets[11].size() == 1); // 31
+      assertUnit(us.buckets[19].size() == 1); // 59
+      if (us.buckets[7].size() == 1)
+         assertUnit(us.buckets[7].front() == 67);
+      if (us.buckets[9].size() == 1)
+         assertUnit(us.buckets[9].front() == 49);
+      if (us.buckets[11].size() == 1)
+         assertUnit(us.buckets[11].front() == 31);
+      if (us.buckets[19].size() == 1)
+         assertUnit(us.buckets[19].front() == 59);
+   }  // teardown
 
-   // verify the bucket size of an empty hash
-   void test_bucketSize_empty()
+   // rehash cannot take the load factor above the max load factor
+   void test_rehash_standardTooSmall()
    {  // setup
-      //      h[0] -->
-      //      h[1] -->
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      us.rehash(1);
+      // verify
+      assertUnit(us.numElements == 4);
+      assertUnit(us.numBuckets == 4);
+      assertUnit(us.buckets[0].size() == 0);
+      assertUnit(us.buckets[1].size() == 1); // 49
+      assertUnit(us.buckets[2].size() == 0);
+      assertUnit(us.buckets[3].size() == 3); // 31 67 59
+      assertUnit(us.load_factor() <= us.max_load_factor());
+   }  // teardown
+
+   // rehash relinks the nodes rather than moving the elements
+   void test_rehash_relink()
+   {  // setup
+      custom::unordered_set<Spy, SpyHash, SpyEqual> us;
+      us.insert(Spy(59));
+      us.insert(Spy(67));
+      us.insert(Spy(31));
+      Spy* p67 = &*us.find(67);
+      Spy::reset();
+      // exercise
+      us.rehash(64);
+      // verify
+      assertUnit(us.numBuckets == 64);
+      assertUnit(us.numElements == 3);
+      assertUnit(&*us.find(67) == p67);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDelete() == 0);
+   }  // teardown
+
+   // reserve room for 100 elements
+   void test_reserve_empty()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      // exercise
+      us.reserve(100);
+      // verify
+      assertUnit(us.numElements == 0);
+      assertUnit(us.numBuckets == 100);
+   }  // teardown
+
+   // the load factor is the average number of elements per bucket
+   void test_loadFactor_standard()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      float loadFactor = us.load_factor();
+      // verify
+      assertUnit(loadFactor == 0.4f);
+      assertUnit(us.max_load_factor() == 1.0f);
+      assertStandardFixture(us);
+   }  // teardown
+
+   /***************************************
+    * HASH and KEY EQUAL
+    ***************************************/
+
+   // the bucket comes from the Hash template parameter
+   void test_hash_custom()
+   {  // setup
+      custom::unordered_set<std::size_t, HashTimesThree> us;
+      // exercise
+      us.insert(1);   // 3 % 10 == 3
+      us.insert(4);   // 12 % 10 == 2
+      // verify
+      assertUnit(us.bucket(1) == 3);
+      assertUnit(us.bucket(4) == 2);
+      assertUnit(us.buckets[3].size() == 1);
+      assertUnit(us.buckets[2].size() == 1);
+      assertUnit(us.find(4) != us.end());
+   }  // teardown
+
+   // scalars are stored bare, everything else with its hash
+   void test_storeHash_trait()
+   {  // setup
+      // exercise
+      bool storeSizeT  = custom::store_hash<std::size_t, std::hash<std::size_t>>::value;
+      bool storeString = custom::store_hash<std::string, std::hash<std::string>>::value;
+      // verify
+      assertUnit(storeSizeT == false);
+      assertUnit(storeString == true);
+   }  // teardown
+
+   // with a stored hash, rehash never calls the hasher
+   void test_storeHash_rehashWithoutHashing()
+   {  // setup
+      custom::unordered_set<std::string, HashCounted, EqualCounted> us;
+      us.insert(std::string("alpha"));
+      us.insert(std::string("beta"));
+      us.insert(std::string("gamma"));
+      HashCounted::count = 0;
+      EqualCounted::count = 0;
+      // exercise
+      us.rehash(64);
+      // verify
+      assertUnit(HashCounted::count == 0);
+      assertUnit(EqualCounted::count == 0);
+      assertUnit(us.numBuckets == 64);
+      assertUnit(us.find(std::string("beta")) != us.end());
+   }  // teardown
+
+   // a different element in the same bucket is rejected on its hash
+   void test_storeHash_rejectOnHash()
+   {  // setup
+      custom::unordered_set<std::string, HashCounted, EqualCounted> us;
+      us.max_load_factor(100.0f);
+      us.rehash(1);
+      us.insert(std::string("alpha"));
+      us.insert(std::string("beta"));
+      us.insert(std::string("gamma"));
+      HashCounted::count = 0;
+      EqualCounted::count = 0;
+      // exercise
+      bool found = us.find(std::string("delta")) != us.end();
+      // verify
+      assertUnit(found == false);
+      assertUnit(us.numBuckets == 1);
+      assertUnit(us.buckets[0].size() == 3);
+      assertUnit(HashCounted::count == 1);
+      assertUnit(EqualCounted::count == 0);
+   }  // teardown
+
+   /***************************************
+    * TRANSPARENT
+    ***************************************/
+
+   // only functors that declare is_transparent are transparent
+   void test_transparent_detect()
+   {  // setup
+      // exercise
+      bool hashDefault = custom::is_transparent<std::hash<std::size_t>>::value;
+      bool equalDefault = custom::is_transparent<std::equal_to<std::size_t>>::value;
+      bool hashSpy = custom::is_transparent<SpyHash>::value;
+      bool equalSpy = custom::is_transparent<SpyEqual>::value;
+      // verify
+      assertUnit(hashDefault == false);
+      assertUnit(equalDefault == false);
+      assertUnit(hashSpy == true);
+      assertUnit(equalSpy == true);
+   }  // teardown
+
+   // find with an int never builds a Spy
+   void test_transparent_find()
+   {  // setup
+      custom::unordered_set<Spy, SpyHash, SpyEqual> us;
+      us.insert(Spy(31));
+      us.insert(Spy(67));
+      Spy::reset();
+      // exercise
+      custom::unordered_set<Spy, SpyHash, SpyEqual>::iterator itHit = us.find(67);
+      custom::unordered_set<Spy, SpyHash, SpyEqual>::iterator itMiss = us.find(49);
+      // verify
+      assertUnit(itHit != us.end());
+      if (itHit != us.end())
+         assertUnit((*itHit).get() == 67);
+      assertUnit(itMiss == us.end());
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // count and contains with an int never build a Spy
+   void test_transparent_countContains()
+   {  // setup
+      custom::unordered_set<Spy, SpyHash, SpyEqual> us;
+      us.insert(Spy(31));
+      Spy::reset();
+      // exercise
+      size_t numHit = us.count(31);
+      size_t numMiss = us.count(49);
+      bool hit = us.contains(31);
+      bool miss = us.contains(49);
+      // verify
+      assertUnit(numHit == 1);
+      assertUnit(numMiss == 0);
+      assertUnit(hit == true);
+      assertUnit(miss == false);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // erase with an int never builds a Spy
+   void test_transparent_erase()
+   {  // setup
+      custom::unordered_set<Spy, SpyHash, SpyEqual> us;
+      us.insert(Spy(31));
+      us.insert(Spy(67));
+      Spy::reset();
+      // exercise
+      us.erase(31);
+      // verify
+      assertUnit(us.numElements == 1);
+      assertUnit(us.contains(31) == false);
+      assertUnit(us.contains(67) == true);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // bucket with an int lands where the Spy does
+   void test_transparent_bucket()
+   {  // setup
+      custom::unordered_set<Spy, SpyHash, SpyEqual> us;
+      Spy s(67);
+      Spy::reset();
+      // exercise
+      size_t iBucket = us.bucket(67);
+      // verify
+      assertUnit(iBucket == 7);
+      assertUnit(iBucket == us.bucket(s));
+      assertUnit(Spy::numNondefault() == 0);
+   }  // teardown
+
+   /***************************************
+    * NODE HANDLE
+    ***************************************/
+
+   // extract takes the node itself out of its bucket
+   void test_extract_standard()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::size_t* p59 = &*us.find(59);
+      // exercise
+      custom::unordered_set<std::size_t>::node_type nh = us.extract(59);
+      // verify
+      //      h[9] --> 49
+      assertUnit(!nh.empty());
+      assertUnit(&nh.value() == p59);
+      assertUnit(nh.value() == 59);
+      assertUnit(us.numElements == 3);
+      assertUnit(us.buckets[9].size() == 1);
+      assertUnit(us.buckets[9].front() == 49);
+      assertUnit(us.find(59) == us.end());
+   }  // teardown
+
+   // extracting a missing element gives an empty handle
+   void test_extract_missing()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      custom::unordered_set<std::size_t>::node_type nh = us.extract(50);
+      // verify
+      assertUnit(nh.empty());
+      assertUnit(!nh);
+      assertStandardFixture(us);
+   }  // teardown
+
+   // a node moves from one set to another without touching the element
+   void test_insertNode_standard()
+   {  // setup
+      custom::unordered_set<Spy, SpyHash, SpyEqual> usSrc;
+      custom::unordered_set<Spy, SpyHash, SpyEqual> usDest;
+      usSrc.insert(Spy(67));
+      custom::unordered_set<Spy, SpyHash, SpyEqual>::iterator it = usSrc.find(67);
+      Spy* p67 = &*it;
+      Spy::reset();
+      // exercise
+      custom::unordered_set<Spy, SpyHash, SpyEqual>::insert_return_type result =
+         usDest.insert(usSrc.extract(it));
+      // verify
+      assertUnit(result.inserted == true);
+      assertUnit(result.node.empty());
+      assertUnit(&*result.position == p67);
+      assertUnit(usSrc.numElements == 0);
+      assertUnit(usDest.numElements == 1);
+      assertUnit(usDest.buckets[7].size() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDelete() == 0);
+   }  // teardown
+
+   // a node whose element is already present comes back in the result
+   void test_insertNode_duplicate()
+   {  // setup
+      custom::unordered_set<std::size_t> usSrc;
+      custom::unordered_set<std::size_t> usDest;
+      usSrc.insert(67);
+      usDest.insert(67);
+      std::size_t* p67 = &*usSrc.find(67);
+      // exercise
+      custom::unordered_set<std::size_t>::insert_return_type result =
+         usDest.insert(usSrc.extract(67));
+      // verify
+      assertUnit(result.inserted == false);
+      assertUnit(!result.node.empty());
+      assertUnit(&result.node.value() == p67);
+      assertUnit(result.position == usDest.find(67));
+      assertUnit(usSrc.numElements == 0);
+      assertUnit(usDest.numElements == 1);
+   }  // teardown
+
+   // merge relinks what is new and leaves the duplicates behind
+   void test_merge_standard()
+   {  // setup
+      //      h[1] --> 31
+      //      h[7] --> 67
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      //      h[3] --> 3
+      //      h[7] --> 67 77
+      custom::unordered_set<std::size_t> usSrc;
+      usSrc.insert(67);
+      usSrc.insert(77);
+      usSrc.insert(3);
+      std::size_t* p77 = &*usSrc.find(77);
+      // exercise
+      us.merge(usSrc);
+      // verify
+      //      h[1] --> 31
+      //      h[3] --> 3
+      //      h[7] --> 67 77
+      //      h[9] --> 59 49
+      assertUnit(us.numElements == 6);
+      assertUnit(us.numBuckets == 10);
+      assertUnit(us.buckets[3].size() == 1);
+      assertUnit(us.buckets[7].size() == 2);
+      assertUnit(&*us.find(77) == p77);
+      assertUnit(usSrc.numElements == 1);
+      assertUnit(usSrc.buckets[7].size() == 1);
+      assertUnit(usSrc.buckets[7].front() == 67);
+   }  // teardown
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // the buckets and every node come from the allocator and go back to it
+   void test_alloc_everything()
+   {  // setup
+      SpyArena arena;
+      {
+         custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                               std::equal_to<std::size_t>, SpyAlloc<std::size_t>> us(&arena);
+         // exercise
+         for (std::size_t i = 0; i < 100; i++)
+            us.insert(i);
+         // verify
+         assertUnit(us.size() == 100);
+         assertUnit(us.numBuckets == 160);
+         assertUnit(us.get_allocator().pArena == &arena);
+         assertUnit(arena.numAllocate == 100 + 5);   // 100 nodes, 5 bucket arrays
+         assertUnit(arena.numDeallocate == 4);       // the 4 outgrown bucket arrays
+      }  // teardown
+      assertUnit(arena.numBytes == 0);
+   }
+
+   // moving between arenas without propagation moves each element
+   void test_alloc_moveAcross()
+   {  // setup
+      SpyArena arenaSrc;
+      SpyArena arenaDest;
+      {
+         typedef custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                                       std::equal_to<std::size_t>, SpyAlloc<std::size_t>> Set;
+         Set usSrc(&arenaSrc);
+         usSrc.insert(31);
+         usSrc.insert(67);
+         Set usDest(&arenaDest);
+         // exercise
+         usDest = std::move(usSrc);
+         // verify
+         assertUnit(usDest.get_allocator().pArena == &arenaDest);
+         assertUnit(usDest.size() == 2);
+         assertUnit(usDest.contains(31));
+         assertUnit(usDest.contains(67));
+         assertUnit(usSrc.empty());
+         assertUnit(arenaDest.numAllocate == 1 + 2); // its buckets and 2 nodes
+         assertUnit(arenaSrc.numDeallocate == 2);    // the 2 nodes left behind
+      }  // teardown
+      assertUnit(arenaSrc.numBytes == 0);
+      assertUnit(arenaDest.numBytes == 0);
+   }
+
+   // a node handle frees its node with the allocator it came from
+   void test_alloc_extract()
+   {  // setup
+      SpyArena arena;
+      custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                            std::equal_to<std::size_t>, SpyAlloc<std::size_t>> us(&arena);
+      us.insert(31);
+      us.insert(67);
+      {
+         // exercise
+         auto nh = us.extract(us.find(31));
+         // verify
+         assertUnit(!nh.empty());
+         assertUnit(nh.node.get_allocator().pArena == &arena);
+         assertUnit(arena.numDeallocate == 0);
+      }  // teardown
+      assertUnit(arena.numDeallocate == 1);
+      assertUnit(us.size() == 1);
+   }
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+   // a set can live entirely in a monotonic arena and never touch the heap
+   void test_alloc_pmrArena()
+   {  // setup
+      char buffer[32768];
+      std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                                std::pmr::null_memory_resource());
+      custom::pmr::unordered_set<std::size_t> us(&arena);
+      // exercise
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i * 10);
+      // verify
+      assertUnit(us.size() == 100);
+      assertUnit(us.get_allocator().resource() == &arena);
+      assertUnit(us.contains(990));
+      assertUnit(!us.contains(5));
+   }  // teardown
+#endif
+
+   /***************************************
+    * INCREMENTAL REHASH
+    ***************************************/
+
+   // with no budget, growing rehashes everything at once as before
+   void test_incremental_budgetZero()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 10; i++)
+         us.insert(i);
+      // exercise
+      us.insert(10);
+      // verify
+      assertUnit(us.rehash_budget() == 0);
+      assertUnit(us.numBuckets == 20);
+      assertUnit(us.bucketsOld == nullptr);
+      assertUnit(us.rehashing() == false);
+      assertUnit(us.rehash_progress() == 1.0f);
+   }  // teardown
+
+   // with a budget, growing only sets the old buckets aside, but for
+   // the one the new element would have gone in
+   void test_incremental_start()
+   {  // setup
+      //      h[0] --> 0
+      //      ...
+      //      h[9] --> 9
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 0; i < 10; i++)
+         us.insert(i);
+      // exercise
+      custom::pair<custom::unordered_set<std::size_t>::iterator, bool> p;
+      p = us.insert(10);
+      // verify
+      //    old[0]   gone         new[0]  --> 0
+      //    old[1] --> 1          new[1]    not built
+      //    ...                   ...
+      //    old[9] --> 9          new[10] --> 10
+      assertUnit(us.rehashing() == true);
+      assertUnit(us.rehash_progress() == 0.0f);
+      assertUnit(us.numElements == 11);
+      assertUnit(us.numBuckets == 20);
+      assertUnit(us.numBucketsOld == 10);
+      assertUnit(us.iMigrate == 0);
+      assertUnit(us.isMigrated(0));
+      for (size_t i = 1; i < 10; i++)
+      {
+         assertUnit(!us.isMigrated(i));
+         assertUnit(us.bucketsOld[i].size() == 1);
+      }
+      assertUnit(us.buckets[0].size() == 1);
+      assertUnit(us.buckets[10].size() == 1);
+      assertUnit(p.first.pBucket == us.buckets + 10);
+      assertUnit(p.second == true);
+   }  // teardown
+
+   // every operation moves rehash_budget() old buckets
+   void test_incremental_budget()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(4);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      us.find(99);
+      // verify
+      //    99 would be in old[9], so that is emptied too
+      assertUnit(us.iMigrate == 4);
+      assertUnit(us.rehash_progress() == 0.4f);
+      for (size_t i = 0; i < 10; i++)
+         assertUnit(us.isMigrated(i) == (i < 4 || i == 9));
+      for (size_t i = 4; i < 9; i++)
+         assertUnit(us.bucketsOld[i].size() == 1);
+      for (size_t i = 0; i < 4; i++)
+         assertUnit(us.buckets[i].size() == 1);
+      assertUnit(us.buckets[9].size() == 1);
+   }  // teardown
+
+   // an element still in the old buckets is found, and moved over first
+   void test_incremental_findOld()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      custom::unordered_set<std::size_t>::iterator it = us.find(7);
+      // verify
+      //    old[0]   gone         new[0]  --> 0
+      //    old[7]   gone         new[7]  --> 7
+      assertUnit(it != us.end());
+      assertUnit(*it == 7);
+      assertUnit(it.pBucket == us.buckets + 7);
+      assertUnit(us.iMigrate == 1);
+      assertUnit(us.isMigrated(0));
+      assertUnit(us.isMigrated(7));
+      assertUnit(!us.isMigrated(8));
+      assertUnit(us.buckets[0].size() == 1);
+      assertUnit(us.buckets[7].size() == 1);
+      assertUnit(us.find(11) == us.end());
+   }  // teardown
+
+   // a batch looks in both arrays
+   void test_incremental_findBatch()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      std::size_t keys[4] = { 3, 9, 10, 42 };
+      bool found[4] = { false, false, false, true };
+      // exercise
+      us.contains_batch(keys, 4, found);
+      // verify
+      assertUnit(found[0] == true);
+      assertUnit(found[1] == true);
+      assertUnit(found[2] == true);
+      assertUnit(found[3] == false);
+      assertUnit(us.rehashing() == true);
+   }  // teardown
+
+   // an element still in the old buckets is not inserted twice
+   void test_incremental_insertDuplicate()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      custom::pair<custom::unordered_set<std::size_t>::iterator, bool> p;
+      p = us.insert(5);
+      // verify
+      assertUnit(p.second == false);
+      assertUnit(p.first.pBucket == us.buckets + 5);
+      assertUnit(*p.first == 5);
+      assertUnit(us.numElements == 11);
+      assertUnit(us.buckets[5].size() == 1);
+   }  // teardown
+
+   // an element still in the old buckets can be erased
+   void test_incremental_erase()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      us.erase(8);
+      // verify
+      assertUnit(us.numElements == 10);
+      assertUnit(us.find(8) == us.end());
+      assertUnit(us.isMigrated(8));
+      assertUnit(us.buckets[8].empty());
+      assertUnit(us.buckets[18].empty());
+   }  // teardown
+
+   // once every old bucket is empty the old array is freed
+   void test_incremental_finish()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      // exercise
+      for (std::size_t i = 0; i < 10; i++)
+         us.find(99);
+      // verify
+      assertUnit(us.rehashing() == false);
+      assertUnit(us.bucketsOld == nullptr);
+      assertUnit(us.rehash_progress() == 1.0f);
+      assertUnit(us.numBuckets == 20);
+      for (size_t i = 0; i < 20; i++)
+         assertUnit(us.buckets[i].size() == (i <= 10 ? 1 : 0));
+   }  // teardown
+
+   // walking the set finishes the migration so nothing is missed
+   void test_incremental_beginFinishes()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      std::size_t sum = 0;
+      // exercise
+      for (auto it = us.begin(); it != us.end(); ++it)
+         sum += *it;
+      // verify
+      assertUnit(us.rehashing() == false);
+      assertUnit(sum == 55);
+   }  // teardown
+
+   // walking on from a find reaches the elements not yet moved too
+   void test_incremental_walkFromFind()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 0; i < 600; i++)
+         us.insert(i);
+      std::size_t num = 0;
+      // exercise
+      for (auto it = us.find(0); it != us.end(); ++it)
+         num++;
+      // verify
+      assertUnit(us.rehashing() == true);
+      assertUnit(num == us.size());
+   }  // teardown
+
+   // the element after an erased one leads on to everything after it
+   void test_incremental_eraseNext()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 0; i < 600; i++)
+         us.insert(i);
+      std::size_t num = 0;
+      // exercise
+      for (auto it = us.erase(0); it != us.end(); ++it)
+         num++;
+      // verify
+      assertUnit(us.rehashing() == true);
+      assertUnit(num == us.size());
+      assertUnit(num == 599);
+   }  // teardown
+
+   // a merge that starts a rehash part way still finds every duplicate
+   void test_incremental_merge()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 30; i < 40; i++)
+         us.insert(i);
+      custom::unordered_set<std::size_t> usSrc;
+      for (std::size_t i = 0; i < 40; i++)
+         usSrc.insert(i);
+      // exercise
+      us.merge(usSrc);
+      // verify
+      assertUnit(us.size() == 40);
+      assertUnit(usSrc.size() == 10);
+      std::vector<std::size_t> seen;
+      for (auto it = us.begin(); it != us.end(); ++it)
+         seen.push_back(*it);
+      std::sort(seen.begin(), seen.end());
+      bool eachOnce = seen.size() == 40;
+      for (std::size_t i = 0; i < seen.size(); i++)
+         if (seen[i] != i)
+            eachOnce = false;
+      assertUnit(eachOnce);
+      bool duplicatesLeft = true;
+      for (std::size_t i = 30; i < 40; i++)
+         if (!usSrc.contains(i))
+            duplicatesLeft = false;
+      assertUnit(duplicatesLeft);
+   }  // teardown
+
+   // the bucket interface answers for the new buckets, moved or not
+   void test_incremental_bucket()
+   {  // setup
+      //    old[0] --> 0          new[0]  -->
+      //    ...                   ...
+      //    old[9] --> 9          new[10] --> 10
+      custom::unordered_set<std::size_t> us;
+      us.rehash_budget(1);
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      const custom::unordered_set<std::size_t>& usConst = us;
+      // exercise
+      size_t num7 = usConst.bucket_size(7);
+      size_t num17 = usConst.bucket_size(17);
+      size_t num10 = usConst.bucket_size(10);
+      bool rehashingBefore = us.rehashing();
+      size_t iBucket = us.bucket(7);
+      // verify
+      assertUnit(num7 == 1);
+      assertUnit(num17 == 0);
+      assertUnit(num10 == 1);
+      assertUnit(rehashingBefore == true);
+      assertUnit(iBucket == 7);
+      assertUnit(us.rehashing() == false);
+      assertUnit(us.bucket_size(7) == 1);
+   }  // teardown
+
+   /***************************************
+    * STATISTICS
+    ***************************************/
+
+   // the default policy takes no room and writes nothing
+   void test_stats_none()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::ostringstream out;
+      // exercise
+      us.dump_stats(out);
+      // verify
+      assertUnit(std::is_empty<custom::no_stats>::value);
+      assertUnit(sizeof(custom::unordered_set<std::size_t>) ==
+                 sizeof(custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                                              std::equal_to<std::size_t>,
+                                              std::allocator<std::size_t>,
+                                              custom::hash_stats>) -
+                 sizeof(custom::hash_stats));
+      assertUnit(out.str().empty());
+   }  // teardown
+
+   // every operation is counted, along with the chain it walked
+   void test_stats_count()
+   {  // setup
+      custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                            std::equal_to<std::size_t>,
+                            std::allocator<std::size_t>,
+                            custom::hash_stats> us;
+      // exercise
+      //      h[1] --> 31
+      //      h[7] --> 67
+      //      h[9] --> 59 49
+      us.insert(31);     // walks 0
+      us.insert(67);     // walks 0
+      us.insert(59);     // walks 0
+      us.insert(49);     // walks 1
+      us.insert(31);     // walks 1, duplicate
+      us.find(67);       // walks 1, hit
+      us.find(2);        // walks 0, miss
+      us.count(49);      // walks 2, hit
+      us.erase(59);      // walks 1, not a find
+      // verify
+      assertUnit(us.stats().inserts() == 4);
+      assertUnit(us.stats().hits() == 2);
+      assertUnit(us.stats().misses() == 1);
+      assertUnit(us.stats().erases() == 1);
+      assertUnit(us.stats().rehashes() == 0);
+      assertUnit(us.stats().allocations() == 4);
+      assertUnit(us.stats().compares() == 6);
+      assertUnit(us.stats().probes(0) == 4);
+      assertUnit(us.stats().probes(1) == 4);
+      assertUnit(us.stats().probes(2) == 1);
+      assertUnit(us.stats().probes(3) == 0);
+   }  // teardown
+
+   // extracting a node counts as an erase, and inserting it back as an insert
+   void test_stats_extract()
+   {  // setup
+      custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                            std::equal_to<std::size_t>,
+                            std::allocator<std::size_t>,
+                            custom::hash_stats> us;
+      us.insert(31);
+      us.insert(67);
+      us.insert(49);
+      // exercise
+      auto nh = us.extract(67);
+      size_t numErases = us.stats().erases();
+      size_t numBalance = us.stats().inserts() - us.stats().erases();
+      us.insert(std::move(nh));
+      // verify
+      assertUnit(numErases == 1);
+      assertUnit(numBalance == 2);
+      assertUnit(us.stats().inserts() - us.stats().erases() == us.size());
+      assertUnit(us.stats().allocations() == 3);
+   }  // teardown
+
+   // merging moves the counts with the nodes, and is not a lookup
+   void test_stats_merge()
+   {  // setup
+      custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                            std::equal_to<std::size_t>,
+                            std::allocator<std::size_t>,
+                            custom::hash_stats> us;
+      custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                            std::equal_to<std::size_t>,
+                            std::allocator<std::size_t>,
+                            custom::hash_stats> usSource;
+      us.insert(31);     // walks 0
+      us.insert(67);     // walks 0
+      usSource.insert(67);
+      usSource.insert(49);
+      usSource.insert(59);
+      // exercise
+      us.merge(usSource);
+      // verify
+      assertUnit(us.size() == 4);
+      assertUnit(usSource.size() == 1);
+      assertUnit(us.stats().inserts() == 4);
+      assertUnit(us.stats().erases() == 0);
+      assertUnit(usSource.stats().inserts() == 3);
+      assertUnit(usSource.stats().erases() == 2);
+      assertUnit(us.stats().inserts() - us.stats().erases() == us.size());
+      assertUnit(usSource.stats().inserts() - usSource.stats().erases() ==
+                 usSource.size());
+      assertUnit(us.stats().hits() == 0);
+      assertUnit(us.stats().misses() == 0);
+      assertUnit(us.stats().compares() == 0);
+      assertUnit(us.stats().probes(0) == 2);
+      assertUnit(us.stats().probes(1) == 0);
+      assertUnit(us.stats().probes(2) == 0);
+   }  // teardown
+
+   // growing and reserving are each one rehash
+   void test_stats_rehash()
+   {  // setup
+      custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                            std::equal_to<std::size_t>,
+                            std::allocator<std::size_t>,
+                            custom::hash_stats> us;
+      // exercise
+      for (std::size_t i = 0; i < 11; i++)
+         us.insert(i);
+      us.reserve(100);
+      // verify
+      assertUnit(us.numBuckets == 100);
+      assertUnit(us.stats().rehashes() == 2);
+      assertUnit(us.stats().inserts() == 11);
+      us.stats().reset();
+      assertUnit(us.stats().rehashes() == 0);
+      assertUnit(us.stats().inserts() == 0);
+      assertUnit(us.stats().probes(0) == 0);
+   }  // teardown
+
+   // the dump has the counts and both histograms
+   void test_stats_dump()
+   {  // setup
+      custom::unordered_set<std::size_t, std::hash<std::size_t>,
+                            std::equal_to<std::size_t>,
+                            std::allocator<std::size_t>,
+                            custom::hash_stats> us;
+      us.insert(31);
+      us.insert(67);
+      us.insert(59);
+      us.insert(49);
+      us.find(67);
+      std::ostringstream out;
+      // exercise
+      us.dump_stats(out);
+      // verify
+      std::string dump = out.str();
+      assertUnit(dump.find("size 4, buckets 10") != std::string::npos);
+      assertUnit(dump.find("inserts 4, hits 1, misses 0, erases 0") != std::string::npos);
+      assertUnit(dump.find("rehashes 0, allocations 4, compares 2") != std::string::npos);
+      assertUnit(dump.find("probe lengths: 0:3 1:2\n") != std::string::npos);
+      assertUnit(dump.find("chain lengths: 0:7 1:2 2:1\n") != std::string::npos);
+   }  // teardown
+
+   /***************************************
+    * HASH QUALITY
+    ***************************************/
+
+   // multiples of 10 with an identity hash all land in bucket 0
+   void test_quality_clustered()
+   {  // setup
+      std::vector<std::size_t> keys;
+      for (std::size_t i = 0; i < 100; i++)
+         keys.push_back(i * 10);
+      std::ostringstream out;
+      // exercise
+      custom::hash_quality hq = custom::analyze_hash(keys.begin(), keys.end(),
+                                                     std::hash<std::size_t>(), { 10 });
+      hq.print(out);
+      // verify
+      //    variance (90^2 + 9 * 10^2) / 10 = 900 where random gives 10 * 0.9
+      assertUnit(hq.numKeys == 100);
+      assertUnit(hq.buckets.size() == 1);
+      assertUnit(hq.buckets[0].numBuckets == 10);
+      assertUnit(hq.buckets[0].longestChain == 100);
+      assertUnit(hq.buckets[0].numEmpty == 9);
+      assertUnit(hq.buckets[0].numCollisions == 99);
+      assertUnit(hq.buckets[0].variance == 900.0);
+      assertUnit(hq.buckets[0].varianceRatio() > 99.0);
+      assertUnit(hq.avalanche == 0.5);
+      assertUnit(hq.needsMixing());
+      assertUnit(out.str().find("a mixing finalizer is recommended") != std::string::npos);
+   }  // teardown
+
+   // a mixing hash spreads the same kind of keys like a random one
+   void test_quality_mixed()
+   {  // setup
+      std::vector<std::size_t> keys;
+      for (std::size_t i = 0; i < 1000; i++)
+         keys.push_back(i * 10);
+      // exercise
+      custom::hash_quality hq = custom::analyze_hash(keys.begin(), keys.end(), MixHash());
+      // verify
+      //    10 to start, 1280 after growing, 1024 for a flat set
+      assertUnit(hq.buckets.size() == 3);
+      assertUnit(hq.buckets[0].numBuckets == 10);
+      assertUnit(hq.buckets[1].numBuckets == 1280);
+      assertUnit(hq.buckets[2].numBuckets == 1024);
+      for (size_t i = 0; i < hq.buckets.size(); i++)
+         assertUnit(hq.buckets[i].varianceRatio() < 1.5);
+      assertUnit(hq.numSameHash == 0);
+      assertUnit(hq.bitBias < 0.1);
+      assertUnit(hq.avalanche >= 0.0 && hq.avalanche < 0.1);
+      assertUnit(!hq.needsMixing());
+   }  // teardown
+
+   // keys whose full hashes are equal are counted, every one of them
+   void test_quality_sameHash()
+   {  // setup
+      std::vector<std::size_t> keys = { 0, 1, 2, 3, 4, 6 };
+      // exercise
+      custom::hash_quality hq = custom::analyze_hash(keys.begin(), keys.end(), HalfHash());
+      // verify
+      //    0 1 -> 0,  2 3 -> 1,  4 -> 2,  6 -> 3
+      assertUnit(hq.numSameHash == 4);
+   }  // teardown
+
+   // string keys are measured, but not for avalanche
+   void test_quality_strings()
+   {  // setup
+      std::vector<std::string> keys;
+      for (int i = 0; i < 100; i++)
+         keys.push_back("key" + std::to_string(i));
+      // exercise
+      custom::hash_quality hq = custom::analyze_hash(keys.begin(), keys.end(),
+                                                     std::hash<std::string>());
+      // verify
+      assertUnit(hq.numKeys == 100);
+      assertUnit(hq.buckets.size() == 3);
+      assertUnit(hq.buckets[1].numBuckets == 160);
+      assertUnit(hq.buckets[2].numBuckets == 128);
+      assertUnit(hq.avalanche == -1.0);
+   }  // teardown
+
+   /***************************************
+    * FAST HASHERS
+    ***************************************/
+
+   // the integer mixer passes the analyzer where identity fails
+   void test_fastHash_mix()
+   {  // setup
+      std::vector<std::size_t> keys;
+      for (std::size_t i = 0; i < 1000; i++)
+         keys.push_back(i * 10);
+      // exercise
+      custom::hash_quality hq = custom::analyze_hash(keys.begin(), keys.end(),
+                                                     custom::fast_hash());
+      // verify
+      assertUnit(custom::mix64(0) == 0);
+      assertUnit(custom::mix64(1) != 1);
+      assertUnit(hq.numSameHash == 0);
+      assertUnit(!hq.needsMixing());
+   }  // teardown
+
+   // every length takes its own path through the tail; none may read
+   // past the end, and a byte anywhere in the input changes the hash
+   void test_fastHash_bytesEveryLength()
+   {  // setup
+      unsigned char buffer[128] = {};
+      std::vector<std::size_t> hashes;
+      bool allSensitive = true;
+      // exercise
+      for (size_t num = 0; num <= 100; num++)
+      {
+         std::vector<unsigned char> bytes(buffer, buffer + num);
+         uint64_t hash = custom::hash_bytes(bytes.data(), num);
+         hashes.push_back((std::size_t)hash);
+         for (size_t i = 0; i < num; i++)
+         {
+            bytes[i] = 1;
+            if (custom::hash_bytes(bytes.data(), num) == hash)
+               allSensitive = false;
+            bytes[i] = 0;
+         }
+      }
+      // verify
+      std::sort(hashes.begin(), hashes.end());
+      assertUnit(std::unique(hashes.begin(), hashes.end()) == hashes.end());
+      assertUnit(allSensitive);
+   }  // teardown
+
+   // a std::string and a C string with the same text hash the same
+   void test_fastHash_strings()
+   {  // setup
+      custom::fast_hash hash;
+      std::string s = "the quick brown fox jumps over the lazy dog";
+      // exercise
+      std::size_t hashString = hash(s);
+      std::size_t hashChars = hash(s.c_str());
+      // verify
+      assertUnit(hashString == hashChars);
+      assertUnit(hashString == custom::hash_bytes(s.data(), s.size()));
+      assertUnit(hash(std::string("a")) != hash(std::string("b")));
+   }  // teardown
+
+   // drop the hasher into a set, and search strings without building one
+   void test_fastHash_set()
+   {  // setup
+      custom::unordered_set<std::string, custom::fast_hash, std::equal_to<>> us;
+      custom::unordered_set<std::size_t, custom::fast_hash> usInt;
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         us.insert("key" + std::to_string(i));
+         usInt.insert((std::size_t)i * 10);
+      }
+      // verify
+      assertUnit(us.size() == 100);
+      assertUnit(us.find("key42") != us.end());
+      assertUnit(!us.contains("key100"));
+      assertUnit(usInt.size() == 100);
+      assertUnit(usInt.contains(990));
+      assertUnit(!usInt.contains(995));
+   }  // teardown
+
+   // a seed changes every hash; the default seed is shared
+   void test_seededHash_seed()
+   {  // setup
+      custom::seeded_hash hash1(1);
+      custom::seeded_hash hash2(2);
+      custom::seeded_hash hashDefault1;
+      custom::seeded_hash hashDefault2;
+      std::string s = "hello";
+      // exercise
+      // verify
+      assertUnit(hash1(s) != hash2(s));
+      assertUnit(hash1((std::size_t)7) != hash2((std::size_t)7));
+      assertUnit(hash1(s) == custom::seeded_hash(1)(s));
+      assertUnit(hash1(s) == hash1(s.c_str()));
+      assertUnit(hashDefault1.get_seed() == hashDefault2.get_seed());
+      assertUnit(hashDefault1(s) == hashDefault2(s));
+   }  // teardown
+
+   /***************************************
+    * FLAT UNORDERED SET
+    ***************************************/
+
+   // create an empty flat unordered set
+   void test_flat_construct_default()
+   {  // setup
+      // exercise
+      custom::flat_unordered_set<std::size_t> us;
+      // verify
+      assertUnit(us.numElements == 0);
+      assertUnit(us.numSlots == 16);
+      for (size_t i = 0; i < 16; i++)
+         assertUnit(us.slots[i].used == false);
+      assertUnit(us.begin() == us.end());
+   }  // teardown
+
+   // colliding elements take the next slots in the probe run
+   void test_flat_insert_collide()
+   {  // setup
+      custom::flat_unordered_set<std::size_t> us;
+      std::vector<std::size_t> home1 = keysAtHome(us, 1, 2);
+      std::size_t key2 = keysAtHome(us, 2, 1)[0];
+      // exercise
+      us.insert(home1[0]);
+      us.insert(home1[1]);
+      us.insert(key2);       // home slot 2 is taken
+      // verify
+      //      s[1] --> home1[0]
+      //      s[2] --> home1[1]
+      //      s[3] --> key2
+      assertUnit(us.numElements == 3);
+      assertUnit(us.slots[1].used && us.slots[1].data == home1[0]);
+      assertUnit(us.slots[2].used && us.slots[2].data == home1[1]);
+      assertUnit(us.slots[3].used && us.slots[3].data == key2);
+      assertUnit(us.slots[4].used == false);
+   }  // teardown
+
+   // inserting a duplicate returns the existing element
+   void test_flat_insert_duplicate()
+   {  // setup
+      custom::flat_unordered_set<std::size_t> us;
+      std::vector<std::size_t> home1 = keysAtHome(us, 1, 2);
+      us.insert(home1[0]);
+      us.insert(home1[1]);
+      // exercise
+      custom::pair<custom::flat_unordered_set<std::size_t>::iterator, bool> p = us.insert(home1[1]);
+      // verify
+      assertUnit(us.numElements == 2);
+      assertUnit(p.second == false);
+      assertUnit(p.first.pSlot == us.slots + 2);
+   }  // teardown
+
+   // inserting past the max load factor doubles the slots
+   void test_flat_insert_grow()
+   {  // setup
+      custom::flat_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 12; i++)
+         us.insert(i);
+      assertUnit(us.numSlots == 16);
+      // exercise
+      us.insert(12);
+      // verify
+      assertUnit(us.numElements == 13);
+      assertUnit(us.numSlots == 32);
+      std::size_t numUsed = 0;
+      for (std::size_t i = 0; i < us.numSlots; i++)
+         if (us.slots[i].used)
+            numUsed++;
+      assertUnit(numUsed == 13);
+      bool allFound = true;
+      for (std::size_t i = 0; i < 13; i++)
+         if (us.find(i) == us.end() || *us.find(i) != i)
+            allFound = false;
+      assertUnit(allFound);
+   }  // teardown
+
+   // strided keys are spread over the slots, not piled on one
+   void test_flat_insert_strided()
+   {  // setup
+      custom::flat_unordered_set<std::size_t> us;
+      // exercise
+      for (std::size_t i = 0; i < 10000; i++)
+         us.insert(i * 1024);
+      // verify
+      assertUnit(us.size() == 10000);
+      assertUnit(us.max_probe_length() < 64);
+   }  // teardown
+
+   // a miss stops at the first empty slot of the probe run
+   void test_flat_find_missing()
+   {  // setup
+      custom::flat_unordered_set<std::size_t> us;
+      std::vector<std::size_t> home1 = keysAtHome(us, 1, 3);
+      us.insert(home1[0]);
+      us.insert(home1[1]);
+      // exercise
+      custom::flat_unordered_set<std::size_t>::iterator it = us.find(home1[2]);
+      // verify
+      assertUnit(it == us.end());
+      assertUnit(us.find(home1[1]).pSlot == us.slots + 2);
+   }  // teardown
+
+   // erasing from the middle of a run pulls the rest of the run back
+   void test_flat_erase_shiftBack()
+   {  // setup
+      //      s[1] --> home1[0]
+      //      s[2] --> home1[1]
+      //      s[3] --> key2
+      //      s[4] --> home1[2]
+      custom::flat_unordered_set<std::size_t> us;
+      std::vector<std::size_t> home1 = keysAtHome(us, 1, 3);
+      std::size_t key2 = keysAtHome(us, 2, 1)[0];
+      us.insert(home1[0]);
+      us.insert(home1[1]);
+      us.insert(key2);
+      us.insert(home1[2]);
+      // exercise
+      custom::flat_unordered_set<std::size_t>::iterator it = us.erase(home1[0]);
+      // verify
+      //      s[1] --> home1[1]
+      //      s[2] --> key2
+      //      s[3] --> home1[2]
+      //      s[4] -->
+      assertUnit(us.numElements == 3);
+      assertUnit(us.slots[1].used && us.slots[1].data == home1[1]);
+      assertUnit(us.slots[2].used && us.slots[2].data == key2);
+      assertUnit(us.slots[3].used && us.slots[3].data == home1[2]);
+      assertUnit(us.slots[4].used == false);
+      assertUnit(it.pSlot == us.slots + 1);
+      assertUnit(us.find(home1[2]) != us.end());
+   }  // teardown
+
+   // a run that wraps past the last slot is shifted across the wrap
+   void test_flat_erase_wrap()
+   {  // setup
+      //      s[0]  --> home15[1]
+      //      s[1]  --> key1
+      //      s[15] --> home15[0]
+      custom::flat_unordered_set<std::size_t> us;
+      std::vector<std::size_t> home15 = keysAtHome(us, 15, 2);
+      std::size_t key1 = keysAtHome(us, 1, 1)[0];
+      us.insert(home15[0]);
+      us.insert(home15[1]);
+      us.insert(key1);
+      assertUnit(us.slots[0].used && us.slots[0].data == home15[1]);
+      // exercise
+      us.erase(home15[0]);
+      // verify
+      //      s[0]  -->
+      //      s[1]  --> key1
+      //      s[15] --> home15[1]
+      assertUnit(us.numElements == 2);
+      assertUnit(us.slots[15].used && us.slots[15].data == home15[1]);
+      assertUnit(us.slots[0].used == false);
+      assertUnit(us.slots[1].used && us.slots[1].data == key1);
+   }  // teardown
+
+   // iteration visits every element exactly once
+   void test_flat_iterate()
+   {  // setup
+      custom::flat_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 100; i += 3)
+         us.insert(i);
+      std::size_t count = 0;
+      std::size_t sum = 0;
+      // exercise
+      for (auto it = us.begin(); it != us.end(); ++it)
+      {
+         count++;
+         sum += *it;
+      }
+      // verify
+      assertUnit(count == 34);
+      assertUnit(sum == 1683);
+   }  // teardown
+
+   // the longest probe is the element furthest from its home slot
+   void test_flat_maxProbeLength()
+   {  // setup
+      //      s[1] --> home1[0]
+      //      s[2] --> home1[1]
+      //      s[3] --> home1[2]
+      custom::flat_unordered_set<std::size_t> us;
+      std::vector<std::size_t> home1 = keysAtHome(us, 1, 3);
+      assertUnit(us.max_probe_length() == 0);
+      us.insert(home1[0]);
+      us.insert(home1[1]);
+      us.insert(home1[2]);
+      // exercise
+      size_t numMax = us.max_probe_length();
+      // verify
+      assertUnit(numMax == 3);
+      assertUnit(us.slots[3].dist == 2);
+   }  // teardown
+
+   /***************************************
+    * ROBIN HOOD UNORDERED SET
+    ***************************************/
+
+   // an element far from home takes the slot of one closer to home
+   void test_robinHood_insert_displace()
+   {  // setup
+      //      s[1] --> home1[0]   dist 0
+      //      s[2] --> home1[1]   dist 1
+      //      s[3] --> key3       dist 0
+      custom::robin_hood_unordered_set<std::size_t> us;
+      std::vector<std::size_t> home1 = keysAtHome(us, 1, 3);
+      std::size_t key2 = keysAtHome(us, 2, 1)[0];
+      std::size_t key3 = keysAtHome(us, 3, 1)[0];
+      us.insert(home1[0]);
+      us.insert(key2);
+      us.insert(home1[1]);  // takes the slot of key2
+      us.erase(key2);
+      us.insert(key3);
+      custom::pair<custom::robin_hood_unordered_set<std::size_t>::iterator, bool> p;
+      // exercise
+      p = us.insert(home1[2]);  // takes the slot of key3
+      // verify
+      //      s[1] --> home1[0]   dist 0
+      //      s[2] --> home1[1]   dist 1
+      //      s[3] --> home1[2]   dist 2
+      //      s[4] --> key3       dist 1
+      assertUnit(us.numElements == 4);
+      assertUnit(us.slots[1].data == home1[0] && us.slots[1].dist == 0);
+      assertUnit(us.slots[2].data == home1[1] && us.slots[2].dist == 1);
+      assertUnit(us.slots[3].data == home1[2] && us.slots[3].dist == 2);
+      assertUnit(us.slots[4].data == key3     && us.slots[4].dist == 1);
+      assertUnit(p.second == true);
+      assertUnit(p.first.pSlot == us.slots + 3);
+   }  // teardown
+
+   // a miss stops at the first resident closer to home than the probe
+   void test_robinHood_find_stopEarly()
+   {  // setup
+      //      s[1] --> home1[0]   dist 0
+      //      s[2] --> home1[1]   dist 1
+      //      s[3] --> key3       dist 0
+      //      s[4] --> key4       dist 0
+      custom::robin_hood_unordered_set<std::size_t> us;
+      std::vector<std::size_t> home1 = keysAtHome(us, 1, 3);
+      std::size_t key3 = keysAtHome(us, 3, 1)[0];
+      std::size_t key4 = keysAtHome(us, 4, 1)[0];
+      us.insert(home1[0]);
+      us.insert(home1[1]);
+      us.insert(key3);
+      us.insert(key4);
+      // exercise
+      size_t i = us.findSlot(home1[2]);  // would be at s[3] with dist 2
+      // verify
+      assertUnit(i == us.numSlots);
+      assertUnit(us.find(home1[2]) == us.end());
+      assertUnit(us.find(key4) != us.end());
+   }  // teardown
+
+   // erase shifts the rest of the run back and shortens their distance
+   void test_robinHood_erase_shiftBack()
+   {  // setup
+      //      s[1] --> home1[0]   dist 0
+      //      s[2] --> home1[1]   dist 1
+      //      s[3] --> home1[2]   dist 2
+      //      s[4] --> key3       dist 1
+      custom::robin_hood_unordered_set<std::size_t> us;
+      std::vector<std::size_t> home1 = keysAtHome(us, 1, 3);
+      std::size_t key3 = keysAtHome(us, 3, 1)[0];
+      us.insert(home1[0]);
+      us.insert(key3);
+      us.insert(home1[1]);
+      us.insert(home1[2]);
+      // exercise
+      us.erase(home1[0]);
+      // verify
+      //      s[1] --> home1[1]   dist 0
+      //      s[2] --> home1[2]   dist 1
+      //      s[3] --> key3       dist 0
+      //      s[4] -->
+      assertUnit(us.numElements == 3);
+      assertUnit(us.slots[1].data == home1[1] && us.slots[1].dist == 0);
+      assertUnit(us.slots[2].data == home1[2] && us.slots[2].dist == 1);
+      assertUnit(us.slots[3].data == key3     && us.slots[3].dist == 0);
+      assertUnit(us.slots[4].used == false);
+   }  // teardown
+
+   // Robin Hood keeps the longest probe short under heavy collision
+   void test_robinHood_maxProbeLength()
+   {  // setup
+      custom::robin_hood_unordered_set<std::size_t> usRobin;
+      custom::flat_unordered_set<std::size_t> usLinear;
+      for (std::size_t i = 0; i < 1000; i++)
+      {
+         usRobin.insert(i * 37);
+         usLinear.insert(i * 37);
+      }
+      // exercise
+      size_t numRobin = usRobin.max_probe_length();
+      size_t numLinear = usLinear.max_probe_length();
+      // verify
+      assertUnit(numRobin <= numLinear);
+      bool allFound = true;
+      for (std::size_t i = 0; i < 1000; i++)
+         if (usRobin.find(i * 37) == usRobin.end())
+            allFound = false;
+      assertUnit(allFound);
+   }  // teardown
+
+   // strided keys keep a short longest probe, well under linear probing's
+   void test_robinHood_strided()
+   {  // setup
+      custom::robin_hood_unordered_set<std::size_t> usRobin;
+      custom::flat_unordered_set<std::size_t> usLinear;
+      // exercise
+      for (std::size_t i = 0; i < 10000; i++)
+      {
+         usRobin.insert(i * 1024);
+         usLinear.insert(i * 1024);
+      }
+      // verify
+      assertUnit(usRobin.size() == 10000);
+      assertUnit(usRobin.max_probe_length() <= usLinear.max_probe_length());
+      assertUnit(usRobin.max_probe_length() < 16);
+   }  // teardown
+
+   /***************************************
+    * SIZE EMPTY 
+    ***************************************/
+
+    // size of an empty hash
+   void test_size_empty()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      // exercise
+      size_t size = us.size();
+      // verify
+      assertUnit(0 == size);
+      assertEmptyFixture(us);
+   }  // teardown
+
+   // size of the standard hash
+   void test_size_standard()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      size_t size = us.size();
+      // verify
+      assertUnit(4 == size);
+      assertStandardFixture(us);
+      // teardown
+   }
+
+   // empty hash empty?
+   void test_empty_empty()
+   {  // setup
+      //      h[0] -->
+      //      h[1] -->
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] -->
+      //      h[8] -->
+      //      h[9] -->
+      custom::unordered_set<std::size_t> us;
+      // exercise
+      bool empty = us.empty();
+      // verify
+      assertUnit(true == empty);
+      //      h[0] -->
+      //      h[1] -->
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] -->
+      //      h[8] -->
+      //      h[9] -->
+      assertEmptyFixture(us);
+   }  // teardown
+
+   // standard hash empty?
+   void test_empty_standard()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      bool empty = us.empty();
+      // verify
+      assertUnit(false == empty);
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      assertStandardFixture(us);
+      // teardown
+   }
+
+   // verify the bucket size of an empty hash
+   void test_bucketSize_empty()
+   {  // setup
+      //      h[0] -->
+      //      h[1] -->
       //      h[2] -->
       //      h[3] -->
       //      h[4] -->
@@ -2394,6 +4320,21 @@ public:
       assertIndirect(us.buckets[8].size() == 0);
       assertIndirect(us.buckets[9].size() == 0);
    }
+
+   /*************************************************************
+    * KEYS AT HOME
+    * The first num keys, counting up from 0, whose home slot
+    * in a flat set the size of us is iHome
+    *************************************************************/
+   template <class Set>
+   std::vector<std::size_t> keysAtHome(const Set& us, size_t iHome, size_t num)
+   {
+      std::vector<std::size_t> keys;
+      for (std::size_t key = 0; keys.size() < num; key++)
+         if (us.bucket(key) == iHome)
+            keys.push_back(key);
+      return keys;
+   }
   
 
 };
@@ -0,0 +1,402 @@
+/***********************************************************************
+ * Header:
+ *    TEST INTRUSIVE
+ * Summary:
+ *    Unit tests for the intrusive list and the intrusive hash
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "intrusive.h"
+#include "unitTest.h"
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <utility>
+
+class TestIntrusive : public UnitTest
+{
+   // an object that can be linked into one container
+   struct Item
+   {
+      Item(int id = 0, const std::string& name = "") : id(id), name(name) {}
+      int id;
+      std::string name;
+      custom::list_hook hook;
+   };
+   typedef custom::intrusive_list<Item, &Item::hook> ItemList;
+
+   // items are keyed on their id alone
+   struct ItemHash
+   {
+      size_t operator()(const Item& item) const { return (size_t)item.id; }
+   };
+   struct ItemEqual
+   {
+      bool operator()(const Item& lhs, const Item& rhs) const { return lhs.id == rhs.id; }
+   };
+   typedef custom::intrusive_unordered_set<Item, &Item::hook, ItemHash, ItemEqual> ItemSet;
+
+public:
+   void run()
+   {
+      reset();
+
+      // Hook
+      test_hook_copyUnlinked();
+      test_hook_owner();
+
+      // List
+      test_list_default();
+      test_list_pushBoth();
+      test_list_insertMiddle();
+      test_list_eraseObject();
+      test_list_eraseIterator();
+      test_list_pop();
+      test_list_clearUnlinks();
+      test_list_move();
+      test_list_swapEmpty();
+      test_list_relink();
+
+      // Set
+      test_set_insertFind();
+      test_set_insertDuplicate();
+      test_set_eraseObject();
+      test_set_rehashKeepsObjects();
+      test_set_iterate();
+
+      report("Intrusive");
+   }
+
+   /***************************************
+    * HOOK
+    ***************************************/
+
+   // a copy of a linked object starts out in no list
+   void test_hook_copyUnlinked()
+   {  // setup
+      Item a(11);
+      ItemList l;
+      l.push_back(a);
+      // exercise
+      Item b(a);
+      // verify
+      assertUnit(a.hook.is_linked());
+      assertUnit(!b.hook.is_linked());
+      assertUnit(b.id == 11);
+      assertUnit(l.size() == 1);
+   }  // teardown
+
+   // a hook leads back to the object it is in
+   void test_hook_owner()
+   {  // setup
+      Item a(26, "green");
+      // exercise
+      Item& owner = ItemList::owner(a.hook);
+      // verify
+      assertUnit(&owner == &a);
+      assertUnit(owner.name == "green");
+   }  // teardown
+
+   /***************************************
+    * LIST
+    ***************************************/
+
+   // an empty list is a ring of just its root
+   void test_list_default()
+   {  // setup
+      // exercise
+      ItemList l;
+      // verify
+      assertUnit(l.numElements == 0);
+      assertUnit(l.root.pNext == &l.root);
+      assertUnit(l.root.pPrev == &l.root);
+      assertUnit(l.empty());
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // push links the object itself in at either end
+   void test_list_pushBoth()
+   {  // setup
+      Item a(11), b(26), c(31);
+      ItemList l;
+      // exercise
+      l.push_back(b);
+      l.push_back(c);
+      l.push_front(a);
+      // verify
+      assertUnit(l.size() == 3);
+      assertUnit(&l.front() == &a);
+      assertUnit(&l.back() == &c);
+      assertUnit(hasIds(l, { 11, 26, 31 }));
+      assertUnit(a.hook.pPrev == &l.root);
+      assertUnit(c.hook.pNext == &l.root);
+   }  // teardown
+
+   // insert links in just before the iterator
+   void test_list_insertMiddle()
+   {  // setup
+      Item a(11), b(26), c(31);
+      ItemList l;
+      l.push_back(a);
+      l.push_back(c);
+      auto it = l.begin();
+      ++it;
+      // exercise
+      auto itReturn = l.insert(it, b);
+      // verify
+      assertUnit(&*itReturn == &b);
+      assertUnit(hasIds(l, { 11, 26, 31 }));
+   }  // teardown
+
+   // an object can be taken out knowing only the object
+   void test_list_eraseObject()
+   {  // setup
+      Item a(11), b(26), c(31);
+      ItemList l;
+      l.push_back(a);
+      l.push_back(b);
+      l.push_back(c);
+      // exercise
+      auto itReturn = l.erase(b);
+      // verify
+      assertUnit(&*itReturn == &c);
+      assertUnit(!b.hook.is_linked());
+      assertUnit(b.id == 26);
+      assertUnit(hasIds(l, { 11, 31 }));
+   }  // teardown
+
+   // erase by iterator walks the list, leaving the objects alone
+   void test_list_eraseIterator()
+   {  // setup
+      Item items[5] = { 11, 26, 31, 49, 67 };
+      ItemList l;
+      for (int i = 0; i < 5; i++)
+         l.push_back(items[i]);
+      // exercise
+      auto it = l.begin();
+      while (it != l.end())
+      {
+         it = l.erase(it);
+         if (it != l.end())
+            ++it;
+      }
+      // verify
+      assertUnit(hasIds(l, { 26, 49 }));
+      assertUnit(!items[0].hook.is_linked());
+      assertUnit(items[1].hook.is_linked());
+      assertUnit(items[4].id == 67);
+   }  // teardown
+
+   // pop from either end until the list is empty
+   void test_list_pop()
+   {  // setup
+      Item a(11), b(26), c(31);
+      ItemList l;
+      l.push_back(a);
+      l.push_back(b);
+      l.push_back(c);
+      // exercise
+      l.pop_front();
+      l.pop_back();
+      int remaining = l.front().id;
+      l.pop_back();
+      l.pop_back();
+      // verify
+      assertUnit(remaining == 26);
+      assertUnit(l.empty());
+      assertUnit(l.root.pNext == &l.root);
+      assertUnit(!a.hook.is_linked());
+      assertUnit(!b.hook.is_linked());
+      assertUnit(!c.hook.is_linked());
+   }  // teardown
+
+   // clear unlinks everything, and the objects can join another list
+   void test_list_clearUnlinks()
+   {  // setup
+      Item a(11), b(26);
+      ItemList l1;
+      ItemList l2;
+      l1.push_back(a);
+      l1.push_back(b);
+      // exercise
+      l1.clear();
+      l2.push_back(b);
+      // verify
+      assertUnit(l1.empty());
+      assertUnit(!a.hook.is_linked());
+      assertUnit(hasIds(l2, { 26 }));
+   }  // teardown
+
+   // a moved list takes the objects, and the ends point at its root
+   void test_list_move()
+   {  // setup
+      Item a(11), b(26);
+      ItemList lSrc;
+      lSrc.push_back(a);
+      lSrc.push_back(b);
+      // exercise
+      ItemList lDes(std::move(lSrc));
+      // verify
+      assertUnit(lSrc.empty());
+      assertUnit(lSrc.root.pNext == &lSrc.root);
+      assertUnit(lDes.size() == 2);
+      assertUnit(a.hook.pPrev == &lDes.root);
+      assertUnit(b.hook.pNext == &lDes.root);
+      assertUnit(hasIds(lDes, { 11, 26 }));
+   }  // teardown
+
+   // swapping with an empty list leaves each a proper ring
+   void test_list_swapEmpty()
+   {  // setup
+      Item a(11);
+      ItemList l1;
+      ItemList l2;
+      l1.push_back(a);
+      // exercise
+      l1.swap(l2);
+      // verify
+      assertUnit(l1.empty());
+      assertUnit(l1.root.pNext == &l1.root);
+      assertUnit(l1.root.pPrev == &l1.root);
+      assertUnit(hasIds(l2, { 11 }));
+      assertUnit(a.hook.pNext == &l2.root);
+   }  // teardown
+
+   // moving an object between lists is two relinks and no copies
+   void test_list_relink()
+   {  // setup
+      Item a(11, "red");
+      ItemList lReady;
+      ItemList lDone;
+      lReady.push_back(a);
+      const std::string* pName = &a.name;
+      // exercise
+      lReady.erase(a);
+      lDone.push_back(a);
+      // verify
+      assertUnit(lReady.empty());
+      assertUnit(&lDone.front() == &a);
+      assertUnit(&lDone.front().name == pName);
+   }  // teardown
+
+   /***************************************
+    * SET
+    ***************************************/
+
+   // an inserted object is found by an equal key
+   void test_set_insertFind()
+   {  // setup
+      Item a(26, "green");
+      ItemSet s;
+      // exercise
+      auto result = s.insert(a);
+      // verify
+      assertUnit(result.second);
+      assertUnit(&*result.first == &a);
+      assertUnit(s.size() == 1);
+      Item key(26);
+      assertUnit(&*s.find(key) == &a);
+      assertUnit(s.bucket_size(26 % s.bucket_count()) == 1);
+      Item missing(49);
+      assertUnit(s.find(missing) == s.end());
+   }  // teardown
+
+   // an equal object is turned away and left unlinked
+   void test_set_insertDuplicate()
+   {  // setup
+      Item a(26, "green");
+      Item b(26, "olive");
+      ItemSet s;
+      s.insert(a);
+      // exercise
+      auto result = s.insert(b);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(&*result.first == &a);
+      assertUnit(!b.hook.is_linked());
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // an object is taken out of its chain without a search
+   void test_set_eraseObject()
+   {  // setup
+      Item a(6), b(16), c(26);   // all in bucket 6 of 10
+      ItemSet s;
+      s.insert(a);
+      s.insert(b);
+      s.insert(c);
+      // exercise
+      s.erase(b);
+      // verify
+      assertUnit(s.size() == 2);
+      assertUnit(!b.hook.is_linked());
+      assertUnit(s.bucket_size(6) == 2);
+      assertUnit(s.contains(a));
+      assertUnit(!s.contains(b));
+      assertUnit(s.contains(c));
+   }  // teardown
+
+   // growing the buckets relinks the objects where they are
+   void test_set_rehashKeepsObjects()
+   {  // setup
+      Item items[25];
+      for (int i = 0; i < 25; i++)
+         items[i].id = i * 3;
+      ItemSet s;
+      // exercise
+      for (int i = 0; i < 25; i++)
+         s.insert(items[i]);
+      // verify
+      assertUnit(s.size() == 25);
+      assertUnit(s.bucket_count() == 40);
+      bool allFound = true;
+      for (int i = 0; i < 25; i++)
+         if (&*s.find(items[i]) != &items[i])
+            allFound = false;
+      assertUnit(allFound);
+   }  // teardown
+
+   // iteration visits every object once, skipping empty buckets
+   void test_set_iterate()
+   {  // setup
+      Item a(1), b(11), c(7);
+      ItemSet s;
+      s.insert(a);
+      s.insert(b);
+      s.insert(c);
+      std::vector<int> seen;
+      // exercise
+      for (auto it = s.begin(); it != s.end(); ++it)
+         seen.push_back(it->id);
+      // verify
+      assertUnit(seen == std::vector<int>({ 1, 11, 7 }));
+      // teardown
+      s.clear();
+      assertUnit(!a.hook.is_linked());
+   }
+
+private:
+   // the list holds objects with exactly these ids, linked both ways
+   bool hasIds(ItemList& l, const std::vector<int>& ids)
+   {
+      if (l.size() != ids.size())
+         return false;
+      size_t i = 0;
+      custom::list_hook* pPrev = &l.root;
+      for (auto it = l.begin(); it != l.end(); ++it, ++i)
+      {
+         if (i >= ids.size() || it->id != ids[i] || it.p->pPrev != pPrev)
+            return false;
+         pPrev = it.p;
+      }
+      return i == ids.size() && l.root.pPrev == pPrev;
+   }
+};
+
+#endif // DEBUG
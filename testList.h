@@ -12,6 +12,7 @@
 #ifdef DEBUG
 
 #include "list.h"
+#include "spy.h"
 #include <list>
 #include "unitTest.h"
 
@@ -100,6 +101,13 @@ public:
       test_insertMove_standardFront();
       test_insertMove_standardMiddle();
 
+      // Emplace
+      test_emplaceback_noCopy();
+      test_emplacefront_noCopy();
+      test_emplace_middle();
+      test_emplace_emptyEnd();
+      test_emplace_manyArguments();
+
       // Remove
       test_clear_empty();
       test_clear_standard();
@@ -114,6 +122,30 @@ public:
       test_erase_standardMiddle();
       test_erase_standardEnd();
 
+      // Relink
+      test_splice_toEmpty();
+      test_splice_toFront();
+      test_splice_inPlace();
+      test_splice_wholeList();
+      test_splice_rangeOther();
+      test_splice_rangeSame();
+      test_merge_sorted();
+      test_sort_standard();
+      test_sort_noCopy();
+      test_sort_stable();
+      test_unique_runs();
+      test_removeIf_odd();
+      test_reverse_standard();
+
+      // Allocator
+      test_alloc_nodes();
+      test_alloc_nodesNoCopy();
+      test_alloc_copyKeeps();
+      test_alloc_copyPropagates();
+      test_alloc_moveAcross();
+      test_alloc_moveSame();
+      test_alloc_swapPropagates();
+
       // Status
       test_size_empty();
       test_size_three();
@@ -1889,6 +1921,131 @@ public:
    }
 
 
+   /***************************************
+    * EMPLACE
+    ***************************************/
+
+   // build an element at the back, right in its node
+   void test_emplaceback_noCopy()
+   {  // setup
+      custom::list<Spy> l;
+      l.emplace_back(11);
+      Spy::reset();
+      // exercise
+      Spy & s = l.emplace_back(99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(l.numElements == 2);
+      assertUnit(l.pTail != nullptr);
+      if (l.pTail)
+      {
+         assertUnit(&s == &l.pTail->data);
+         assertUnit(l.pTail->data.get() == 99);
+         assertUnit(l.pTail->pPrev == l.pHead);
+         assertUnit(l.pTail->pNext == nullptr);
+      }
+   }  // teardown
+
+   // build an element at the front, right in its node
+   void test_emplacefront_noCopy()
+   {  // setup
+      custom::list<Spy> l;
+      l.emplace_back(26);
+      Spy::reset();
+      // exercise
+      Spy & s = l.emplace_front(11);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(l.numElements == 2);
+      assertUnit(l.pHead != nullptr);
+      if (l.pHead)
+      {
+         assertUnit(&s == &l.pHead->data);
+         assertUnit(l.pHead->data.get() == 11);
+         assertUnit(l.pHead->pPrev == nullptr);
+         assertUnit(l.pHead->pNext == l.pTail);
+      }
+   }  // teardown
+
+   // build an element in the middle, right in its node
+   void test_emplace_middle()
+   {  // setup
+      //       +----+   +----+
+      //       | 11 | - | 31 |
+      //       +----+   +----+
+      //                  it
+      custom::list<Spy> l;
+      l.emplace_back(11);
+      l.emplace_back(31);
+      custom::list<Spy>::iterator it = l.begin();
+      ++it;
+      Spy::reset();
+      // exercise
+      custom::list<Spy>::iterator itReturn = l.emplace(it, 26);
+      // verify
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //               itReturn    it
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(l.numElements == 3);
+      assertUnit(itReturn.p != nullptr);
+      if (itReturn.p)
+      {
+         assertUnit(itReturn.p->data.get() == 26);
+         assertUnit(itReturn.p->pPrev == l.pHead);
+         assertUnit(itReturn.p->pNext == it.p);
+         assertUnit(it.p->pPrev == itReturn.p);
+         assertUnit(l.pHead->pNext == itReturn.p);
+      }
+   }  // teardown
+
+   // building at the end of an empty list makes it the only element
+   void test_emplace_emptyEnd()
+   {  // setup
+      custom::list<Spy> l;
+      Spy::reset();
+      // exercise
+      custom::list<Spy>::iterator itReturn = l.emplace(l.end(), 99);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(l.numElements == 1);
+      assertUnit(l.pHead != nullptr);
+      assertUnit(l.pHead == l.pTail);
+      assertUnit(itReturn.p == l.pHead);
+      if (l.pHead)
+         assertUnit(l.pHead->data.get() == 99);
+   }  // teardown
+
+   // any of the element's constructors can be used
+   void test_emplace_manyArguments()
+   {  // setup
+      custom::list<std::string> l;
+      // exercise
+      l.emplace_back(3, 'x');
+      l.emplace_front("abcdef", 2);
+      l.emplace(++l.begin());
+      // verify
+      assertUnit(l.numElements == 3);
+      assertUnit(l.pHead != nullptr && l.pHead->data == "ab");
+      assertUnit(l.pHead->pNext != nullptr && l.pHead->pNext->data.empty());
+      assertUnit(l.pTail != nullptr && l.pTail->data == "xxx");
+   }  // teardown
+
+
    /***************************************
     * ERASE
     ***************************************/
@@ -2044,6 +2201,401 @@ public:
       teardownStandardFixture(l);
    }
 
+   /***************************************
+    * SPLICE
+    ***************************************/
+
+   // move the middle node into an empty list
+   void test_splice_toEmpty()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  it
+      custom::list<int> lSrc;
+      setupStandardFixture(lSrc);
+      custom::list<int> lDest;
+      custom::list<int>::Node* p1 = lSrc.pHead;
+      custom::list<int>::Node* p2 = p1->pNext;
+      custom::list<int>::Node* p3 = p2->pNext;
+      // exercise
+      lDest.splice(lDest.end(), lSrc, custom::list<int>::iterator(p2));
+      // verify
+      //        pHead    pTail          pHead
+      //       +----+   +----+         +----+
+      //       | 11 | - | 31 |         | 26 |
+      //       +----+   +----+         +----+
+      assertUnit(lSrc.numElements == 2);
+      assertUnit(lSrc.pHead == p1);
+      assertUnit(lSrc.pTail == p3);
+      assertUnit(p1->pNext == p3);
+      assertUnit(p3->pPrev == p1);
+      assertUnit(lDest.numElements == 1);
+      assertUnit(lDest.pHead == p2);
+      assertUnit(lDest.pTail == p2);
+      assertUnit(p2->pNext == nullptr);
+      assertUnit(p2->pPrev == nullptr);
+      // teardown
+      teardownStandardFixture(lSrc);
+      teardownStandardFixture(lDest);
+   }
+
+   // move the tail node to the front of the same list
+   void test_splice_toFront()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //        pos                it
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::Node* p1 = l.pHead;
+      custom::list<int>::Node* p2 = p1->pNext;
+      custom::list<int>::Node* p3 = p2->pNext;
+      // exercise
+      l.splice(l.begin(), l, custom::list<int>::iterator(p3));
+      // verify
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 31 | - | 11 | - | 26 |
+      //       +----+   +----+   +----+
+      assertUnit(l.numElements == 3);
+      assertUnit(l.pHead == p3);
+      assertUnit(l.pTail == p2);
+      assertUnit(p3->pPrev == nullptr);
+      assertUnit(p3->pNext == p1);
+      assertUnit(p1->pPrev == p3);
+      assertUnit(p1->pNext == p2);
+      assertUnit(p2->pPrev == p1);
+      assertUnit(p2->pNext == nullptr);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // moving a node to where it already is changes nothing
+   void test_splice_inPlace()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  it      pos
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::iterator it(l.pHead->pNext);
+      custom::list<int>::iterator pos(l.pTail);
+      // exercise
+      l.splice(pos, l, it);
+      l.splice(it, l, it);
+      // verify
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // move all of one list into the middle of another
+   void test_splice_wholeList()
+   {  // setup
+      custom::list<int> lDes = { 11, 67 };
+      custom::list<int> lSrc = { 26, 31, 49 };
+      // exercise
+      lDes.splice(++lDes.begin(), lSrc);
+      // verify
+      assertUnit(hasElements(lDes, { 11, 26, 31, 49, 67 }));
+      assertUnit(hasElements(lSrc, { }));
+   }  // teardown
+
+   // move a run of nodes from one list to another
+   void test_splice_rangeOther()
+   {  // setup
+      custom::list<int> lDes = { 11, 67 };
+      custom::list<int> lSrc = { 99, 26, 31, 49, 88 };
+      custom::list<int>::iterator first(lSrc.pHead->pNext);
+      custom::list<int>::iterator last(lSrc.pTail);
+      custom::list<int>::iterator pos(lDes.pTail);
+      // exercise
+      lDes.splice(pos, lSrc, first, last);
+      // verify
+      assertUnit(hasElements(lDes, { 11, 26, 31, 49, 67 }));
+      assertUnit(hasElements(lSrc, { 99, 88 }));
+   }  // teardown
+
+   // move a run of nodes to another spot in the same list
+   void test_splice_rangeSame()
+   {  // setup
+      custom::list<int> l = { 11, 49, 67, 26, 31 };
+      custom::list<int>::iterator first(l.pHead->pNext->pNext->pNext);
+      custom::list<int>::iterator pos(l.pHead->pNext);
+      // exercise
+      l.splice(pos, l, first, l.end());
+      // verify
+      assertUnit(hasElements(l, { 11, 26, 31, 49, 67 }));
+   }  // teardown
+
+   // merge two sorted lists; of two equal elements ours comes first
+   void test_merge_sorted()
+   {  // setup
+      custom::list<int> lDes = { 11, 31, 67 };
+      custom::list<int> lSrc = { 26, 31, 49, 99 };
+      auto pOur31 = lDes.pHead->pNext;
+      auto pTheir31 = lSrc.pHead->pNext;
+      // exercise
+      lDes.merge(lSrc);
+      // verify
+      assertUnit(hasElements(lDes, { 11, 26, 31, 31, 49, 67, 99 }));
+      assertUnit(hasElements(lSrc, { }));
+      assertUnit(lDes.pHead->pNext->pNext == pOur31);
+      assertUnit(pOur31->pNext == pTheir31);
+   }  // teardown
+
+   // sort a long list, and sorting short ones changes nothing
+   void test_sort_standard()
+   {  // setup
+      custom::list<int> l;
+      unsigned int seed = 235;
+      for (int i = 0; i < 1000; i++)
+      {
+         seed = seed * 1103515245 + 12345;
+         l.push_back((int)(seed >> 16) % 500);
+      }
+      custom::list<int> lEmpty;
+      custom::list<int> lOne = { 11 };
+      // exercise
+      l.sort();
+      lEmpty.sort();
+      lOne.sort();
+      // verify
+      std::vector<int> sorted;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         sorted.push_back(*it);
+      assertUnit(sorted.size() == 1000);
+      assertUnit(std::is_sorted(sorted.begin(), sorted.end()));
+      assertUnit(hasElements(l, sorted));
+      assertUnit(hasElements(lEmpty, { }));
+      assertUnit(hasElements(lOne, { 11 }));
+   }  // teardown
+
+   // sorting only relinks: nothing is built, copied, moved or swapped
+   void test_sort_noCopy()
+   {  // setup
+      custom::list<Spy> l;
+      l.emplace_back(49);
+      l.emplace_back(11);
+      l.emplace_back(67);
+      l.emplace_back(26);
+      l.emplace_back(31);
+      Spy::reset();
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numSwap() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numLessthan() > 0);
+      assertUnit(l.front().get() == 11);
+      assertUnit(l.back().get() == 67);
+   }  // teardown
+
+   // elements that compare equal keep their order
+   void test_sort_stable()
+   {  // setup
+      custom::list<std::pair<int, char>> l =
+         { { 2, 'a' }, { 1, 'b' }, { 2, 'c' }, { 1, 'd' }, { 2, 'e' } };
+      // exercise
+      l.sort([](const std::pair<int, char>& lhs, const std::pair<int, char>& rhs)
+             { return lhs.first < rhs.first; });
+      // verify
+      std::string order;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         order += (*it).second;
+      assertUnit(order == "bdace");
+   }  // teardown
+
+   // unique erases each run of equal elements down to one
+   void test_unique_runs()
+   {  // setup
+      custom::list<int> l = { 11, 11, 26, 26, 26, 31, 11 };
+      // exercise
+      size_t num = l.unique();
+      // verify
+      assertUnit(num == 3);
+      assertUnit(hasElements(l, { 11, 26, 31, 11 }));
+   }  // teardown
+
+   // remove_if erases wherever the predicate holds
+   void test_removeIf_odd()
+   {  // setup
+      custom::list<int> l = { 11, 26, 31, 49, 66 };
+      // exercise
+      size_t num = l.remove_if([](int i) { return i % 2 == 1; });
+      // verify
+      assertUnit(num == 3);
+      assertUnit(hasElements(l, { 26, 66 }));
+   }  // teardown
+
+   // reverse turns the list around
+   void test_reverse_standard()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      auto pHead = l.pHead;
+      // exercise
+      l.reverse();
+      // verify
+      assertUnit(hasElements(l, { 31, 26, 11 }));
+      assertUnit(l.pTail == pHead);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // every node comes from the allocator and goes back to it
+   void test_alloc_nodes()
+   {  // setup
+      SpyArena arena;
+      {
+         custom::list<int, SpyAlloc<int>> l(&arena);
+         // exercise
+         l.push_back(26);
+         l.push_front(11);
+         l.insert(l.end(), 31);
+         // verify
+         assertUnit(arena.numAllocate == 3);
+         assertUnit(arena.numBytes > 0);
+         assertUnit(l.get_allocator().pArena == &arena);
+         l.pop_back();
+         assertUnit(arena.numDeallocate == 1);
+      }  // teardown
+      assertUnit(arena.numDeallocate == 3);
+      assertUnit(arena.numBytes == 0);
+   }
+
+   // making and freeing a node does not copy the allocator
+   void test_alloc_nodesNoCopy()
+   {  // setup
+      SpyArena arena;
+      custom::list<int, SpyAlloc<int>> l(&arena);
+      int numCopy = arena.numCopy;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         l.push_back(i);
+      l.pop_front();
+      l.clear();
+      // verify
+      assertUnit(arena.numAllocate == 10);
+      assertUnit(arena.numDeallocate == 10);
+      assertUnit(arena.numCopy == numCopy);
+   }  // teardown
+
+   // without propagation, a copy is built in the destination's arena
+   void test_alloc_copyKeeps()
+   {  // setup
+      SpyArena arenaSrc;
+      SpyArena arenaDest;
+      {
+         custom::list<int, SpyAlloc<int>> lSrc({ 11, 26, 31 }, &arenaSrc);
+         custom::list<int, SpyAlloc<int>> lDest({ 99 }, &arenaDest);
+         // exercise
+         lDest = lSrc;
+         // verify
+         assertUnit(lDest.get_allocator().pArena == &arenaDest);
+         assertUnit(arenaDest.numAllocate == 4);
+         assertUnit(arenaDest.numDeallocate == 1);
+         assertUnit(arenaSrc.numAllocate == 3);
+         assertUnit(lDest.size() == 3);
+         assertUnit(lDest.front() == 11);
+         assertUnit(lDest.back() == 31);
+      }  // teardown
+      assertUnit(arenaSrc.numBytes == 0);
+      assertUnit(arenaDest.numBytes == 0);
+   }
+
+   // with propagation, the destination frees its nodes and takes the allocator
+   void test_alloc_copyPropagates()
+   {  // setup
+      SpyArena arenaSrc;
+      SpyArena arenaDest;
+      {
+         custom::list<int, SpyAlloc<int, true>> lSrc({ 11, 26, 31 }, &arenaSrc);
+         custom::list<int, SpyAlloc<int, true>> lDest({ 99 }, &arenaDest);
+         // exercise
+         lDest = lSrc;
+         // verify
+         assertUnit(lDest.get_allocator().pArena == &arenaSrc);
+         assertUnit(arenaDest.numDeallocate == 1);
+         assertUnit(arenaDest.numBytes == 0);
+         assertUnit(arenaSrc.numAllocate == 6);
+         assertUnit(lDest.size() == 3);
+      }  // teardown
+      assertUnit(arenaSrc.numBytes == 0);
+   }
+
+   // moving between arenas without propagation moves each element
+   void test_alloc_moveAcross()
+   {  // setup
+      SpyArena arenaSrc;
+      SpyArena arenaDest;
+      {
+         custom::list<int, SpyAlloc<int>> lSrc({ 11, 26, 31 }, &arenaSrc);
+         custom::list<int, SpyAlloc<int>> lDest(&arenaDest);
+         // exercise
+         lDest = std::move(lSrc);
+         // verify
+         assertUnit(lDest.get_allocator().pArena == &arenaDest);
+         assertUnit(arenaDest.numAllocate == 3);
+         assertUnit(arenaSrc.numBytes == 0);
+         assertUnit(lSrc.empty());
+         assertUnit(lDest.size() == 3);
+         assertUnit(lDest.front() == 11);
+      }  // teardown
+      assertUnit(arenaDest.numBytes == 0);
+   }
+
+   // moving within an arena takes the nodes and allocates nothing
+   void test_alloc_moveSame()
+   {  // setup
+      SpyArena arena;
+      custom::list<int, SpyAlloc<int>> lSrc({ 11, 26, 31 }, &arena);
+      custom::list<int, SpyAlloc<int>> lDest(&arena);
+      custom::list<int, SpyAlloc<int>>::Node* pHead = lSrc.pHead;
+      // exercise
+      lDest = std::move(lSrc);
+      // verify
+      assertUnit(arena.numAllocate == 3);
+      assertUnit(arena.numDeallocate == 0);
+      assertUnit(lDest.pHead == pHead);
+      assertUnit(lSrc.empty());
+   }  // teardown
+
+   // with propagation, swap trades the allocators along with the nodes
+   void test_alloc_swapPropagates()
+   {  // setup
+      SpyArena arena1;
+      SpyArena arena2;
+      {
+         custom::list<int, SpyAlloc<int, true>> l1({ 11, 26 }, &arena1);
+         custom::list<int, SpyAlloc<int, true>> l2({ 31 }, &arena2);
+         // exercise
+         l1.swap(l2);
+         // verify
+         assertUnit(l1.get_allocator().pArena == &arena2);
+         assertUnit(l2.get_allocator().pArena == &arena1);
+         assertUnit(l1.size() == 1);
+         assertUnit(l2.size() == 2);
+      }  // teardown
+      assertUnit(arena1.numBytes == 0);
+      assertUnit(arena2.numBytes == 0);
+   }
+
 
    /***************************************
     * ITERATOR
@@ -2451,7 +3003,26 @@ public:
       }
    }
 
-
+   /****************************************************************
+    * Has Elements
+    * Does the list hold exactly these, linked up both ways?
+    ****************************************************************/
+   template <class T>
+   bool hasElements(const custom::list<T>& l, const std::vector<T>& values)
+   {
+      if (l.numElements != values.size())
+         return false;
+      auto p = l.pHead;
+      decltype(p) pPrev = nullptr;
+      for (size_t i = 0; i < values.size(); i++)
+      {
+         if (!p || !(p->data == values[i]) || p->pPrev != pPrev)
+            return false;
+         pPrev = p;
+         p = p->pNext;
+      }
+      return p == nullptr && l.pTail == pPrev;
+   }
 };
 
 #endif // DEBUG
@@ -0,0 +1,431 @@
+/***********************************************************************
+ * Header:
+ *    TEST LOCK FREE
+ * Summary:
+ *    Unit tests for the split-ordered lock-free hash
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "lockfree.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+// the hash of a Spy is the number it holds
+struct SpyValueHash
+{
+   std::size_t operator()(const Spy& s) const { return (std::size_t)s.get(); }
+};
+
+class TestLockFree : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Split order
+      test_reverse_standard();
+      test_splitOrder_bucketsInOrder();
+
+      // Construct
+      test_construct_default();
+
+      // Insert
+      test_insert_empty();
+      test_insert_duplicate();
+      test_insert_grow();
+
+      // Access
+      test_find_missing();
+
+      // Remove
+      test_erase_standard();
+      test_erase_missing();
+      test_clear_standard();
+
+      // Iterator
+      test_iterator_visitAll();
+
+      // Reclaim
+      test_epoch_reclaimErased();
+      test_epoch_guardDelays();
+
+      // Threads
+      test_threads_insertDisjoint();
+      test_threads_stress();
+
+      report("LockFree");
+   }
+
+   /***************************************
+    * SPLIT ORDER
+    ***************************************/
+
+   // the bits come out in the opposite order
+   void test_reverse_standard()
+   {  // setup
+      typedef custom::lock_free_unordered_set<std::size_t> Set;
+      // exercise
+      // verify
+      assertUnit(Set::reverse(0) == 0);
+      assertUnit(Set::reverse(1) == 0x8000000000000000ull);
+      assertUnit(Set::reverse(0x8000000000000000ull) == 1);
+      assertUnit(Set::reverse(0x00000000000000F0ull) == 0x0F00000000000000ull);
+      assertUnit(Set::reverse(Set::reverse(0x123456789ABCDEFull)) == 0x123456789ABCDEFull);
+   }  // teardown
+
+   // the list holds bucket 0, its elements, bucket 2, its elements, ...
+   void test_splitOrder_bucketsInOrder()
+   {  // setup
+      //   h[0] --> 0 4     h[2] --> 2 6
+      //   h[1] --> 1 5     h[3] --> 3 7
+      custom::lock_free_unordered_set<std::size_t> s;
+      s.numBuckets = 4;
+      // exercise
+      for (std::size_t i = 0; i < 8; i++)
+         s.insert(i);
+      // verify
+      //   [0] 0 4 [2] 2 6 [1] 1 5 [3] 3 7
+      std::vector<std::size_t> order;
+      std::vector<bool> isBucket;
+      for (auto p = s.slotOf(0).load(); p; p = s.ptrOf(p->next.load()))
+      {
+         isBucket.push_back(s.isBucket(p));
+         order.push_back(s.isBucket(p) ? 100 : s.valueOf(p));
+      }
+      std::size_t expected[] = { 100, 0, 4, 100, 2, 6, 100, 1, 5, 100, 3, 7 };
+      assertUnit(order.size() == 12);
+      if (order.size() == 12)
+         for (std::size_t i = 0; i < 12; i++)
+            assertUnit(order[i] == expected[i]);
+      assertUnit(s.slotOf(2).load() != nullptr);
+      assertUnit(s.slotOf(2).load()->soKey == s.soBucket(2));
+   }  // teardown
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // a new set is just the marker for bucket 0
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::lock_free_unordered_set<std::size_t> s;
+      // verify
+      assertUnit(s.size() == 0);
+      assertUnit(s.empty());
+      assertUnit(s.bucket_count() == 16);
+      assertUnit(s.slotOf(0).load() != nullptr);
+      assertUnit(s.slotOf(0).load()->next.load() == 0);
+      assertUnit(s.slotOf(1).load() == nullptr);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // insert an element into an empty set
+   void test_insert_empty()
+   {  // setup
+      custom::lock_free_unordered_set<std::size_t> s;
+      // exercise
+      custom::pair<custom::lock_free_unordered_set<std::size_t>::iterator, bool> p = s.insert(42);
+      // verify
+      assertUnit(p.second == true);
+      assertUnit(*p.first == 42);
+      assertUnit(s.size() == 1);
+      assertUnit(s.bucket(42) == 10);
+      assertUnit(s.slotOf(10).load() != nullptr);
+   }  // teardown
+
+   // the second insert of an element finds the first
+   void test_insert_duplicate()
+   {  // setup
+      custom::lock_free_unordered_set<std::size_t> s;
+      custom::lock_free_unordered_set<std::size_t>::iterator it = s.insert(42).first;
+      // exercise
+      custom::pair<custom::lock_free_unordered_set<std::size_t>::iterator, bool> p = s.insert(42);
+      // verify
+      assertUnit(p.second == false);
+      assertUnit(p.first == it);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // the buckets double as the set fills, and nothing is lost
+   void test_insert_grow()
+   {  // setup
+      custom::lock_free_unordered_set<std::size_t> s;
+      // exercise
+      for (std::size_t i = 0; i < 1000; i++)
+         s.insert(i * 7);
+      // verify
+      assertUnit(s.size() == 1000);
+      assertUnit(s.bucket_count() == 512);
+      assertUnit(s.load_factor() <= s.max_load_factor());
+      bool allFound = true;
+      for (std::size_t i = 0; i < 1000; i++)
+         if (!s.contains(i * 7))
+            allFound = false;
+      assertUnit(allFound);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // a missing element is not found
+   void test_find_missing()
+   {  // setup
+      custom::lock_free_unordered_set<std::size_t> s;
+      for (std::size_t i = 0; i < 100; i++)
+         s.insert(i * 2);
+      // exercise
+      bool noneFound = true;
+      for (std::size_t i = 0; i < 100; i++)
+         if (s.find(i * 2 + 1) != s.end())
+            noneFound = false;
+      // verify
+      assertUnit(noneFound);
+      assertUnit(s.count(4) == 1);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase marks the node and unlinks it
+   void test_erase_standard()
+   {  // setup
+      custom::lock_free_unordered_set<std::size_t> s;
+      for (std::size_t i = 0; i < 100; i++)
+         s.insert(i);
+      // exercise
+      size_t numErased = s.erase(50);
+      // verify
+      assertUnit(numErased == 1);
+      assertUnit(s.size() == 99);
+      assertUnit(!s.contains(50));
+      assertUnit(s.contains(49));
+      assertUnit(s.contains(51));
+      bool linked = false;
+      for (auto p = s.slotOf(0).load(); p; p = s.ptrOf(p->next.load()))
+         if (!s.isBucket(p) && s.valueOf(p) == 50)
+            linked = true;
+      assertUnit(!linked);
+   }  // teardown
+
+   // erasing a missing element does nothing
+   void test_erase_missing()
+   {  // setup
+      custom::lock_free_unordered_set<std::size_t> s;
+      s.insert(42);
+      // exercise
+      size_t numErased = s.erase(43);
+      // verify
+      assertUnit(numErased == 0);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // clear leaves only bucket markers
+   void test_clear_standard()
+   {  // setup
+      custom::lock_free_unordered_set<std::size_t> s;
+      for (std::size_t i = 0; i < 100; i++)
+         s.insert(i);
+      // exercise
+      s.clear();
+      // verify
+      assertUnit(s.size() == 0);
+      assertUnit(s.begin() == s.end());
+      bool onlyBuckets = true;
+      for (auto p = s.slotOf(0).load(); p; p = s.ptrOf(p->next.load()))
+         if (!s.isBucket(p))
+            onlyBuckets = false;
+      assertUnit(onlyBuckets);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // iteration visits every element exactly once
+   void test_iterator_visitAll()
+   {  // setup
+      custom::lock_free_unordered_set<std::size_t> s;
+      for (std::size_t i = 0; i < 100; i += 3)
+         s.insert(i);
+      std::size_t count = 0;
+      std::size_t sum = 0;
+      // exercise
+      for (auto it = s.begin(); it != s.end(); ++it)
+      {
+         count++;
+         sum += *it;
+      }
+      // verify
+      assertUnit(count == 34);
+      assertUnit(sum == 1683);
+   }  // teardown
+
+   /***************************************
+    * RECLAIM
+    ***************************************/
+
+   // an erased element is destroyed once the epoch moves on
+   void test_epoch_reclaimErased()
+   {  // setup
+      custom::lock_free_unordered_set<Spy, SpyValueHash> s;
+      for (int i = 0; i < 10; i++)
+         s.insert(Spy(i));
+      custom::epoch::instance().reclaim();
+      Spy::reset();
+      // exercise
+      for (int i = 0; i < 10; i++)
+         s.erase(Spy(i));
+      int numBefore = Spy::numDestructor();
+      custom::epoch::instance().reclaim();
+      // verify
+      assertUnit(numBefore == 10);                  // only the temporaries
+      assertUnit(Spy::numDestructor() == 20);       // and the erased nodes
+      assertUnit(s.size() == 0);
+   }  // teardown
+
+   // a node this thread can still see is not freed
+   void test_epoch_guardDelays()
+   {  // setup
+      custom::lock_free_unordered_set<Spy, SpyValueHash> s;
+      s.insert(Spy(7));
+      custom::epoch::instance().reclaim();
+      Spy::reset();
+      int numDestroyed = 0;
+      {
+         custom::lock_free_unordered_set<Spy, SpyValueHash>::iterator it = s.find(Spy(7));
+         // exercise
+         s.erase(Spy(7));
+         custom::epoch::instance().reclaim();
+         numDestroyed = Spy::numDestructor();
+         // verify
+         assertUnit((*it).get() == 7);
+      }
+      custom::epoch::instance().reclaim();
+      assertUnit(numDestroyed == 2);                // the two temporaries
+      assertUnit(Spy::numDestructor() == 3);        // and then the node
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // many writers, each with its own keys, lose nothing
+   void test_threads_insertDisjoint()
+   {  // setup
+      custom::lock_free_unordered_set<std::size_t> s;
+      std::vector<std::thread> threads;
+      // exercise
+      for (std::size_t t = 0; t < 8; t++)
+         threads.push_back(std::thread([&s, t]()
+         {
+            for (std::size_t i = 0; i < 1000; i++)
+               s.insert(i * 8 + t);
+         }));
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      assertUnit(s.size() == 8000);
+      std::size_t count = 0;
+      for (auto it = s.begin(); it != s.end(); ++it)
+         count++;
+      assertUnit(count == 8000);
+   }  // teardown
+
+   // Concurrent insert, erase and find. Every key has one owner, the
+   // only thread that changes it, which knows whether the key is in
+   // the set and checks each answer the set gives against that. Readers
+   // check keys that are never changed: some always there, some never
+   void test_threads_stress()
+   {  // setup
+      const std::size_t NUM_WRITERS = 4;
+      const std::size_t NUM_READERS = 2;
+      const std::size_t KEYS_PER_WRITER = 256;
+      const std::size_t NUM_OPS = 20000;
+      const std::size_t STABLE = 1000000;    // 1000000.. always present
+      const std::size_t ABSENT = 2000000;    // 2000000.. never present
+      custom::lock_free_unordered_set<std::size_t> s;
+      for (std::size_t i = 0; i < 500; i++)
+         s.insert(STABLE + i);
+      std::atomic<std::size_t> numWrong(0);
+      std::atomic<std::size_t> numPresent(500);
+      std::atomic<bool> done(false);
+      std::vector<std::thread> threads;
+      // exercise
+      for (std::size_t w = 0; w < NUM_WRITERS; w++)
+         threads.push_back(std::thread([&, w]()
+         {
+            std::vector<bool> present(KEYS_PER_WRITER, false);
+            std::mt19937 random((unsigned)w);
+            for (std::size_t op = 0; op < NUM_OPS; op++)
+            {
+               std::size_t i = random() % KEYS_PER_WRITER;
+               std::size_t key = w * KEYS_PER_WRITER + i;
+               switch (random() % 3)
+               {
+               case 0:
+                  if (s.insert(key).second == present[i])
+                     numWrong++;
+                  present[i] = true;
+                  break;
+               case 1:
+                  if ((s.erase(key) == 1) != present[i])
+                     numWrong++;
+                  present[i] = false;
+                  break;
+               default:
+                  if (s.contains(key) != present[i])
+                     numWrong++;
+               }
+            }
+            for (std::size_t i = 0; i < KEYS_PER_WRITER; i++)
+               if (present[i])
+                  numPresent++;
+         }));
+      for (std::size_t r = 0; r < NUM_READERS; r++)
+         threads.push_back(std::thread([&, r]()
+         {
+            std::mt19937 random((unsigned)(100 + r));
+            while (!done)
+            {
+               if (!s.contains(STABLE + random() % 500))
+                  numWrong++;
+               if (s.contains(ABSENT + random() % 500))
+                  numWrong++;
+            }
+         }));
+      for (size_t t = 0; t < NUM_WRITERS; t++)
+         threads[t].join();
+      done = true;
+      for (size_t t = NUM_WRITERS; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      assertUnit(numWrong == 0);
+      assertUnit(s.size() == numPresent);
+      std::size_t count = 0;
+      for (auto it = s.begin(); it != s.end(); ++it)
+         count++;
+      assertUnit(count == numPresent);
+   }  // teardown
+
+};
+
+#endif // DEBUG
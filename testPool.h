@@ -0,0 +1,263 @@
+/***********************************************************************
+ * Header:
+ *    TEST POOL
+ * Summary:
+ *    Unit tests for the node pool and the pool allocator
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "pool.h"
+#include "hash.h"
+#include "unitTest.h"
+
+#include <memory>
+#include <functional>
+
+class TestPool : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Pool
+      test_pool_carve();
+      test_pool_recycle();
+      test_pool_grow();
+      test_pool_release();
+      test_pool_smallBlock();
+
+      // Allocator
+      test_alloc_listNodes();
+      test_alloc_churn();
+      test_alloc_copyOwnPool();
+      test_alloc_moveTakesPool();
+      test_alloc_shared();
+      test_alloc_arrays();
+      test_alloc_lifetime();
+      test_alloc_hash();
+
+      report("Pool");
+   }
+
+   /***************************************
+    * POOL
+    ***************************************/
+
+   // blocks come one after the other out of the first chunk
+   void test_pool_carve()
+   {  // setup
+      custom::node_pool pool(24);
+      // exercise
+      char* p1 = (char*)pool.allocate();
+      char* p2 = (char*)pool.allocate();
+      char* p3 = (char*)pool.allocate();
+      // verify
+      assertUnit(pool.block_size() == 24);
+      assertUnit(p2 == p1 + 24);
+      assertUnit(p3 == p2 + 24);
+      assertUnit(pool.num_chunks() == 1);
+      assertUnit(pool.num_outstanding() == 3);
+      assertUnit(pool.pFree == nullptr);
+      // teardown
+      pool.deallocate(p1);
+      pool.deallocate(p2);
+      pool.deallocate(p3);
+   }
+
+   // a block given back is the next one handed out
+   void test_pool_recycle()
+   {  // setup
+      custom::node_pool pool(24);
+      void* p1 = pool.allocate();
+      void* p2 = pool.allocate();
+      // exercise
+      pool.deallocate(p1);
+      void* p3 = pool.allocate();
+      // verify
+      assertUnit(p3 == p1);
+      assertUnit(pool.num_outstanding() == 2);
+      assertUnit(pool.num_chunks() == 1);
+      // teardown
+      pool.deallocate(p2);
+      pool.deallocate(p3);
+   }
+
+   // running out of a chunk gets one twice the size
+   void test_pool_grow()
+   {  // setup
+      custom::node_pool pool(16);
+      void* blocks[33];
+      // exercise
+      for (int i = 0; i < 33; i++)
+         blocks[i] = pool.allocate();
+      // verify
+      assertUnit(pool.num_chunks() == 2);
+      assertUnit(pool.numNextChunk == 128);
+      assertUnit(pool.pCarveEnd - pool.pCarve == 63 * 16);
+      // teardown
+      for (int i = 0; i < 33; i++)
+         pool.deallocate(blocks[i]);
+   }
+
+   // release gives every chunk back at once
+   void test_pool_release()
+   {  // setup
+      custom::node_pool pool(16);
+      void* blocks[100];
+      for (int i = 0; i < 100; i++)
+         blocks[i] = pool.allocate();
+      for (int i = 0; i < 100; i++)
+         pool.deallocate(blocks[i]);
+      // exercise
+      pool.release();
+      // verify
+      assertUnit(pool.num_chunks() == 0);
+      assertUnit(pool.pFree == nullptr);
+      assertUnit(pool.pCarve == nullptr);
+      assertUnit(pool.numNextChunk == 32);
+   }  // teardown
+
+   // every block is big enough to hold the free list link
+   void test_pool_smallBlock()
+   {  // setup
+      // exercise
+      custom::node_pool pool(1);
+      // verify
+      assertUnit(pool.block_size() == sizeof(void*));
+      assertUnit(custom::node_pool::round(9) == 2 * sizeof(void*));
+   }  // teardown
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // each node of a list comes from its pool
+   void test_alloc_listNodes()
+   {  // setup
+      custom::pool_list<int> l;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         l.push_back(i);
+      // verify
+      assertUnit(l.size() == 100);
+      assertUnit(l.front() == 0);
+      assertUnit(l.back() == 99);
+      assertUnit(l.get_allocator().pool().num_outstanding() == 100);
+      assertUnit(l.get_allocator().pool().num_chunks() == 3);   // 32 + 64 + 128
+   }  // teardown
+
+   // a list that churns reuses the same few nodes
+   void test_alloc_churn()
+   {  // setup
+      custom::pool_list<int> l = { 1, 2, 3, 4, 5 };
+      // exercise
+      for (int i = 0; i < 10000; i++)
+      {
+         l.push_back(i);
+         l.pop_front();
+      }
+      // verify
+      assertUnit(l.size() == 5);
+      assertUnit(l.back() == 9999);
+      assertUnit(l.get_allocator().pool().num_outstanding() == 5);
+      assertUnit(l.get_allocator().pool().num_chunks() == 1);
+   }  // teardown
+
+   // a copy of a list has a pool of its own
+   void test_alloc_copyOwnPool()
+   {  // setup
+      custom::pool_list<int> lSrc = { 26, 49, 67 };
+      // exercise
+      custom::pool_list<int> lDes(lSrc);
+      // verify
+      assertUnit(lDes.get_allocator() != lSrc.get_allocator());
+      assertUnit(lDes.size() == 3);
+      assertUnit(lDes.get_allocator().pool().num_outstanding() == 3);
+      assertUnit(lSrc.get_allocator().pool().num_outstanding() == 3);
+   }  // teardown
+
+   // a moved list takes its pool along, and the source still works
+   void test_alloc_moveTakesPool()
+   {  // setup
+      custom::pool_list<int> lSrc = { 26, 49, 67 };
+      custom::pool_list<int> lDes = { 99 };
+      const custom::node_pool* pPool = &lSrc.get_allocator().pool();
+      // exercise
+      lDes = std::move(lSrc);
+      lSrc.push_back(11);
+      // verify
+      assertUnit(&lDes.get_allocator().pool() == pPool);
+      assertUnit(lDes.size() == 3);
+      assertUnit(lDes.back() == 67);
+      assertUnit(lSrc.size() == 1);
+      assertUnit(lSrc.front() == 11);
+   }  // teardown
+
+   // lists built with the same allocator share one pool
+   void test_alloc_shared()
+   {  // setup
+      custom::pool_allocator<int> alloc;
+      custom::list<int, custom::pool_allocator<int>> l1(alloc);
+      custom::list<int, custom::pool_allocator<int>> l2(alloc);
+      // exercise
+      l1.push_back(26);
+      l1.push_back(49);
+      l2.push_back(67);
+      // verify
+      assertUnit(l1.get_allocator() == l2.get_allocator());
+      assertUnit(alloc.pool().num_outstanding() == 3);
+      assertUnit(alloc.pool().num_chunks() == 1);
+   }  // teardown
+
+   // arrays go to the system and leave the pool alone
+   void test_alloc_arrays()
+   {  // setup
+      custom::pool_allocator<int> alloc;
+      // exercise
+      int* p = alloc.allocate(4);
+      // verify
+      assertUnit(alloc.pool().num_outstanding() == 0);
+      assertUnit(alloc.pool().block_size() == 0);
+      // teardown
+      alloc.deallocate(p, 4);
+   }
+
+   // the pool goes away with the last list using it
+   void test_alloc_lifetime()
+   {  // setup
+      std::weak_ptr<custom::node_pool> wpPool;
+      {
+         custom::pool_list<int> l = { 26, 49, 67 };
+         wpPool = l.get_allocator().pPool;
+         // exercise
+         custom::pool_list<int> lMoved(std::move(l));
+         l.clear();
+         // verify
+         assertUnit(!wpPool.expired());
+      }
+      assertUnit(wpPool.expired());
+   }  // teardown
+
+   // the nodes of an unordered_set can come from a pool too
+   void test_alloc_hash()
+   {  // setup
+      custom::unordered_set<int, std::hash<int>, std::equal_to<int>,
+                            custom::pool_allocator<int>> us;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         us.insert(i);
+      // verify
+      assertUnit(us.size() == 100);
+      assertUnit(us.contains(67));
+      assertUnit(us.get_allocator().pool().num_outstanding() == 100);
+   }  // teardown
+};
+
+#endif // DEBUG
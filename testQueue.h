@@ -0,0 +1,282 @@
+/***********************************************************************
+ * Header:
+ *    TEST QUEUE
+ * Summary:
+ *    Unit tests for the multi-producer single-consumer queue
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "queue.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+
+class TestQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_destructor_destroysLeft();
+
+      // Push and pop
+      test_pop_empty();
+      test_push_fifo();
+      test_push_moves();
+      test_emplace_inPlace();
+      test_popAll_inOrder();
+
+      // Recycle
+      test_recycle_sameThread();
+      test_recycle_handOn();
+
+      // Threads
+      test_threads_producersInOrder();
+      test_threads_popAllWhilePushing();
+
+      report("Queue");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // head and tail start on the same empty node
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::mpsc_queue<int> q;
+      // verify
+      assertUnit(q.pHead != nullptr);
+      assertUnit(q.pHead == q.pTail.load());
+      assertUnit(q.pHead->pNext.load() == nullptr);
+      assertUnit(q.empty());
+   }  // teardown
+
+   // whatever is never popped is destroyed with the queue
+   void test_destructor_destroysLeft()
+   {  // setup
+      {
+         custom::mpsc_queue<Spy> q;
+         q.emplace(11);
+         q.emplace(26);
+         q.emplace(31);
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+   }  // teardown
+
+   /***************************************
+    * PUSH AND POP
+    ***************************************/
+
+   // nothing to pop leaves the destination alone
+   void test_pop_empty()
+   {  // setup
+      custom::mpsc_queue<int> q;
+      int value = 99;
+      // exercise
+      bool popped = q.try_pop(value);
+      // verify
+      assertUnit(!popped);
+      assertUnit(value == 99);
+   }  // teardown
+
+   // first in, first out
+   void test_push_fifo()
+   {  // setup
+      custom::mpsc_queue<int> q;
+      std::vector<int> seen;
+      int value;
+      // exercise
+      assertUnit(q.try_push(11));
+      assertUnit(q.try_push(26));
+      q.try_pop(value);
+      seen.push_back(value);
+      assertUnit(q.try_push(31));
+      while (q.try_pop(value))
+         seen.push_back(value);
+      // verify
+      assertUnit(seen == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(q.empty());
+      assertUnit(q.pHead == q.pTail.load());
+   }  // teardown
+
+   // an element pushed as an rvalue is moved in and moved out
+   void test_push_moves()
+   {  // setup
+      custom::mpsc_queue<std::string> q;
+      std::string s(100, 'x');
+      const char* pData = s.data();
+      std::string out;
+      // exercise
+      q.try_push(std::move(s));
+      q.try_pop(out);
+      // verify
+      assertUnit(out.data() == pData);
+      assertUnit(out.size() == 100);
+   }  // teardown
+
+   // emplace builds the element in its node
+   void test_emplace_inPlace()
+   {  // setup
+      custom::mpsc_queue<Spy> q;
+      Spy::reset();
+      // exercise
+      q.emplace(26);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(q.pHead->pNext.load()->data()->get() == 26);
+   }  // teardown
+
+   // pop_all hands over everything, oldest first
+   void test_popAll_inOrder()
+   {  // setup
+      custom::mpsc_queue<int> q;
+      for (int i = 0; i < 100; i++)
+         q.try_push(i);
+      std::vector<int> seen;
+      // exercise
+      size_t num = q.pop_all([&seen](int value) { seen.push_back(value); });
+      // verify
+      assertUnit(num == 100);
+      assertUnit(seen.size() == 100);
+      bool inOrder = true;
+      for (size_t i = 0; i < seen.size(); i++)
+         if (seen[i] != (int)i)
+            inOrder = false;
+      assertUnit(inOrder);
+      assertUnit(q.empty());
+      assertUnit(q.pop_all([](int) {}) == 0);
+   }  // teardown
+
+   /***************************************
+    * RECYCLE
+    ***************************************/
+
+   // the node given back by a pop is the next one pushed into
+   void test_recycle_sameThread()
+   {  // setup
+      custom::mpsc_queue<int> q;
+      q.try_push(11);
+      auto pStub = q.pHead;
+      int value;
+      // exercise
+      q.try_pop(value);
+      q.try_push(26);
+      // verify
+      assertUnit(q.pTail.load() == pStub);
+      assertUnit(q.pHead->pNext.load() == pStub);
+   }  // teardown
+
+   // a consumer hands its spares on for another thread to push into
+   void test_recycle_handOn()
+   {  // setup
+      typedef custom::mpsc_queue<double> Queue;
+      typedef Queue::recycler Recycler;
+      Recycler::local().num = 0;
+      std::vector<Queue::Node*> nodes;
+      for (size_t i = 0; i < Recycler::BATCH; i++)
+         nodes.push_back(Recycler::acquire());
+      Queue::Node* pNode = nullptr;
+      // exercise
+      for (size_t i = 0; i < nodes.size(); i++)
+         Recycler::release(nodes[i]);
+      std::thread producer([&pNode]() { pNode = Recycler::acquire(); });
+      producer.join();
+      // verify
+      assertUnit(Recycler::local().pHead == nullptr);
+      assertUnit(Recycler::local().num == 0);
+      assertUnit(pNode == nodes.back());
+      // teardown
+      Recycler::release(pNode);
+   }
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // every producer's elements arrive, and in the order it pushed them
+   void test_threads_producersInOrder()
+   {  // setup
+      const size_t NUM_PRODUCERS = 4;
+      const size_t NUM_EACH = 20000;
+      custom::mpsc_queue<size_t> q;
+      std::vector<std::thread> threads;
+      // exercise
+      for (size_t t = 0; t < NUM_PRODUCERS; t++)
+         threads.push_back(std::thread([&q, t, NUM_EACH]()
+         {
+            for (size_t i = 0; i < NUM_EACH; i++)
+               q.try_push(t * NUM_EACH + i);
+         }));
+      std::vector<size_t> next(NUM_PRODUCERS, 0);
+      size_t numWrong = 0;
+      size_t numPopped = 0;
+      size_t value;
+      while (numPopped < NUM_PRODUCERS * NUM_EACH)
+         if (q.try_pop(value))
+         {
+            size_t t = value / NUM_EACH;
+            if (value % NUM_EACH != next[t]++)
+               numWrong++;
+            numPopped++;
+         }
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      // verify
+      assertUnit(numWrong == 0);
+      assertUnit(numPopped == NUM_PRODUCERS * NUM_EACH);
+      assertUnit(q.empty());
+   }  // teardown
+
+   // batches taken while producers run add up to everything pushed
+   void test_threads_popAllWhilePushing()
+   {  // setup
+      const size_t NUM_PRODUCERS = 4;
+      const size_t NUM_EACH = 20000;
+      custom::mpsc_queue<size_t> q;
+      std::atomic<size_t> numDone(0);
+      std::vector<std::thread> threads;
+      // exercise
+      for (size_t t = 0; t < NUM_PRODUCERS; t++)
+         threads.push_back(std::thread([&q, &numDone, NUM_EACH]()
+         {
+            for (size_t i = 1; i <= NUM_EACH; i++)
+               q.try_push(i);
+            numDone++;
+         }));
+      size_t numPopped = 0;
+      size_t sum = 0;
+      auto visit = [&numPopped, &sum](size_t value) { numPopped++; sum += value; };
+      while (numDone < NUM_PRODUCERS)
+         q.pop_all(visit);
+      for (size_t t = 0; t < threads.size(); t++)
+         threads[t].join();
+      q.pop_all(visit);
+      // verify
+      assertUnit(numPopped == NUM_PRODUCERS * NUM_EACH);
+      assertUnit(sum == NUM_PRODUCERS * NUM_EACH * (NUM_EACH + 1) / 2);
+      assertUnit(q.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,349 @@
+/***********************************************************************
+ * Header:
+ *    TEST SMALL
+ * Summary:
+ *    Unit tests for the small-size unordered set
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "small.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+class TestSmall : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_list();
+      test_construct_copySmall();
+      test_construct_copyHashed();
+      test_construct_moveSmall();
+      test_construct_moveHashed();
+
+      // Insert
+      test_insert_small();
+      test_insert_duplicate();
+      test_insert_noCopy();
+      test_insert_promote();
+      test_insert_promoteNoCopy();
+      test_insert_reserve();
+
+      // Erase
+      test_erase_small();
+      test_erase_missing();
+      test_erase_hashed();
+      test_clear_demote();
+
+      report("Small");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty set holds nothing and has allocated nothing
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::small_unordered_set<int> ss;
+      // verify
+      assertUnit(ss.size() == 0);
+      assertUnit(ss.empty());
+      assertUnit(ss.is_small());
+      assertUnit(ss.pHash == nullptr);
+      assertUnit(ss.numInline == 0);
+      assertUnit(ss.begin() == ss.end());
+      assertUnit(ss.find(3) == ss.end());
+   }  // teardown
+
+   // a few elements stay inline in the order given
+   void test_construct_list()
+   {  // setup
+      // exercise
+      custom::small_unordered_set<int, 4> ss = { 31, 67, 49 };
+      // verify
+      assertUnit(ss.size() == 3);
+      assertUnit(ss.is_small());
+      assertUnit(ss.elements()[0] == 31);
+      assertUnit(ss.elements()[1] == 67);
+      assertUnit(ss.elements()[2] == 49);
+      assertStandardSmall(ss);
+   }  // teardown
+
+   // a small copy is small
+   void test_construct_copySmall()
+   {  // setup
+      custom::small_unordered_set<std::string, 4> ssSrc = { "red", "green" };
+      // exercise
+      custom::small_unordered_set<std::string, 4> ssDes(ssSrc);
+      // verify
+      assertUnit(ssDes.is_small());
+      assertUnit(ssDes.size() == 2);
+      assertUnit(ssDes.contains("red"));
+      assertUnit(ssDes.contains("green"));
+      assertUnit(ssSrc.size() == 2);
+      assertUnit(ssSrc.contains("red"));
+   }  // teardown
+
+   // a hashed copy is hashed, with its own table
+   void test_construct_copyHashed()
+   {  // setup
+      custom::small_unordered_set<int, 2> ssSrc = { 31, 67, 49 };
+      // exercise
+      custom::small_unordered_set<int, 2> ssDes(ssSrc);
+      // verify
+      assertUnit(!ssDes.is_small());
+      assertUnit(ssDes.pHash != ssSrc.pHash);
+      assertUnit(ssDes.size() == 3);
+      assertUnit(ssSrc.size() == 3);
+      assertStandardSmall(ssDes);
+   }  // teardown
+
+   // moving a small set moves each element and empties the source
+   void test_construct_moveSmall()
+   {  // setup
+      custom::small_unordered_set<Spy, 4, SpyHash> ssSrc;
+      ssSrc.insert(Spy(31));
+      ssSrc.insert(Spy(67));
+      Spy::reset();
+      // exercise
+      custom::small_unordered_set<Spy, 4, SpyHash> ssDes(std::move(ssSrc));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(ssDes.size() == 2);
+      assertUnit(ssDes.contains(Spy(31)));
+      assertUnit(ssDes.contains(Spy(67)));
+      assertUnit(ssSrc.empty());
+   }  // teardown
+
+   // moving a hashed set hands over the table
+   void test_construct_moveHashed()
+   {  // setup
+      custom::small_unordered_set<int, 2> ssSrc = { 31, 67, 49 };
+      custom::unordered_set<int>* pHash = ssSrc.pHash;
+      // exercise
+      custom::small_unordered_set<int, 2> ssDes(std::move(ssSrc));
+      // verify
+      assertUnit(ssDes.pHash == pHash);
+      assertUnit(ssSrc.pHash == nullptr);
+      assertUnit(ssSrc.empty());
+      assertStandardSmall(ssDes);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // up to N elements go inline
+   void test_insert_small()
+   {  // setup
+      custom::small_unordered_set<int, 4> ss;
+      // exercise
+      auto p1 = ss.insert(31);
+      auto p2 = ss.insert(67);
+      auto p3 = ss.insert(49);
+      auto p4 = ss.insert(59);
+      // verify
+      assertUnit(p1.second && p2.second && p3.second && p4.second);
+      assertUnit(*p1.first == 31);
+      assertUnit(*p4.first == 59);
+      assertUnit(ss.size() == 4);
+      assertUnit(ss.is_small());
+      assertUnit(ss.find(59) == p4.first);
+      assertUnit(ss.find(50) == ss.end());
+   }  // teardown
+
+   // inserting an element already there finds it and adds nothing
+   void test_insert_duplicate()
+   {  // setup
+      custom::small_unordered_set<int, 4> ss = { 31, 67, 49 };
+      // exercise
+      auto p = ss.insert(67);
+      // verify
+      assertUnit(!p.second);
+      assertUnit(*p.first == 67);
+      assertUnit(p.first == ss.find(67));
+      assertUnit(ss.size() == 3);
+      assertStandardSmall(ss);
+   }  // teardown
+
+   // a small set makes no allocations of its own
+   void test_insert_noCopy()
+   {  // setup
+      custom::small_unordered_set<Spy, 4, SpyHash> ss;
+      Spy s(67);
+      Spy::reset();
+      // exercise
+      ss.insert(std::move(s));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopyMove() == 1);
+      assertUnit(ss.is_small());
+      assertUnit(ss.size() == 1);
+   }  // teardown
+
+   // element N + 1 moves the set into a hash
+   void test_insert_promote()
+   {  // setup
+      custom::small_unordered_set<int, 4> ss = { 31, 67, 49, 59 };
+      // exercise
+      auto p = ss.insert(11);
+      // verify
+      assertUnit(p.second);
+      assertUnit(*p.first == 11);
+      assertUnit(!ss.is_small());
+      assertUnit(ss.numInline == 0);
+      assertUnit(ss.size() == 5);
+      assertUnit(ss.contains(31));
+      assertUnit(ss.contains(59));
+      assertUnit(ss.contains(11));
+      assertUnit(!ss.contains(12));
+      assertUnit(ss.pHash->bucket_count() >= 5);
+   }  // teardown
+
+   // promotion moves the inline elements rather than copying them
+   void test_insert_promoteNoCopy()
+   {  // setup
+      custom::small_unordered_set<Spy, 2, SpyHash> ss;
+      ss.insert(Spy(31));
+      ss.insert(Spy(67));
+      Spy::reset();
+      // exercise
+      ss.insert(Spy(49));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 1);   // the new 49 only
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(!ss.is_small());
+      assertUnit(ss.size() == 3);
+      assertUnit(ss.contains(Spy(31)));
+      assertUnit(ss.contains(Spy(67)));
+   }  // teardown
+
+   // reserving more than fits promotes right away
+   void test_insert_reserve()
+   {  // setup
+      custom::small_unordered_set<int, 4> ss = { 31, 67 };
+      // exercise
+      ss.reserve(4);
+      bool smallAfterFour = ss.is_small();
+      ss.reserve(100);
+      // verify
+      assertUnit(smallAfterFour);
+      assertUnit(!ss.is_small());
+      assertUnit(ss.pHash->bucket_count() >= 100);
+      assertUnit(ss.size() == 2);
+      assertUnit(ss.contains(31));
+      assertUnit(ss.contains(67));
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // the last element fills the hole
+   void test_erase_small()
+   {  // setup
+      custom::small_unordered_set<int, 4> ss = { 31, 67, 49, 59 };
+      // exercise
+      size_t num = ss.erase(67);
+      // verify
+      assertUnit(num == 1);
+      assertUnit(ss.size() == 3);
+      assertUnit(ss.elements()[0] == 31);
+      assertUnit(ss.elements()[1] == 59);
+      assertUnit(ss.elements()[2] == 49);
+      assertUnit(!ss.contains(67));
+   }  // teardown
+
+   // erasing what is not there changes nothing
+   void test_erase_missing()
+   {  // setup
+      custom::small_unordered_set<int, 4> ss = { 31, 67 };
+      // exercise
+      size_t num = ss.erase(50);
+      // verify
+      assertUnit(num == 0);
+      assertUnit(ss.size() == 2);
+      assertUnit(ss.contains(31));
+      assertUnit(ss.contains(67));
+   }  // teardown
+
+   // a promoted set stays hashed as it shrinks
+   void test_erase_hashed()
+   {  // setup
+      custom::small_unordered_set<int, 2> ss = { 31, 67, 49 };
+      // exercise
+      size_t num1 = ss.erase(31);
+      size_t num2 = ss.erase(31);
+      // verify
+      assertUnit(num1 == 1);
+      assertUnit(num2 == 0);
+      assertUnit(!ss.is_small());
+      assertUnit(ss.size() == 2);
+      assertStandardSmall(ss);
+   }  // teardown
+
+   // clear frees the table and goes back to inline
+   void test_clear_demote()
+   {  // setup
+      custom::small_unordered_set<Spy, 2, SpyHash> ss;
+      ss.insert(Spy(31));
+      ss.insert(Spy(67));
+      ss.insert(Spy(49));
+      Spy::reset();
+      // exercise
+      ss.clear();
+      // verify
+      assertUnit(Spy::numDelete() == 3);
+      assertUnit(ss.is_small());
+      assertUnit(ss.empty());
+      ss.insert(Spy(11));
+      assertUnit(ss.is_small());
+      assertUnit(ss.size() == 1);
+   }  // teardown
+
+private:
+   // a hasher for Spy
+   struct SpyHash
+   {
+      std::size_t operator()(const Spy& s) const { return (std::size_t)s.get(); }
+   };
+
+   // the elements are found by iterating and by find, each once
+   template <size_t N>
+   void assertStandardSmall(const custom::small_unordered_set<int, N>& ss)
+   {
+      std::vector<int> seen;
+      for (auto it = ss.begin(); it != ss.end(); ++it)
+      {
+         assertUnit(ss.find(*it) != ss.end());
+         assertUnit(*ss.find(*it) == *it);
+         seen.push_back(*it);
+      }
+      std::sort(seen.begin(), seen.end());
+      assertUnit(seen.size() == ss.size());
+      assertUnit(std::adjacent_find(seen.begin(), seen.end()) == seen.end());
+   }
+};
+
+#endif // DEBUG
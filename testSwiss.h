@@ -0,0 +1,267 @@
+/***********************************************************************
+ * Header:
+ *    TEST SWISS
+ * Summary:
+ *    Unit tests for the swiss table hash
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "swiss.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstring>
+
+class TestSwiss : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Group
+      test_group_match();
+      test_group_matchEmpty();
+      test_group_matchEmptyOrDeleted();
+
+      // Construct
+      test_construct_default();
+
+      // Insert
+      test_insert_empty();
+      test_insert_duplicate();
+      test_insert_grow();
+
+      // Access
+      test_find_missing();
+
+      // Remove
+      test_erase_standard();
+      test_erase_reuseDeleted();
+      test_clear_standard();
+
+      // Iterator
+      test_iterator_visitAll();
+
+      report("Swiss");
+   }
+
+   /***************************************
+    * GROUP
+    ***************************************/
+
+   // find every control byte equal to an h2
+   void test_group_match()
+   {  // setup
+      int8_t ctrl[custom::swiss_group::WIDTH];
+      std::memset(ctrl, custom::swiss_group::EMPTY, sizeof(ctrl));
+      ctrl[0] = 5;
+      ctrl[3] = 5;
+      ctrl[7] = 6;
+      ctrl[15] = 5;
+      // exercise
+      uint32_t mask = custom::swiss_group(ctrl).match(5);
+      // verify
+      assertUnit(mask == ((1u << 0) | (1u << 3) | (1u << 15)));
+      assertUnit(custom::swiss_group::lowest(mask) == 0);
+   }  // teardown
+
+   // find the EMPTY control bytes
+   void test_group_matchEmpty()
+   {  // setup
+      int8_t ctrl[custom::swiss_group::WIDTH];
+      std::memset(ctrl, 0, sizeof(ctrl));
+      ctrl[2] = custom::swiss_group::EMPTY;
+      ctrl[9] = custom::swiss_group::DELETED;
+      // exercise
+      uint32_t mask = custom::swiss_group(ctrl).matchEmpty();
+      // verify
+      assertUnit(mask == (1u << 2));
+   }  // teardown
+
+   // find the EMPTY and DELETED control bytes, but not a full 127
+   void test_group_matchEmptyOrDeleted()
+   {  // setup
+      int8_t ctrl[custom::swiss_group::WIDTH];
+      std::memset(ctrl, 127, sizeof(ctrl));
+      ctrl[2] = custom::swiss_group::EMPTY;
+      ctrl[9] = custom::swiss_group::DELETED;
+      // exercise
+      uint32_t mask = custom::swiss_group(ctrl).matchEmptyOrDeleted();
+      // verify
+      assertUnit(mask == ((1u << 2) | (1u << 9)));
+      assertUnit(custom::swiss_group::lowest(mask) == 2);
+   }  // teardown
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // a new set is one group of EMPTY control bytes
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::swiss_unordered_set<std::size_t> us;
+      // verify
+      assertUnit(us.numElements == 0);
+      assertUnit(us.numDeleted == 0);
+      assertUnit(us.numSlots == custom::swiss_group::WIDTH);
+      for (size_t i = 0; i < us.numSlots; i++)
+         assertUnit(us.ctrl[i] == custom::swiss_group::EMPTY);
+      assertUnit(us.begin() == us.end());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the control byte of the new slot holds h2
+   void test_insert_empty()
+   {  // setup
+      custom::swiss_unordered_set<std::size_t> us;
+      // exercise
+      custom::pair<custom::swiss_unordered_set<std::size_t>::iterator, bool> p = us.insert(42);
+      // verify
+      assertUnit(p.second == true);
+      assertUnit(*p.first == 42);
+      assertUnit(us.numElements == 1);
+      size_t i = p.first.pSlot - us.slots;
+      assertUnit(us.ctrl[i] == us.h2(us.hashOf(42)));
+   }  // teardown
+
+   // inserting a duplicate returns the existing slot
+   void test_insert_duplicate()
+   {  // setup
+      custom::swiss_unordered_set<std::size_t> us;
+      custom::swiss_unordered_set<std::size_t>::iterator it = us.insert(42).first;
+      // exercise
+      custom::pair<custom::swiss_unordered_set<std::size_t>::iterator, bool> p = us.insert(42);
+      // verify
+      assertUnit(p.second == false);
+      assertUnit(p.first == it);
+      assertUnit(us.numElements == 1);
+   }  // teardown
+
+   // the table grows and every element can still be found
+   void test_insert_grow()
+   {  // setup
+      custom::swiss_unordered_set<std::size_t> us;
+      // exercise
+      for (std::size_t i = 0; i < 1000; i++)
+         us.insert(i * 7);
+      // verify
+      assertUnit(us.numElements == 1000);
+      assertUnit(us.load_factor() <= us.max_load_factor());
+      bool allFound = true;
+      for (std::size_t i = 0; i < 1000; i++)
+         if (us.find(i * 7) == us.end())
+            allFound = false;
+      assertUnit(allFound);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // a missing element is not found
+   void test_find_missing()
+   {  // setup
+      custom::swiss_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i * 2);
+      // exercise
+      bool noneFound = true;
+      for (std::size_t i = 0; i < 100; i++)
+         if (us.find(i * 2 + 1) != us.end())
+            noneFound = false;
+      // verify
+      assertUnit(noneFound);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase removes only the one element
+   void test_erase_standard()
+   {  // setup
+      custom::swiss_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i);
+      // exercise
+      us.erase(50);
+      // verify
+      assertUnit(us.numElements == 99);
+      assertUnit(us.find(50) == us.end());
+      assertUnit(us.find(49) != us.end());
+      assertUnit(us.find(51) != us.end());
+   }  // teardown
+
+   // churn through erase and insert without growing the table
+   void test_erase_reuseDeleted()
+   {  // setup
+      custom::swiss_unordered_set<std::size_t> us;
+      us.reserve(100);
+      size_t numSlots = us.numSlots;
+      // exercise
+      for (std::size_t i = 0; i < 10000; i++)
+      {
+         us.insert(i);
+         if (i >= 50)
+            us.erase(i - 50);
+      }
+      // verify
+      assertUnit(us.numElements == 50);
+      assertUnit(us.numSlots == numSlots);
+      assertUnit(us.find(9999) != us.end());
+      assertUnit(us.find(9949) == us.end());
+   }  // teardown
+
+   // clear leaves every control byte EMPTY
+   void test_clear_standard()
+   {  // setup
+      custom::swiss_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i);
+      // exercise
+      us.clear();
+      // verify
+      assertUnit(us.numElements == 0);
+      assertUnit(us.numDeleted == 0);
+      for (size_t i = 0; i < us.numSlots; i++)
+         assertUnit(us.ctrl[i] == custom::swiss_group::EMPTY);
+      assertUnit(us.begin() == us.end());
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // iteration visits every element exactly once
+   void test_iterator_visitAll()
+   {  // setup
+      custom::swiss_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 100; i += 3)
+         us.insert(i);
+      std::size_t count = 0;
+      std::size_t sum = 0;
+      // exercise
+      for (auto it = us.begin(); it != us.end(); ++it)
+      {
+         count++;
+         sum += *it;
+      }
+      // verify
+      assertUnit(count == 34);
+      assertUnit(sum == 1683);
+   }  // teardown
+
+};
+
+#endif // DEBUG
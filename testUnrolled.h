@@ -0,0 +1,378 @@
+/***********************************************************************
+ * Header:
+ *    TEST UNROLLED
+ * Summary:
+ *    Unit tests for the unrolled linked list
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "unrolled.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <vector>
+#include <string>
+
+class TestUnrolled : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_list();
+      test_construct_copy();
+      test_construct_move();
+
+      // Insert
+      test_pushback_fillNodes();
+      test_pushfront_shift();
+      test_insert_middle();
+      test_insert_splitLower();
+      test_insert_splitUpper();
+      test_insert_end();
+      test_emplace_noCopy();
+
+      // Remove
+      test_erase_middle();
+      test_erase_emptiesNode();
+      test_erase_mergesNodes();
+      test_erase_everyOther();
+      test_pop_bothEnds();
+      test_clear_destroys();
+
+      // Iterator
+      test_iterator_backward();
+
+      report("Unrolled");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty list has no nodes
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::unrolled_list<int, 4> l;
+      // verify
+      assertUnit(l.numElements == 0);
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.empty());
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // elements pack into as few nodes as hold them
+   void test_construct_list()
+   {  // setup
+      // exercise
+      custom::unrolled_list<int, 4> l = { 11, 26, 31, 49, 67 };
+      // verify
+      //   +----+----+----+----+     +----+----+----+----+
+      //   | 11 | 26 | 31 | 49 | --- | 67 |    |    |    |
+      //   +----+----+----+----+     +----+----+----+----+
+      assertUnit(l.size() == 5);
+      assertNodes(l, { { 11, 26, 31, 49 }, { 67 } });
+   }  // teardown
+
+   // a copy has the same elements in nodes of its own
+   void test_construct_copy()
+   {  // setup
+      custom::unrolled_list<std::string, 2> lSrc = { "red", "green", "blue" };
+      // exercise
+      custom::unrolled_list<std::string, 2> lDes(lSrc);
+      // verify
+      assertUnit(lDes.size() == 3);
+      assertUnit(lDes.pHead != lSrc.pHead);
+      assertUnit(lDes.front() == "red");
+      assertUnit(lDes.back() == "blue");
+      assertUnit(lSrc.size() == 3);
+   }  // teardown
+
+   // a move takes the nodes
+   void test_construct_move()
+   {  // setup
+      custom::unrolled_list<int, 4> lSrc = { 11, 26, 31, 49, 67 };
+      auto pHead = lSrc.pHead;
+      // exercise
+      custom::unrolled_list<int, 4> lDes(std::move(lSrc));
+      // verify
+      assertUnit(lDes.pHead == pHead);
+      assertUnit(lDes.size() == 5);
+      assertUnit(lSrc.pHead == nullptr);
+      assertUnit(lSrc.empty());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_back fills the last node before starting another
+   void test_pushback_fillNodes()
+   {  // setup
+      custom::unrolled_list<int, 4> l;
+      // exercise
+      for (int i = 0; i < 9; i++)
+         l.push_back(i);
+      // verify
+      assertUnit(l.size() == 9);
+      assertNodes(l, { { 0, 1, 2, 3 }, { 4, 5, 6, 7 }, { 8 } });
+      assertUnit(l.back() == 8);
+   }  // teardown
+
+   // push_front makes room at the start of the first node
+   void test_pushfront_shift()
+   {  // setup
+      custom::unrolled_list<int, 4> l = { 26, 31 };
+      // exercise
+      l.push_front(11);
+      // verify
+      assertUnit(l.size() == 3);
+      assertNodes(l, { { 11, 26, 31 } });
+   }  // teardown
+
+   // inserting in a node with room moves only the ones after it
+   void test_insert_middle()
+   {  // setup
+      custom::unrolled_list<int, 4> l = { 11, 31, 49 };
+      auto it = l.begin();
+      ++it;
+      // exercise
+      auto itReturn = l.insert(it, 26);
+      // verify
+      assertUnit(*itReturn == 26);
+      assertUnit(itReturn.pNode == l.pHead);
+      assertUnit(itReturn.index == 1);
+      assertNodes(l, { { 11, 26, 31, 49 } });
+   }  // teardown
+
+   // inserting in the lower half of a full node splits it
+   void test_insert_splitLower()
+   {  // setup
+      custom::unrolled_list<int, 4> l = { 11, 31, 49, 67 };
+      auto it = l.begin();
+      ++it;
+      // exercise
+      auto itReturn = l.insert(it, 26);
+      // verify
+      assertUnit(*itReturn == 26);
+      assertUnit(l.size() == 5);
+      assertNodes(l, { { 11, 26, 31 }, { 49, 67 } });
+   }  // teardown
+
+   // inserting in the upper half of a full node splits it
+   void test_insert_splitUpper()
+   {  // setup
+      custom::unrolled_list<int, 4> l = { 11, 26, 31, 67 };
+      auto it = l.begin();
+      ++it;
+      ++it;
+      ++it;
+      // exercise
+      auto itReturn = l.insert(it, 49);
+      // verify
+      assertUnit(*itReturn == 49);
+      assertUnit(itReturn.pNode == l.pTail);
+      assertNodes(l, { { 11, 26 }, { 31, 49, 67 } });
+   }  // teardown
+
+   // inserting at the end appends
+   void test_insert_end()
+   {  // setup
+      custom::unrolled_list<int, 4> l = { 11, 26 };
+      // exercise
+      auto itReturn = l.insert(l.end(), 31);
+      // verify
+      assertUnit(*itReturn == 31);
+      assertNodes(l, { { 11, 26, 31 } });
+   }  // teardown
+
+   // emplace_back builds the element in its slot
+   void test_emplace_noCopy()
+   {  // setup
+      custom::unrolled_list<Spy, 4> l;
+      l.emplace_back(11);
+      Spy::reset();
+      // exercise
+      Spy& s = l.emplace_back(26);
+      // verify
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(&s == l.pHead->data() + 1);
+      assertUnit(s.get() == 26);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase closes the gap and returns the element after
+   void test_erase_middle()
+   {  // setup
+      custom::unrolled_list<int, 4> l = { 11, 26, 31, 49, 67 };
+      auto it = l.begin();
+      ++it;
+      // exercise
+      auto itReturn = l.erase(it);
+      // verify
+      assertUnit(*itReturn == 31);
+      assertUnit(l.size() == 4);
+      assertNodes(l, { { 11, 31, 49 }, { 67 } });
+   }  // teardown
+
+   // erasing the last element of a node frees the node
+   void test_erase_emptiesNode()
+   {  // setup
+      custom::unrolled_list<int, 4> l = { 11, 26, 31, 49, 67 };
+      auto it = l.rbegin();
+      // exercise
+      auto itReturn = l.erase(it);
+      // verify
+      assertUnit(itReturn == l.end());
+      assertUnit(l.size() == 4);
+      assertUnit(l.pHead == l.pTail);
+      assertNodes(l, { { 11, 26, 31, 49 } });
+   }  // teardown
+
+   // a node under half full takes in the next if they fit
+   void test_erase_mergesNodes()
+   {  // setup
+      custom::unrolled_list<int, 4> l = { 11, 26, 31, 49, 67 };
+      l.insert(l.begin(), 5);   // { 5 11 26 } { 31 49 } { 67 }
+      // exercise
+      auto it = l.begin();
+      it = l.erase(it);
+      it = l.erase(it);
+      // verify
+      assertUnit(*it == 26);
+      assertUnit(l.size() == 4);
+      assertNodes(l, { { 26, 31, 49 }, { 67 } });
+   }  // teardown
+
+   // walking and erasing every other element keeps the rest in order
+   void test_erase_everyOther()
+   {  // setup
+      custom::unrolled_list<int, 4> l;
+      for (int i = 0; i < 100; i++)
+         l.push_back(i);
+      // exercise
+      auto it = l.begin();
+      while (it != l.end())
+      {
+         it = l.erase(it);
+         if (it != l.end())
+            ++it;
+      }
+      // verify
+      assertUnit(l.size() == 50);
+      std::vector<int> seen;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         seen.push_back(*it);
+      bool allOdd = seen.size() == 50;
+      for (size_t i = 0; i < seen.size(); i++)
+         if (seen[i] != (int)(i * 2 + 1))
+            allOdd = false;
+      assertUnit(allOdd);
+      size_t count = 0;
+      for (auto p = l.pHead; p; p = p->pNext)
+      {
+         assertUnit(p->num > 0 && p->num <= 4);
+         count += p->num;
+      }
+      assertUnit(count == 50);
+   }  // teardown
+
+   // pop from either end until the list is empty
+   void test_pop_bothEnds()
+   {  // setup
+      custom::unrolled_list<int, 2> l = { 11, 26, 31, 49, 67 };
+      // exercise
+      l.pop_front();
+      l.pop_back();
+      int front = l.front();
+      int back = l.back();
+      l.pop_back();
+      l.pop_front();
+      l.pop_front();
+      l.pop_front();
+      // verify
+      assertUnit(front == 26);
+      assertUnit(back == 49);
+      assertUnit(l.empty());
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+   }  // teardown
+
+   // clear destroys every element and frees every node
+   void test_clear_destroys()
+   {  // setup
+      custom::unrolled_list<Spy, 2> l;
+      for (int i = 0; i < 5; i++)
+         l.emplace_back(i);
+      Spy::reset();
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 5);
+      assertUnit(Spy::numDelete() == 5);
+      assertUnit(l.empty());
+      assertUnit(l.pHead == nullptr);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walking back from the last element crosses nodes
+   void test_iterator_backward()
+   {  // setup
+      custom::unrolled_list<int, 2> l = { 11, 26, 31, 49, 67 };
+      std::vector<int> seen;
+      // exercise
+      for (auto it = l.rbegin(); it != l.end(); --it)
+         seen.push_back(*it);
+      // verify
+      assertUnit(seen == std::vector<int>({ 67, 49, 31, 26, 11 }));
+   }  // teardown
+
+private:
+   // the nodes hold exactly these elements, and link up both ways
+   template <size_t N>
+   void assertNodes(const custom::unrolled_list<int, N>& l,
+                    const std::vector<std::vector<int>>& nodes)
+   {
+      auto p = l.pHead;
+      decltype(p) pPrev = nullptr;
+      size_t count = 0;
+      for (size_t i = 0; i < nodes.size(); i++)
+      {
+         assertUnit(p != nullptr);
+         if (!p)
+            return;
+         assertUnit(p->pPrev == pPrev);
+         assertUnit(p->num == nodes[i].size());
+         for (size_t j = 0; j < nodes[i].size() && j < p->num; j++)
+            assertUnit(p->data()[j] == nodes[i][j]);
+         count += p->num;
+         pPrev = p;
+         p = p->pNext;
+      }
+      assertUnit(p == nullptr);
+      assertUnit(l.pTail == pPrev);
+      assertUnit(l.numElements == count);
+   }
+};
+
+#endif // DEBUG
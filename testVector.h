@@ -13,6 +13,7 @@
 
 #include <vector>
 #include "vector.h"
+#include "spy.h"
 #include "unitTest.h"
 
 
@@ -120,6 +121,11 @@ public:
       test_capacity_empty();
       test_capacity_full();
 
+      // Allocator
+      test_alloc_everything();
+      test_alloc_copy();
+      test_alloc_moveAcross();
+
       report("Vector");
    }
    
@@ -260,7 +266,7 @@ public:
          //    | 26 | 49 |    |    |
          //    +----+----+----+----+
          custom::vector<int> v;
-         v.data = new int[4];
+         v.data = allocate(4);
          v.data[0] = 99;
          v.data[1] = 99;
          v.numElements = 2;
@@ -319,7 +325,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];
+      vSrc.data = allocate(4);
       vSrc.data[0] = 26;
       vSrc.data[1] = 49;
       vSrc.numElements = 2;
@@ -403,7 +409,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];\
+      vSrc.data = allocate(4);\
       vSrc.data[0] = 26;
       vSrc.data[1] = 49;
       vSrc.numElements = 2;
@@ -626,7 +632,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -650,7 +656,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -674,7 +680,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -753,7 +759,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -787,7 +793,7 @@ public:
       //    | 26 | 49 | 67 | 89 |    |    |
       //    +----+----+----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[6];
+      v.data = allocate(6);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -966,7 +972,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -998,7 +1004,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1105,7 +1111,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -1134,7 +1140,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1245,7 +1251,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
+      vDest.data = allocate(2);
       vDest.data[0] = 99;
       vDest.data[1] = 99;
       vDest.numElements = 2;
@@ -1284,7 +1290,7 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
+      vSrc.data = allocate(2);
       vSrc.data[0] = 99;
       vSrc.data[1] = 99;
       vSrc.numElements = 2;
@@ -1525,7 +1531,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.numElements = 2;
@@ -1592,7 +1598,7 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.numElements = 2;
@@ -1650,7 +1656,7 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = allocate(4);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -1680,7 +1686,7 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.data = allocate(3);
       v.data[0] = 26;
       v.data[1] = 49;
       v.data[2] = 67;
@@ -1749,7 +1755,7 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.data = allocate(4);
       
       v.data[0] = 26;
       v.data[1] = 49;
@@ -1782,7 +1788,7 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.data = allocate(3);
       
       v.data[0] = 26;
       v.data[1] = 49;
@@ -2009,7 +2015,82 @@ public:
       teardownStandardFixture(v);
    }
 
-   
+
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+
+   // every buffer comes from the allocator and goes back to it
+   void test_alloc_everything()
+   {  // setup
+      SpyArena arena;
+      {
+         custom::vector<int, SpyAlloc<int>> v(&arena);
+         // exercise
+         for (int i = 0; i < 5; i++)
+            v.push_back(i);
+         // verify
+         assertUnit(v.size() == 5);
+         assertUnit(v.capacity() == 8);
+         assertUnit(v.get_allocator().pArena == &arena);
+         assertUnit(arena.numAllocate == 4);   // capacity 1, 2, 4, 8
+         assertUnit(arena.numDeallocate == 3);
+         assertUnit(arena.numBytes == 8 * sizeof(int));
+      }  // teardown
+      assertUnit(arena.numBytes == 0);
+   }
+
+   // a copy keeps the source allocator unless told otherwise
+   void test_alloc_copy()
+   {  // setup
+      SpyArena arena;
+      {
+         custom::vector<int, SpyAlloc<int>> vSrc({ 26, 49, 67 }, &arena);
+         // exercise
+         custom::vector<int, SpyAlloc<int>> vDes(vSrc);
+         // verify
+         assertUnit(vDes.get_allocator().pArena == &arena);
+         assertUnit(vDes.size() == 3);
+         assertUnit(vDes[2] == 67);
+         assertUnit(vDes.data != vSrc.data);
+         assertUnit(arena.numAllocate == 2);
+      }  // teardown
+      assertUnit(arena.numBytes == 0);
+   }
+
+   // moving between arenas without propagation moves each element
+   void test_alloc_moveAcross()
+   {  // setup
+      SpyArena arenaSrc;
+      SpyArena arenaDes;
+      {
+         custom::vector<int, SpyAlloc<int>> vSrc({ 26, 49, 67, 89 }, &arenaSrc);
+         custom::vector<int, SpyAlloc<int>> vDes(&arenaDes);
+         // exercise
+         vDes = std::move(vSrc);
+         // verify
+         assertUnit(vDes.get_allocator().pArena == &arenaDes);
+         assertUnit(vDes.size() == 4);
+         assertUnit(vDes[0] == 26);
+         assertUnit(vDes[3] == 89);
+         assertUnit(vSrc.empty());
+         assertUnit(arenaDes.numAllocate == 1);
+         assertUnit(arenaDes.numBytes == 4 * sizeof(int));
+      }  // teardown
+      assertUnit(arenaSrc.numBytes == 0);
+      assertUnit(arenaDes.numBytes == 0);
+   }
+
+   /*************************************************************
+    * ALLOCATE
+    * A buffer for a fixture to fill by hand, from the same
+    * allocator the vector will give it back to
+    *************************************************************/
+   int* allocate(size_t num)
+   {
+      return std::allocator<int>().allocate(num);
+   }
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *      0    1    2    3
@@ -2022,7 +2103,7 @@ public:
       
       try
       {
-         v.data = new int[4];
+         v.data = allocate(4);
          v.data[0] = 26;
          v.data[1] = 49;
          v.data[2] = 67;
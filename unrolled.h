@@ -0,0 +1,511 @@
+/***********************************************************************
+ * Header:
+ *    UNROLLED
+ * Summary:
+ *    An unrolled linked list: a list whose nodes each hold up to N
+ *    elements side by side rather than one. A walk through a list
+ *    reads one cache line per element and spends two pointers on
+ *    each; here a walk reads the elements of a node one after the
+ *    other, as it would a vector, and the pointers are shared by N
+ *    of them. Inserting and erasing still only moves the elements
+ *    of one node, never the whole container:
+ *        custom::unrolled_list<int> l;        // 64 ints per node
+ *        custom::unrolled_list<Big, 4> bigs;  // 4 per node
+ *
+ *    Unlike list, an insert or erase moves the other elements of its
+ *    node, so it invalidates iterators into that node and the next.
+ *
+ *    This will contain the class definition of:
+ *        unrolled_list           : A list of small arrays
+ *        unrolled_list::iterator : An iterator through the list
+ * Author
+ *    <your names here>
+ ************************************************************************/
+
+#pragma once
+
+#include <new>       // for placement new
+#include <utility>   // for std::move and std::forward
+#include <cstddef>   // for size_t
+#include <cassert>
+#include <initializer_list>
+
+class TestUnrolled;  // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * UNROLLED LIST
+ * A list of nodes, each with room for N elements. The
+ * default N fills about 256 bytes of elements a node
+ ************************************************/
+template <typename T, size_t N = (sizeof(T) < 256 ? 256 / sizeof(T) : 1)>
+class unrolled_list
+{
+   friend class ::TestUnrolled;   // give unit tests access to the privates
+   static_assert(N > 0, "a node must hold at least one element");
+
+public:
+   //
+   // Construct
+   //
+   unrolled_list() : numElements(0), pHead(nullptr), pTail(nullptr) {}
+   unrolled_list(const unrolled_list& rhs) : unrolled_list()
+   {
+      for (Node* p = rhs.pHead; p; p = p->pNext)
+         for (size_t i = 0; i < p->num; i++)
+            push_back(p->data()[i]);
+   }
+   unrolled_list(unrolled_list&& rhs) : unrolled_list()
+   {
+      swap(rhs);
+   }
+   unrolled_list(const std::initializer_list<T>& il) : unrolled_list()
+   {
+      for (const T& t : il)
+         push_back(t);
+   }
+   template <class Iterator>
+   unrolled_list(Iterator first, Iterator last) : unrolled_list()
+   {
+      for (; first != last; ++first)
+         push_back(*first);
+   }
+   ~unrolled_list()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+   unrolled_list& operator=(const unrolled_list& rhs)
+   {
+      if (this != &rhs)
+      {
+         unrolled_list copy(rhs);
+         swap(copy);
+      }
+      return *this;
+   }
+   unrolled_list& operator=(unrolled_list&& rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         swap(rhs);
+      }
+      return *this;
+   }
+   unrolled_list& operator=(const std::initializer_list<T>& il)
+   {
+      unrolled_list copy(il);
+      swap(copy);
+      return *this;
+   }
+   void swap(unrolled_list& rhs)
+   {
+      std::swap(numElements, rhs.numElements);
+      std::swap(pHead, rhs.pHead);
+      std::swap(pTail, rhs.pTail);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin()  { return iterator(pHead, 0); }
+   iterator rbegin() { return pTail ? iterator(pTail, pTail->num - 1) : end(); }
+   iterator end()    { return iterator(); }
+
+   //
+   // Access
+   //
+   T& front();
+   T& back();
+
+   //
+   // Insert
+   //
+   void push_back(const T& t)  { emplace_back(t); }
+   void push_back(T&& t)       { emplace_back(std::move(t)); }
+   void push_front(const T& t) { emplace(begin(), t); }
+   void push_front(T&& t)      { emplace(begin(), std::move(t)); }
+   iterator insert(iterator it, const T& t) { return emplace(it, t); }
+   iterator insert(iterator it, T&& t)      { return emplace(it, std::move(t)); }
+   template <class... Args>
+   T& emplace_back(Args&&... args);
+   template <class... Args>
+   iterator emplace(iterator it, Args&&... args);
+
+   //
+   // Remove
+   //
+   void pop_back();
+   void pop_front();
+   iterator erase(const iterator& it);
+   void clear();
+
+   //
+   // Status
+   //
+   size_t size() const { return numElements; }
+   bool empty() const  { return numElements == 0; }
+   size_t node_capacity() const { return N; }
+
+private:
+   class Node;
+
+   Node* newNode(Node* pPrev, Node* pNext);
+   void deleteNode(Node* p);
+   Node* split(Node* p);
+
+   size_t numElements; // elements in every node together
+   Node* pHead;        // the first node, or nullptr when empty
+   Node* pTail;        // the last node, or nullptr when empty
+};
+
+/*************************************************
+ * UNROLLED LIST :: NODE
+ * Room for N elements; the first num are built. The
+ * elements are never left with a gap between them
+ *************************************************/
+template <typename T, size_t N>
+class unrolled_list <T, N> :: Node
+{
+public:
+   Node(Node* pPrev, Node* pNext) : pNext(pNext), pPrev(pPrev), num(0) {}
+
+   T* data()
+   {
+      return reinterpret_cast<T*>(storage);
+   }
+
+   Node* pNext;
+   Node* pPrev;
+   size_t num;
+   alignas(T) unsigned char storage[N * sizeof(T)];
+};
+
+/*************************************************
+ * UNROLLED LIST :: ITERATOR
+ * A node and an index into it. The end is no node
+ *************************************************/
+template <typename T, size_t N>
+class unrolled_list <T, N> :: iterator
+{
+   friend class ::TestUnrolled;   // give unit tests access to the privates
+   friend class custom::unrolled_list<T, N>;
+public:
+   iterator() : pNode(nullptr), index(0) {}
+   iterator(Node* pNode, size_t index) : pNode(pNode), index(index) {}
+
+   bool operator==(const iterator& rhs) const
+   {
+      return pNode == rhs.pNode && index == rhs.index;
+   }
+   bool operator!=(const iterator& rhs) const
+   {
+      return !(*this == rhs);
+   }
+
+   T& operator*()  { return pNode->data()[index]; }
+   T* operator->() { return pNode->data() + index; }
+
+   // Prefix increment
+   iterator& operator++()
+   {
+      if (++index == pNode->num)
+      {
+         pNode = pNode->pNext;
+         index = 0;
+      }
+      return *this;
+   }
+
+   // Postfix increment
+   iterator operator++(int)
+   {
+      iterator tmp(*this);
+      ++(*this);
+      return tmp;
+   }
+
+   // Prefix decrement
+   iterator& operator--()
+   {
+      if (index == 0)
+      {
+         pNode = pNode->pPrev;
+         index = pNode ? pNode->num - 1 : 0;
+      }
+      else
+         index--;
+      return *this;
+   }
+
+   // Postfix decrement
+   iterator operator--(int)
+   {
+      iterator tmp(*this);
+      --(*this);
+      return tmp;
+   }
+
+private:
+   Node* pNode;
+   size_t index;
+};
+
+/*****************************************
+ * UNROLLED LIST :: FRONT / BACK
+ ****************************************/
+template <typename T, size_t N>
+T& unrolled_list<T, N>::front()
+{
+   if (!pHead)
+      throw "ERROR: unable to access data from an empty list";
+   return pHead->data()[0];
+}
+
+template <typename T, size_t N>
+T& unrolled_list<T, N>::back()
+{
+   if (!pTail)
+      throw "ERROR: unable to access data from an empty list";
+   return pTail->data()[pTail->num - 1];
+}
+
+/*****************************************
+ * UNROLLED LIST :: EMPLACE BACK
+ * Build the new element in the room left in the last
+ * node, or in a new node if there is none
+ ****************************************/
+template <typename T, size_t N>
+template <class... Args>
+T& unrolled_list<T, N>::emplace_back(Args&&... args)
+{
+   if (!pTail || pTail->num == N)
+   {
+      Node* pNew = newNode(pTail, nullptr);
+      try
+      {
+         new (pNew->data()) T(std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+         deleteNode(pNew);
+         throw;
+      }
+      pNew->num = 1;
+   }
+   else
+   {
+      new (pTail->data() + pTail->num) T(std::forward<Args>(args)...);
+      pTail->num++;
+   }
+   numElements++;
+   return pTail->data()[pTail->num - 1];
+}
+
+/*****************************************
+ * UNROLLED LIST :: EMPLACE
+ * Build a new element just before it. A full node is
+ * split in two first, so only the elements of half a
+ * node ever move
+ ****************************************/
+template <typename T, size_t N>
+template <class... Args>
+typename unrolled_list<T, N>::iterator unrolled_list<T, N>::emplace(iterator it, Args&&... args)
+{
+   if (it.pNode == nullptr)
+   {
+      emplace_back(std::forward<Args>(args)...);
+      return rbegin();
+   }
+
+   // built first, as args may refer to an element about to move
+   T t(std::forward<Args>(args)...);
+
+   Node* p = it.pNode;
+   size_t index = it.index;
+   if (p->num == N)
+   {
+      Node* pUpper = split(p);
+      if (index > p->num)
+      {
+         index -= p->num;
+         p = pUpper;
+      }
+   }
+
+   // open a hole at index and move the new element into it
+   T* data = p->data();
+   if (index == p->num)
+      new (data + index) T(std::move(t));
+   else
+   {
+      new (data + p->num) T(std::move(data[p->num - 1]));
+      for (size_t i = p->num - 1; i > index; i--)
+         data[i] = std::move(data[i - 1]);
+      data[index] = std::move(t);
+   }
+   p->num++;
+   numElements++;
+   return iterator(p, index);
+}
+
+/*****************************************
+ * UNROLLED LIST :: POP BACK / POP FRONT
+ ****************************************/
+template <typename T, size_t N>
+void unrolled_list<T, N>::pop_back()
+{
+   if (pTail)
+      erase(rbegin());
+}
+
+template <typename T, size_t N>
+void unrolled_list<T, N>::pop_front()
+{
+   if (pHead)
+      erase(begin());
+}
+
+/*****************************************
+ * UNROLLED LIST :: ERASE
+ * Remove the element at it and close the gap. A node
+ * left less than half full takes in the next one if
+ * they fit together, so nodes stay mostly full
+ ****************************************/
+template <typename T, size_t N>
+typename unrolled_list<T, N>::iterator unrolled_list<T, N>::erase(const iterator& it)
+{
+   if (it.pNode == nullptr)
+      return end();
+
+   Node* p = it.pNode;
+   size_t index = it.index;
+   T* data = p->data();
+   for (size_t i = index; i + 1 < p->num; i++)
+      data[i] = std::move(data[i + 1]);
+   data[p->num - 1].~T();
+   p->num--;
+   numElements--;
+
+   // an empty node goes away
+   if (p->num == 0)
+   {
+      Node* pNext = p->pNext;
+      deleteNode(p);
+      return iterator(pNext, 0);
+   }
+
+   // a thin node takes in its neighbor
+   Node* pNext = p->pNext;
+   if (p->num < N / 2 && pNext && p->num + pNext->num <= N)
+   {
+      T* dataNext = pNext->data();
+      for (size_t i = 0; i < pNext->num; i++)
+      {
+         new (data + p->num) T(std::move(dataNext[i]));
+         dataNext[i].~T();
+         p->num++;
+      }
+      pNext->num = 0;
+      deleteNode(pNext);
+   }
+
+   if (index < p->num)
+      return iterator(p, index);
+   return iterator(p->pNext, 0);
+}
+
+/*****************************************
+ * UNROLLED LIST :: CLEAR
+ ****************************************/
+template <typename T, size_t N>
+void unrolled_list<T, N>::clear()
+{
+   while (pHead)
+   {
+      T* data = pHead->data();
+      for (size_t i = 0; i < pHead->num; i++)
+         data[i].~T();
+      pHead->num = 0;
+      deleteNode(pHead);
+   }
+   numElements = 0;
+}
+
+/*****************************************
+ * UNROLLED LIST :: NEW NODE
+ * An empty node hooked in between pPrev and pNext
+ ****************************************/
+template <typename T, size_t N>
+typename unrolled_list<T, N>::Node* unrolled_list<T, N>::newNode(Node* pPrev, Node* pNext)
+{
+   Node* pNew = new Node(pPrev, pNext);
+   if (pPrev)
+      pPrev->pNext = pNew;
+   else
+      pHead = pNew;
+   if (pNext)
+      pNext->pPrev = pNew;
+   else
+      pTail = pNew;
+   return pNew;
+}
+
+/*****************************************
+ * UNROLLED LIST :: DELETE NODE
+ * Unhook an empty node and free it
+ ****************************************/
+template <typename T, size_t N>
+void unrolled_list<T, N>::deleteNode(Node* p)
+{
+   assert(p->num == 0);
+   if (p->pPrev)
+      p->pPrev->pNext = p->pNext;
+   else
+      pHead = p->pNext;
+   if (p->pNext)
+      p->pNext->pPrev = p->pPrev;
+   else
+      pTail = p->pPrev;
+   delete p;
+}
+
+/*****************************************
+ * UNROLLED LIST :: SPLIT
+ * Move the upper half of a full node into a new node
+ * right after it. Return the new node
+ ****************************************/
+template <typename T, size_t N>
+typename unrolled_list<T, N>::Node* unrolled_list<T, N>::split(Node* p)
+{
+   Node* pUpper = newNode(p, p->pNext);
+   size_t numKeep = p->num / 2;
+   T* data = p->data();
+   T* dataUpper = pUpper->data();
+   for (size_t i = numKeep; i < p->num; i++)
+   {
+      new (dataUpper + pUpper->num) T(std::move(data[i]));
+      data[i].~T();
+      pUpper->num++;
+   }
+   p->num = numKeep;
+   return pUpper;
+}
+
+/*****************************************
+ * SWAP
+ ****************************************/
+template <typename T, size_t N>
+void swap(unrolled_list<T, N>& lhs, unrolled_list<T, N>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // namespace custom
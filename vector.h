@@ -21,7 +21,14 @@
 
 #include <cassert>  // because I am paranoid
 #include <new>      // std::bad_alloc
-#include <memory>   // for std::allocator
+#include <memory>   // for std::allocator and std::allocator_traits
+#include <utility>  // for std::move
+#include <type_traits> // for std::integral_constant
+#include <iterator> // for std::random_access_iterator_tag
+#include <cstddef>  // for std::ptrdiff_t
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <memory_resource> // for std::pmr::polymorphic_allocator
+#endif
 
 class TestVector; // forward declaration for unit tests
 class TestStack;
@@ -33,9 +40,11 @@ namespace custom
 
 /*****************************************
  * VECTOR
- * Just like the std :: vector <T> class
+ * Just like the std :: vector <T> class. The
+ * buffer comes from the allocator A, and only the
+ * first numElements slots hold a constructed T
  ****************************************/
-template <typename T>
+template <typename T, typename A = std::allocator<T> >
 class vector
 {
    friend class ::TestVector; // give unit tests access to the privates
@@ -43,16 +52,21 @@ class vector
    friend class ::TestPQueue;
    friend class ::TestHash; 
 public:
+   typedef T value_type;
+   typedef A allocator_type;
 
    //
    // Construct
    //
 
    vector() : data(nullptr), numElements(0), numCapacity(0) {}
-   vector(size_t numElements                );
-   vector(size_t numElements, const T & t   );
-   vector(const std::initializer_list<T>& l );
+   explicit vector(const A & alloc) :
+      data(nullptr), numElements(0), numCapacity(0), alloc(alloc) {}
+   vector(size_t numElements,                const A & alloc = A());
+   vector(size_t numElements, const T & t,   const A & alloc = A());
+   vector(const std::initializer_list<T>& l, const A & alloc = A());
    vector(const vector &  rhs);
+   vector(const vector &  rhs, const A & alloc);
    vector(      vector && rhs);
   ~vector();
 
@@ -62,6 +76,7 @@ public:
 
    void swap(vector& rhs)
    {
+      swapAllocator(rhs, typename Traits::propagate_on_container_swap());
       std::swap(data, rhs.data);
       std::swap(numElements, rhs.numElements);
       std::swap(numCapacity, rhs.numCapacity);
@@ -104,12 +119,16 @@ public:
 
    void clear()
    {
+      destroy(0, numElements);
       numElements = 0;
    }
    void pop_back()
    {
       if (numElements)
+      {
          --numElements;
+         destroy(numElements, numElements + 1);
+      }
    }
    void shrink_to_fit();
 
@@ -120,12 +139,38 @@ public:
    size_t  size()          const { return numElements;}
    size_t  capacity()      const { return numCapacity;}
    bool empty()            const { return numElements == 0;}
+   A get_allocator()       const { return alloc;}
 
 private:
+   typedef std::allocator_traits<A> Traits;
+
+   void destroy(size_t iBegin, size_t iEnd)
+   {
+      for (size_t i = iBegin; i < iEnd; i++)
+         Traits::destroy(alloc, data + i);
+   }
+   void release();
+
+   // what the propagate_on_container_* traits of A tell us to do
+   void copyAllocator(const vector& rhs, std::true_type)  { alloc = rhs.alloc; }
+   void copyAllocator(const vector&, std::false_type) {}
+   void moveAllocator(vector& rhs, std::true_type)  { alloc = std::move(rhs.alloc); }
+   void moveAllocator(vector&, std::false_type) {}
+   void swapAllocator(vector& rhs, std::true_type)
+   {
+      using std::swap;
+      swap(alloc, rhs.alloc);
+   }
+   void swapAllocator(vector& rhs, std::false_type)
+   {
+      // without propagation only equal allocators may trade buffers
+      assert(alloc == rhs.alloc);
+   }
 
    T *  data;             // user data, a dynamically-allocated array
-   size_t  numCapacity;   // the capacity of the array
    size_t  numElements;   // the number of items currently used
+   size_t  numCapacity;   // the capacity of the array
+   A alloc;               // where data came from
 };
 
 /**************************************************
@@ -138,20 +183,28 @@ private:
  *   4. Dereference
  * This particular iterator is a bi-directional meaning
  * that ++ and -- both work.  Not all iterators are that way.
+ * It is also random access, so std::distance is one subtraction
  *************************************************/
-template <typename T>
-class vector <T> ::iterator
+template <typename T, typename A>
+class vector <T, A> ::iterator
 {
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
    friend class ::TestPQueue;
    friend class ::TestHash;
 public:
+   // so std::iterator_traits and std::distance know what we are
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T*                              pointer;
+   typedef T&                              reference;
+
    // constructors, destructors, and assignment operator
    iterator() : p(nullptr)              {                     }
    iterator(T* p) : p(p)                {                     }
    iterator(const iterator& rhs)        { *this = rhs;        }
-   iterator(size_t index, vector<T>& v) { p = v.data + index; }
+   iterator(size_t index, vector& v)    { p = v.data + index; }
    iterator& operator = (const iterator& rhs)
    {
       this->p = rhs.p;
@@ -201,6 +254,18 @@ public:
       return *this;
    }
 
+   // random access
+   iterator& operator += (difference_type n)        { p += n; return *this;  }
+   iterator& operator -= (difference_type n)        { p -= n; return *this;  }
+   iterator  operator +  (difference_type n) const  { return iterator(p + n); }
+   iterator  operator -  (difference_type n) const  { return iterator(p - n); }
+   difference_type operator - (const iterator& rhs) const { return p - rhs.p; }
+   T& operator [] (difference_type n) const         { return p[n];           }
+   bool operator <  (const iterator& rhs) const     { return p <  rhs.p;     }
+   bool operator >  (const iterator& rhs) const     { return p >  rhs.p;     }
+   bool operator <= (const iterator& rhs) const     { return p <= rhs.p;     }
+   bool operator >= (const iterator& rhs) const     { return p >= rhs.p;     }
+
 private:
    T* p;
 };
@@ -210,21 +275,20 @@ private:
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num, const T & t) :
-data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector(size_t num, const T & t, const A & alloc) :
+data(nullptr), numElements(0), numCapacity(0), alloc(alloc)
 {
    // do nothing if there is nothing to do
    if (num > 0)
    {
       // allocate memory
-      data = new T[num];
+      data = Traits::allocate(this->alloc, num);
       numCapacity = num;
-      numElements = num;
 
       // copy the value
-      for (size_t i = size_t(0); i < num; i++)
-         data[i] = t;
+      for (; numElements < num; numElements++)
+         Traits::construct(this->alloc, data + numElements, t);
    }
 
 }
@@ -233,21 +297,19 @@ data(nullptr), numElements(0), numCapacity(0)
  * VECTOR :: INITIALIZATION LIST constructors
  * Create a vector with an initialization list.
  ****************************************/
-template <typename T>
-vector <T> :: vector(const std::initializer_list<T> & l) :
-      data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector(const std::initializer_list<T> & l, const A & alloc) :
+      data(nullptr), numElements(0), numCapacity(0), alloc(alloc)
 {
    if (l.size())
    {
       // allocate memory
-      data = new T[l.size()];
+      data = Traits::allocate(this->alloc, l.size());
+      numCapacity = l.size();
 
       // copy the value
-      size_t i = size_t(0);
       for (auto &item : l)
-         data[i++] = item;
-      numElements = l.size();
-      numCapacity = l.size();
+         Traits::construct(this->alloc, data + numElements++, item);
    }
 }
 
@@ -256,28 +318,36 @@ vector <T> :: vector(const std::initializer_list<T> & l) :
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num):
-      data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector(size_t num, const A & alloc):
+      data(nullptr), numElements(0), numCapacity(0), alloc(alloc)
 {
    // do nothing if there is nothing to do
    if (num > size_t(0))
    {
-      numElements = num;
       numCapacity = num;
-      data = new T[num];
-      for (size_t i = size_t(0); i < num; i++)
-         data[i] = T();
+      data = Traits::allocate(this->alloc, num);
+      for (; numElements < num; numElements++)
+         Traits::construct(this->alloc, data + numElements);
    }
 }
 
 /*****************************************
  * VECTOR :: COPY CONSTRUCTOR
  * Allocate the space for numElements and
- * call the copy constructor on each element
+ * call the copy constructor on each element.
+ * The copy gets whatever allocator A says a copy
+ * should get, unless one is given
  ****************************************/
-template <typename T>
-vector <T> :: vector (const vector & rhs) : data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector (const vector & rhs) :
+   vector(rhs, Traits::select_on_container_copy_construction(rhs.alloc))
+{
+}
+
+template <typename T, typename A>
+vector <T, A> :: vector (const vector & rhs, const A & alloc) :
+   data(nullptr), numElements(0), numCapacity(0), alloc(alloc)
 {
    *this = rhs;
 }
@@ -285,11 +355,15 @@ vector <T> :: vector (const vector & rhs) : data(nullptr), numElements(0), numCa
 /*****************************************
  * VECTOR :: MOVE CONSTRUCTOR
  * Steal the values from the RHS and set it to zero.
+ * The allocator comes along with the buffer
  ****************************************/
-template <typename T>
-vector <T> :: vector (vector && rhs) : data(nullptr), numElements(0), numCapacity(0)
+template <typename T, typename A>
+vector <T, A> :: vector (vector && rhs) :
+   data(rhs.data), numElements(rhs.numElements), numCapacity(rhs.numCapacity),
+   alloc(std::move(rhs.alloc))
 {
-   *this = std::move(rhs);
+   rhs.data = nullptr;
+   rhs.numElements = rhs.numCapacity = 0;
 }
 
 /*****************************************
@@ -297,14 +371,27 @@ vector <T> :: vector (vector && rhs) : data(nullptr), numElements(0), numCapacit
  * Call the destructor for each element from 0..numElements
  * and then free the memory
  ****************************************/
-template <typename T>
-vector <T> :: ~vector()
+template <typename T, typename A>
+vector <T, A> :: ~vector()
 {
+   release();
+}
+
+/*****************************************
+ * VECTOR :: RELEASE
+ * Destroy every element and give the buffer back
+ ****************************************/
+template <typename T, typename A>
+void vector <T, A> :: release()
+{
+   clear();
    if (numCapacity > 0)
    {
       assert(nullptr != data);
-      delete [] data;
+      Traits::deallocate(alloc, data, numCapacity);
    }
+   data = nullptr;
+   numCapacity = 0;
 }
 
 /***************************************
@@ -314,8 +401,8 @@ vector <T> :: ~vector()
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: resize(size_t newElements)
+template <typename T, typename A>
+void vector <T, A> :: resize(size_t newElements)
 {
    assert(newElements >= 0);
 
@@ -327,17 +414,18 @@ void vector <T> :: resize(size_t newElements)
          reserve(newElements);
 
       // now fill the new slots with the default T
-      for (size_t i = numElements; i < newElements; i++)
-         data[i] = T();
+      for (; numElements < newElements; numElements++)
+         Traits::construct(alloc, data + numElements);
    }
 
    // if we have made it this far, adjust the number of elements
+   destroy(newElements, numElements);
    numElements = newElements;
 
 }
 
-template <typename T>
-void vector <T> :: resize(size_t newElements, const T & t)
+template <typename T, typename A>
+void vector <T, A> :: resize(size_t newElements, const T & t)
 {
    assert(newElements >= 0);
 
@@ -349,24 +437,25 @@ void vector <T> :: resize(size_t newElements, const T & t)
        reserve(newElements);
 
     // now fill the new slots with the default T
-    for (size_t i = numElements; i < newElements; i++)
-       data[i] = t;
+    for (; numElements < newElements; numElements++)
+       Traits::construct(alloc, data + numElements, t);
    }
 
    // if we have made it this far, adjust the number of elements
+   destroy(newElements, numElements);
    numElements = newElements;
 }
 
 /***************************************
  * VECTOR :: RESERVE
  * This method will grow the current buffer
- * to newCapacity.  It will also copy all
+ * to newCapacity.  It will also move all
  * the data from the old buffer into the new
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: reserve(size_t newCapacity)
+template <typename T, typename A>
+void vector <T, A> :: reserve(size_t newCapacity)
 {
    // do nothing if we are already big enough
    if (newCapacity <= numCapacity)
@@ -374,15 +463,17 @@ void vector <T> :: reserve(size_t newCapacity)
    assert(newCapacity > 0 && newCapacity > numCapacity);
 
    // allocate the new array
-   T* pNew = new T[newCapacity];
+   T* pNew = Traits::allocate(alloc, newCapacity);
 
-   // copy over the data from the old array
+   // move over the data from the old array
    for (size_t i = 0; i < numElements; i++)
-      pNew[i] = std::move(data[i]);
+      Traits::construct(alloc, pNew + i, std::move(data[i]));
 
-   delete[] data;
+   size_t numKeep = numElements;
+   release();
 
    data = pNew;
+   numElements = numKeep;
    numCapacity = newCapacity;
 
 }
@@ -393,8 +484,8 @@ void vector <T> :: reserve(size_t newCapacity)
  *     INPUT  :
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: shrink_to_fit()
+template <typename T, typename A>
+void vector <T, A> :: shrink_to_fit()
 {
    // do nothing if we have no space
    if (numCapacity == numElements)
@@ -404,31 +495,31 @@ void vector <T> :: shrink_to_fit()
    T * pNew;
    if (numElements != 0)
    {
-      pNew = new T[numElements];
+      pNew = Traits::allocate(alloc, numElements);
       for (size_t i = 0; i < numElements; i++)
-         pNew[i] = data[i];
+         Traits::construct(alloc, pNew + i, std::move(data[i]));
    }
    else
       pNew = nullptr;
 
 
    // delete the old and assign the new
-   if (nullptr != data)
-   {
-      delete[] data;
-   }
+   size_t numKeep = numElements;
+   release();
    data = pNew;
-   numCapacity = numElements;
+   numElements = numKeep;
+   numCapacity = numKeep;
 }
 
 
 
+
 /*****************************************
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: operator [] (size_t index)
+template <typename T, typename A>
+T & vector <T, A> :: operator [] (size_t index)
 {
    // sanity check. Note that we do not do error-checking with []
    assert (index >= 0 && index < numElements);
@@ -440,8 +531,8 @@ T & vector <T> :: operator [] (size_t index)
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: operator [] (size_t index) const
+template <typename T, typename A>
+const T & vector <T, A> :: operator [] (size_t index) const
 {
    // sanity check
    assert (index >= 0 && index < numElements);
@@ -452,8 +543,8 @@ const T & vector <T> :: operator [] (size_t index) const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: front ()
+template <typename T, typename A>
+T & vector <T, A> :: front ()
 {
    // sanity check. Note that we do not do error-checking with front
    assert(numElements > 0);
@@ -464,8 +555,8 @@ T & vector <T> :: front ()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: front () const
+template <typename T, typename A>
+const T & vector <T, A> :: front () const
 {
    // sanity check
    assert(numElements > 0);
@@ -476,8 +567,8 @@ const T & vector <T> :: front () const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: back()
+template <typename T, typename A>
+T & vector <T, A> :: back()
 {
    // sanity check. Note that we do not do error-checking with back
    assert(numElements > 0);
@@ -488,8 +579,8 @@ T & vector <T> :: back()
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: back() const
+template <typename T, typename A>
+const T & vector <T, A> :: back() const
 {
    // sanity check
    assert(numElements > 0);
@@ -504,8 +595,8 @@ const T & vector <T> :: back() const
  *     INPUT  : 't' the new element to be added
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-void vector <T> :: push_back (const T & t)
+template <typename T, typename A>
+void vector <T, A> :: push_back (const T & t)
 {
    assert(numElements <= numCapacity);
 
@@ -517,11 +608,12 @@ void vector <T> :: push_back (const T & t)
    assert(numElements < numCapacity);
 
    // actually add on to the end of the list
-   data[numElements++] = t;
+   Traits::construct(alloc, data + numElements, t);
+   numElements++;
 }
 
-template <typename T>
-void vector <T> ::push_back(T && t)
+template <typename T, typename A>
+void vector <T, A> ::push_back(T && t)
 {
    assert(numElements <= numCapacity);
 
@@ -533,7 +625,8 @@ void vector <T> ::push_back(T && t)
    assert(numElements < numCapacity);
 
    // actually add on to the end of the list
-   data[numElements++] = std::move(t);
+   Traits::construct(alloc, data + numElements, std::move(t));
+   numElements++;
 }
 
 
@@ -544,9 +637,17 @@ void vector <T> ::push_back(T && t)
  *     INPUT  : rhs the vector to copy from
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-vector <T> & vector <T> :: operator = (const vector & rhs)
+template <typename T, typename A>
+vector <T, A> & vector <T, A> :: operator = (const vector & rhs)
 {
+   if (this == &rhs)
+      return *this;
+
+   // our buffer must go back to our allocator before we take rhs's
+   if (Traits::propagate_on_container_copy_assignment::value && !(alloc == rhs.alloc))
+      release();
+   copyAllocator(rhs, typename Traits::propagate_on_container_copy_assignment());
+
    // clear out the old data
    clear();
 
@@ -555,22 +656,53 @@ vector <T> & vector <T> :: operator = (const vector & rhs)
       reserve(rhs.size());
 
    // copy over the elements from the initialization list
-   for (size_t i = size_t(0); i < rhs.size(); i++)
-      data[i] = rhs.data[i];
-   numElements = rhs.numElements;
+   for (; numElements < rhs.size(); numElements++)
+      Traits::construct(alloc, data + numElements, rhs.data[numElements]);
 
    // return self
    return *this;
 }
-template <typename T>
-vector <T>& vector <T> :: operator = (vector&& rhs)
+
+/***************************************
+ * VECTOR :: MOVE ASSIGNMENT
+ * Move the elements of the rhs into our buffer,
+ * growing it as needed. Each side keeps its buffer
+ * for reuse. Only when we must take on an allocator
+ * unequal to ours do we take its buffer too, as ours
+ * cannot be freed by it
+ **************************************/
+template <typename T, typename A>
+vector <T, A>& vector <T, A> :: operator = (vector&& rhs)
 {
+   if (this == &rhs)
+      return *this;
+
+   if (Traits::propagate_on_container_move_assignment::value && !(alloc == rhs.alloc))
+   {
+      release();
+      moveAllocator(rhs, typename Traits::propagate_on_container_move_assignment());
+      std::swap(data, rhs.data);
+      std::swap(numElements, rhs.numElements);
+      std::swap(numCapacity, rhs.numCapacity);
+      return *this;
+   }
+
    clear();
-   shrink_to_fit();
-   swap(rhs);
+   if (rhs.size() > numCapacity)
+      reserve(rhs.size());
+   for (; numElements < rhs.size(); numElements++)
+      Traits::construct(alloc, data + numElements, std::move(rhs.data[numElements]));
+   rhs.clear();
    return *this;
 }
 
-
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+namespace pmr
+{
+   // a vector whose buffer comes from a std::pmr::memory_resource
+   template <typename T>
+   using vector = custom::vector<T, std::pmr::polymorphic_allocator<T>>;
+}
+#endif
 
 } // namespace custom